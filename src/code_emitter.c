@@ -0,0 +1,350 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/uio.h>
+
+#include "code_emitter.h"
+
+/// Maximal number of chunks passed to one writev call
+#define CODE_EMITTER_IOV_MAX 1024
+
+/// Two decimal digits of the numbers 00 to 99
+static const char codeEmitterDigitPairs[201] =
+		"00010203040506070809"
+		"10111213141516171819"
+		"20212223242526272829"
+		"30313233343536373839"
+		"40414243444546474849"
+		"50515253545556575859"
+		"60616263646566676869"
+		"70717273747576777879"
+		"80818283848586878889"
+		"90919293949596979899";
+
+/// Hexadecimal digits
+static const char codeEmitterHexDigits[16] = "0123456789abcdef";
+
+/**
+ * Returns pointer to the emitted byte on the position
+ * @param emitter Code emitter
+ * @param position Position of the byte
+ * @return Pointer to the byte
+ */
+static char* codeEmitterByte(const codeEmitter_t *emitter, size_t position) {
+	return emitter->chunks[position / CODE_EMITTER_CHUNK_SIZE] + position % CODE_EMITTER_CHUNK_SIZE;
+}
+
+/**
+ * Reverses the bytes in the range
+ * @param emitter Code emitter
+ * @param begin Position of the first byte
+ * @param end Position after the last byte
+ */
+static void codeEmitterReverse(codeEmitter_t *emitter, size_t begin, size_t end) {
+	while (begin + 1 < end) {
+		char *first = codeEmitterByte(emitter, begin++);
+		char *last = codeEmitterByte(emitter, --end);
+		char c = *first;
+		*first = *last;
+		*last = c;
+	}
+}
+
+/**
+ * Allocates the next chunk if the last one is full
+ * @param emitter Code emitter
+ * @return Execution status
+ */
+static bool codeEmitterReserveChunk(codeEmitter_t *emitter) {
+	if (emitter->size / CODE_EMITTER_CHUNK_SIZE < emitter->chunkCount) {
+		return true;
+	}
+	if (emitter->chunkCount == emitter->chunkCapacity) {
+		size_t capacity = emitter->chunkCapacity == 0 ? 8 : emitter->chunkCapacity * 2;
+		char **chunks = realloc(emitter->chunks, capacity * sizeof(char *));
+		if (chunks == NULL) {
+			return false;
+		}
+		emitter->chunks = chunks;
+		emitter->chunkCapacity = capacity;
+	}
+	char *chunk = malloc(CODE_EMITTER_CHUNK_SIZE);
+	if (chunk == NULL) {
+		return false;
+	}
+	emitter->chunks[emitter->chunkCount++] = chunk;
+	return true;
+}
+
+codeEmitter_t* codeEmitterInit() {
+	codeEmitter_t *emitter = malloc(sizeof(codeEmitter_t));
+	if (emitter == NULL) {
+		return NULL;
+	}
+	emitter->chunks = NULL;
+	emitter->chunkCount = 0;
+	emitter->chunkCapacity = 0;
+	emitter->size = 0;
+	return emitter;
+}
+
+void codeEmitterFree(codeEmitter_t *emitter) {
+	if (emitter == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < emitter->chunkCount; ++i) {
+		free(emitter->chunks[i]);
+	}
+	free(emitter->chunks);
+	free(emitter);
+}
+
+void codeEmitterClear(codeEmitter_t *emitter) {
+	if (emitter == NULL) {
+		return;
+	}
+	emitter->size = 0;
+}
+
+bool codeEmitterTruncate(codeEmitter_t *emitter, size_t position) {
+	if (emitter == NULL || position > emitter->size) {
+		return false;
+	}
+	emitter->size = position;
+	return true;
+}
+
+size_t codeEmitterSize(const codeEmitter_t *emitter) {
+	return emitter == NULL ? 0 : emitter->size;
+}
+
+char codeEmitterAt(const codeEmitter_t *emitter, size_t position) {
+	if (emitter == NULL || position >= emitter->size) {
+		return 0;
+	}
+	return *codeEmitterByte(emitter, position);
+}
+
+bool codeEmitterAppend(codeEmitter_t *emitter, const char *buffer, size_t length) {
+	if (emitter == NULL || (buffer == NULL && length != 0)) {
+		return false;
+	}
+	while (length != 0) {
+		if (!codeEmitterReserveChunk(emitter)) {
+			return false;
+		}
+		size_t offset = emitter->size % CODE_EMITTER_CHUNK_SIZE;
+		size_t count = CODE_EMITTER_CHUNK_SIZE - offset;
+		if (count > length) {
+			count = length;
+		}
+		memcpy(emitter->chunks[emitter->size / CODE_EMITTER_CHUNK_SIZE] + offset, buffer, count);
+		emitter->size += count;
+		buffer += count;
+		length -= count;
+	}
+	return true;
+}
+
+bool codeEmitterAppendChar(codeEmitter_t *emitter, char c) {
+	if (emitter == NULL || !codeEmitterReserveChunk(emitter)) {
+		return false;
+	}
+	*codeEmitterByte(emitter, emitter->size++) = c;
+	return true;
+}
+
+bool codeEmitterAppendString(codeEmitter_t *emitter, const char *string) {
+	if (string == NULL) {
+		return false;
+	}
+	return codeEmitterAppend(emitter, string, strlen(string));
+}
+
+bool codeEmitterAppendView(codeEmitter_t *emitter, strView_t view) {
+	if (strViewIsNull(view)) {
+		return false;
+	}
+	return codeEmitterAppend(emitter, view.string, view.length);
+}
+
+/**
+ * Returns pointer to the free space of the last chunk if there is room for the length
+ * @param emitter Code emitter
+ * @param length Required length
+ * @return Pointer to the free space or NULL
+ */
+static char* codeEmitterSpace(codeEmitter_t *emitter, size_t length) {
+	if (!codeEmitterReserveChunk(emitter)) {
+		return NULL;
+	}
+	if (CODE_EMITTER_CHUNK_SIZE - emitter->size % CODE_EMITTER_CHUNK_SIZE < length) {
+		return NULL;
+	}
+	return codeEmitterByte(emitter, emitter->size);
+}
+
+bool codeEmitterAppendNumber(codeEmitter_t *emitter, long number) {
+	if (emitter == NULL) {
+		return false;
+	}
+	// format directly to the chunk if it fits
+	char *space = codeEmitterSpace(emitter, CODE_EMITTER_NUMBER_LENGTH);
+	if (space != NULL) {
+		emitter->size += codeEmitterFormatNumber(space, number);
+		return true;
+	}
+	char buffer[CODE_EMITTER_NUMBER_LENGTH];
+	return codeEmitterAppend(emitter, buffer, codeEmitterFormatNumber(buffer, number));
+}
+
+bool codeEmitterAppendFloat(codeEmitter_t *emitter, double number) {
+	if (emitter == NULL) {
+		return false;
+	}
+	char *space = codeEmitterSpace(emitter, CODE_EMITTER_FLOAT_LENGTH);
+	if (space != NULL) {
+		emitter->size += codeEmitterFormatFloat(space, number);
+		return true;
+	}
+	char buffer[CODE_EMITTER_FLOAT_LENGTH];
+	return codeEmitterAppend(emitter, buffer, codeEmitterFormatFloat(buffer, number));
+}
+
+size_t codeEmitterFormatNumber(char *buffer, long number) {
+	// unsigned negation works for LONG_MIN too
+	unsigned long value = number < 0 ? 0UL - (unsigned long) number : (unsigned long) number;
+	char digits[CODE_EMITTER_NUMBER_LENGTH];
+	char *end = digits + CODE_EMITTER_NUMBER_LENGTH;
+	char *position = end;
+	// two digits at once from the end
+	while (value >= 100) {
+		unsigned pair = (unsigned) (value % 100) * 2;
+		value /= 100;
+		*--position = codeEmitterDigitPairs[pair + 1];
+		*--position = codeEmitterDigitPairs[pair];
+	}
+	if (value >= 10) {
+		unsigned pair = (unsigned) value * 2;
+		*--position = codeEmitterDigitPairs[pair + 1];
+		*--position = codeEmitterDigitPairs[pair];
+	} else {
+		*--position = (char) ('0' + value);
+	}
+	if (number < 0) {
+		*--position = '-';
+	}
+	size_t length = end - position;
+	memcpy(buffer, position, length);
+	return length;
+}
+
+size_t codeEmitterFormatFloat(char *buffer, double number) {
+	uint64_t bits;
+	memcpy(&bits, &number, sizeof(bits));
+	bool negative = bits >> 63;
+	int exponent = (int) ((bits >> 52) & 0x7FF);
+	uint64_t mantissa = bits & 0xFFFFFFFFFFFFFULL;
+	size_t length = 0;
+	if (negative) {
+		buffer[length++] = '-';
+	}
+	if (exponent == 0x7FF) {
+		memcpy(buffer + length, mantissa == 0 ? "inf" : "nan", 3);
+		return length + 3;
+	}
+	buffer[length++] = '0';
+	buffer[length++] = 'x';
+	if (exponent == 0 && mantissa == 0) {
+		memcpy(buffer + length, "0p+0", 4);
+		return length + 4;
+	}
+	// subnormal numbers are printed as 0x0.<mantissa>p-1022
+	buffer[length++] = exponent == 0 ? '0' : '1';
+	exponent = exponent == 0 ? -1022 : exponent - 1023;
+	if (mantissa != 0) {
+		buffer[length++] = '.';
+		// 52 bits of mantissa are 13 hexadecimal digits, trailing zeros are omitted
+		int shift = 48;
+		while (mantissa != 0) {
+			buffer[length++] = codeEmitterHexDigits[(mantissa >> shift) & 0xF];
+			mantissa &= (1ULL << shift) - 1;
+			shift -= 4;
+		}
+	}
+	buffer[length++] = 'p';
+	buffer[length++] = exponent < 0 ? '-' : '+';
+	return length + codeEmitterFormatNumber(buffer + length, exponent < 0 ? -exponent : exponent);
+}
+
+bool codeEmitterReverseLines(codeEmitter_t *emitter, size_t position) {
+	if (emitter == NULL || position > emitter->size) {
+		return false;
+	}
+	if (position == emitter->size) {
+		return true;
+	}
+	size_t end = emitter->size - 1;
+	if (*codeEmitterByte(emitter, end) != '\n') {
+		return false;
+	}
+	// reverse the lines without the last new line, then reverse each line back
+	codeEmitterReverse(emitter, position, end);
+	size_t begin = position;
+	for (size_t i = position; i <= end; ++i) {
+		if (i == end || *codeEmitterByte(emitter, i) == '\n') {
+			codeEmitterReverse(emitter, begin, i);
+			begin = i + 1;
+		}
+	}
+	return true;
+}
+
+bool codeEmitterWrite(const codeEmitter_t *emitter, int fd) {
+	if (emitter == NULL) {
+		return false;
+	}
+	size_t written = 0;
+	while (written < emitter->size) {
+		struct iovec iov[CODE_EMITTER_IOV_MAX];
+		int count = 0;
+		for (size_t position = written; position < emitter->size && count < CODE_EMITTER_IOV_MAX; ++count) {
+			size_t offset = position % CODE_EMITTER_CHUNK_SIZE;
+			size_t length = CODE_EMITTER_CHUNK_SIZE - offset;
+			if (length > emitter->size - position) {
+				length = emitter->size - position;
+			}
+			iov[count].iov_base = codeEmitterByte(emitter, position);
+			iov[count].iov_len = length;
+			position += length;
+		}
+		ssize_t result = writev(fd, iov, count);
+		if (result < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		written += result;
+	}
+	return true;
+}
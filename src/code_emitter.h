@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "string_view.h"
+
+/// Size of one code chunk
+#define CODE_EMITTER_CHUNK_SIZE 65536
+
+/// Maximal length of the formatted integer (-9223372036854775808)
+#define CODE_EMITTER_NUMBER_LENGTH 20
+
+/// Maximal length of the formatted hexadecimal float (-0x1.fffffffffffffp+1023)
+#define CODE_EMITTER_FLOAT_LENGTH 24
+
+/**
+ * Append-only buffer for the generated code, the code is stored in fixed-size chunks
+ * which are filled completely before the next one is allocated
+ */
+typedef struct code_emitter {
+	char **chunks; // array of the allocated chunks
+	size_t chunkCount; // number of the allocated chunks
+	size_t chunkCapacity; // capacity of the chunk array
+	size_t size; // number of the emitted bytes
+} codeEmitter_t;
+
+/**
+ * Initializes an empty code emitter
+ * @return Code emitter or NULL on allocation failure
+ */
+codeEmitter_t* codeEmitterInit();
+
+/**
+ * Frees the code emitter and all its chunks
+ * @param emitter Code emitter
+ */
+void codeEmitterFree(codeEmitter_t *emitter);
+
+/**
+ * Removes all the emitted code, the allocated chunks are kept for reuse
+ * @param emitter Code emitter
+ */
+void codeEmitterClear(codeEmitter_t *emitter);
+
+/**
+ * Removes the code emitted after the position
+ * @param emitter Code emitter
+ * @param position New size of the emitted code
+ * @return Execution status
+ */
+bool codeEmitterTruncate(codeEmitter_t *emitter, size_t position);
+
+/**
+ * Returns number of the emitted bytes, the value can be used as a position for the other functions
+ * @param emitter Code emitter
+ * @return Size of the emitted code
+ */
+size_t codeEmitterSize(const codeEmitter_t *emitter);
+
+/**
+ * Returns the emitted byte on the position
+ * @param emitter Code emitter
+ * @param position Position of the byte
+ * @return Emitted byte
+ */
+char codeEmitterAt(const codeEmitter_t *emitter, size_t position);
+
+/**
+ * Appends the buffer to the emitted code
+ * @param emitter Code emitter
+ * @param buffer Buffer to append
+ * @param length Buffer length
+ * @return Execution status
+ */
+bool codeEmitterAppend(codeEmitter_t *emitter, const char *buffer, size_t length);
+
+/**
+ * Appends the character to the emitted code
+ * @param emitter Code emitter
+ * @param c Character to append
+ * @return Execution status
+ */
+bool codeEmitterAppendChar(codeEmitter_t *emitter, char c);
+
+/**
+ * Appends the null-terminated string to the emitted code
+ * @param emitter Code emitter
+ * @param string String to append
+ * @return Execution status
+ */
+bool codeEmitterAppendString(codeEmitter_t *emitter, const char *string);
+
+/**
+ * Appends the viewed string to the emitted code
+ * @param emitter Code emitter
+ * @param view String view to append
+ * @return Execution status
+ */
+bool codeEmitterAppendView(codeEmitter_t *emitter, strView_t view);
+
+/**
+ * Appends the decimal representation of the number to the emitted code
+ * @param emitter Code emitter
+ * @param number Number to append
+ * @return Execution status
+ */
+bool codeEmitterAppendNumber(codeEmitter_t *emitter, long number);
+
+/**
+ * Appends the hexadecimal representation of the float (printf %a) to the emitted code
+ * @param emitter Code emitter
+ * @param number Float number to append
+ * @return Execution status
+ */
+bool codeEmitterAppendFloat(codeEmitter_t *emitter, double number);
+
+/**
+ * Formats the number in decimal, the output is not null-terminated
+ * @param buffer Output buffer of at least CODE_EMITTER_NUMBER_LENGTH characters
+ * @param number Number to format
+ * @return Length of the formatted number
+ */
+size_t codeEmitterFormatNumber(char *buffer, long number);
+
+/**
+ * Formats the float number same as printf %a does, the output is not null-terminated
+ * @param buffer Output buffer of at least CODE_EMITTER_FLOAT_LENGTH characters
+ * @param number Float number to format
+ * @return Length of the formatted number
+ */
+size_t codeEmitterFormatFloat(char *buffer, double number);
+
+/**
+ * Reverses order of the lines emitted since the position, the code after the position has to end with a new line
+ * @param emitter Code emitter
+ * @param position Position of the first line
+ * @return Execution status
+ */
+bool codeEmitterReverseLines(codeEmitter_t *emitter, size_t position);
+
+/**
+ * Writes the emitted code to the file descriptor, all the chunks are passed to a single writev call
+ * @param emitter Code emitter
+ * @param fd Output file descriptor
+ * @return Execution status
+ */
+bool codeEmitterWrite(const codeEmitter_t *emitter, int fd);
@@ -0,0 +1,774 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common_subexpression.h"
+
+/// unknown value, instruction which is not in the block
+#define CSE_NONE SIZE_MAX
+
+/// maximal number of the values numbered by one instruction (operands, result and popped unknown values)
+#define CSE_VALUES_PER_INSTRUCTION 6
+
+/**
+ * Numbered expression, operation of the numbered values or a constant
+ */
+typedef struct cse_expression {
+	irOpcode_t opcode; // three address opcode, IR_OPCODE_COUNT for the constant
+	irOperand_t constant;
+	size_t operands[2];
+	size_t value;
+} cseExpression_t;
+
+/**
+ * Value held by a variable
+ */
+typedef struct cse_variable {
+	irOperand_t variable;
+	size_t value;
+} cseVariable_t;
+
+/**
+ * Value on the data stack
+ */
+typedef struct cse_slot {
+	size_t value;
+	size_t begin; // first instruction of the computation, CSE_NONE if the value was pushed before the block
+} cseSlot_t;
+
+/**
+ * Passed type guard, conditional jump over the program exit, so the comparison result is known
+ */
+typedef struct cse_guard {
+	irOpcode_t opcode;
+	size_t operands[2];
+} cseGuard_t;
+
+/**
+ * Action taken on an instruction of the block
+ */
+typedef enum cse_action {
+	CSE_KEEP,
+	CSE_REMOVE, // the destination already holds the value or the guard was already passed
+	CSE_REUSE, // the stack computation is replaced by the push of the value
+} cseAction_t;
+
+/**
+ * Instruction of the block with its value numbering
+ */
+typedef struct cse_instruction {
+	cseAction_t action;
+	size_t value; // value pushed by the stack operation, CSE_NONE for other instructions
+	size_t begin; // first instruction of the stack computation
+	irOperand_t holder; // variable pushed instead of the reused computation
+	size_t first; // reused first computation kept in a temporary, CSE_NONE if the holder is pushed
+	size_t uses; // number of the reuses of the first computation
+	size_t saving; // number of the instructions saved by the reuses
+	bool cancelled; // the first computation is not kept, it doesn't pay off
+	irOperand_t temporary; // temporary keeping the first computation
+	size_t emitted; // position in the optimized stream
+} cseInstruction_t;
+
+/**
+ * Value numbering of the function blocks, the tables are sized for the longest block
+ */
+typedef struct cse_numbering {
+	cseExpression_t *expressions;
+	size_t expressionCount;
+	cseVariable_t *variables;
+	size_t variableCount;
+	cseSlot_t *stack;
+	size_t stackSize;
+	cseGuard_t *guards;
+	size_t guardCount;
+	size_t *firsts; // first stack computation of the value, CSE_NONE if it is not computed on the stack
+	size_t values; // number of the values
+	cseInstruction_t *instructions;
+} cseNumbering_t;
+
+/**
+ * Growing instruction stream
+ */
+typedef struct cse_stream {
+	irInstruction_t *instructions;
+	size_t size;
+	size_t capacity;
+} cseStream_t;
+
+/**
+ * Appends the instruction to the stream
+ * @param stream Instruction stream
+ * @param instruction Instruction
+ * @return Execution status
+ */
+static bool cseAppend(cseStream_t *stream, const irInstruction_t *instruction) {
+	if (stream->size == stream->capacity) {
+		size_t capacity = stream->capacity == 0 ? 64 : stream->capacity * 2;
+		irInstruction_t *instructions = realloc(stream->instructions, capacity * sizeof(irInstruction_t));
+		if (instructions == NULL) {
+			return false;
+		}
+		stream->instructions = instructions;
+		stream->capacity = capacity;
+	}
+	stream->instructions[stream->size++] = *instruction;
+	return true;
+}
+
+/**
+ * Returns the three address version of the stack operation
+ * @param opcode Stack instruction opcode
+ * @return Instruction opcode, IR_OPCODE_COUNT if the instruction is not a stack operation computing a value
+ */
+static irOpcode_t cseStackOpcode(irOpcode_t opcode) {
+	switch (opcode) {
+		case IR_ADDS:
+			return IR_ADD;
+		case IR_SUBS:
+			return IR_SUB;
+		case IR_MULS:
+			return IR_MUL;
+		case IR_DIVS:
+			return IR_DIV;
+		case IR_IDIVS:
+			return IR_IDIV;
+		case IR_LTS:
+			return IR_LT;
+		case IR_GTS:
+			return IR_GT;
+		case IR_EQS:
+			return IR_EQ;
+		case IR_ANDS:
+			return IR_AND;
+		case IR_ORS:
+			return IR_OR;
+		case IR_NOTS:
+			return IR_NOT;
+		case IR_INT2FLOATS:
+			return IR_INT2FLOAT;
+		case IR_FLOAT2INTS:
+			return IR_FLOAT2INT;
+		case IR_INT2CHARS:
+			return IR_INT2CHAR;
+		case IR_STRI2INTS:
+			return IR_STRI2INT;
+		default:
+			return IR_OPCODE_COUNT;
+	}
+}
+
+/**
+ * Checks if the three address instruction computes its destination only from its operands
+ * @param opcode Instruction opcode
+ * @return Is the instruction a pure operation?
+ */
+static bool cseIsOperation(irOpcode_t opcode) {
+	switch (opcode) {
+		case IR_ADD:
+		case IR_SUB:
+		case IR_MUL:
+		case IR_DIV:
+		case IR_IDIV:
+		case IR_LT:
+		case IR_GT:
+		case IR_EQ:
+		case IR_AND:
+		case IR_OR:
+		case IR_NOT:
+		case IR_INT2FLOAT:
+		case IR_FLOAT2INT:
+		case IR_INT2CHAR:
+		case IR_STRI2INT:
+		case IR_CONCAT:
+		case IR_STRLEN:
+		case IR_GETCHAR:
+		case IR_TYPE:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/**
+ * Checks if the operands of the operation can be swapped
+ * @param opcode Three address opcode
+ * @return Is the operation commutative?
+ */
+static bool cseIsCommutative(irOpcode_t opcode) {
+	return opcode == IR_ADD || opcode == IR_MUL || opcode == IR_EQ || opcode == IR_AND || opcode == IR_OR
+		|| opcode == IR_JUMPIFEQ || opcode == IR_JUMPIFNEQ;
+}
+
+/**
+ * Counts the jumps to the label
+ * @param stream Instructions of the function
+ * @param size Number of instructions
+ * @param label Label operand
+ * @return Number of the jumps
+ */
+static size_t cseLabelReferences(const irInstruction_t *stream, size_t size, const irOperand_t *label) {
+	size_t references = 0;
+	for (size_t i = 0; i < size; ++i) {
+		irOpcode_t opcode = stream[i].opcode;
+		if ((opcode == IR_JUMP || opcode == IR_JUMPIFEQ || opcode == IR_JUMPIFNEQ || opcode == IR_JUMPIFEQS
+			|| opcode == IR_JUMPIFNEQS) && irOperandEqual(&stream[i].operands[0], label)) {
+			references++;
+		}
+	}
+	return references;
+}
+
+/**
+ * Checks if the label ends a type guard, the conditional jump over the program exit is its only jump,
+ * so the code after it continues the block of the jump
+ * @param stream Instructions of the function
+ * @param size Number of instructions
+ * @param index Index of the instruction
+ * @return Is the instruction a label of the guard?
+ */
+static bool cseIsGuardLabel(const irInstruction_t *stream, size_t size, size_t index) {
+	if (index < 2 || index >= size || stream[index].opcode != IR_LABEL || stream[index - 1].opcode != IR_EXIT) {
+		return false;
+	}
+	const irInstruction_t *jump = &stream[index - 2];
+	return (jump->opcode == IR_JUMPIFEQ || jump->opcode == IR_JUMPIFNEQ || jump->opcode == IR_JUMPIFEQS
+		|| jump->opcode == IR_JUMPIFNEQS) && irOperandEqual(&jump->operands[0], &stream[index].operands[0])
+		&& cseLabelReferences(stream, size, &stream[index].operands[0]) == 1;
+}
+
+/**
+ * Checks if the block ends after the instruction, the numbering is not kept over labels (except the guards),
+ * calls, which can change the global variables, and the frame changes
+ * @param stream Instructions of the function
+ * @param size Number of instructions
+ * @param index Index of the instruction
+ * @return Does the block end?
+ */
+static bool cseEndsBlock(const irInstruction_t *stream, size_t size, size_t index) {
+	switch (stream[index].opcode) {
+		case IR_CALL:
+		case IR_JUMP:
+		case IR_RETURN:
+		case IR_CLEARS:
+		case IR_CREATEFRAME:
+		case IR_PUSHFRAME:
+		case IR_POPFRAME:
+			return true;
+		case IR_EXIT:
+			return !cseIsGuardLabel(stream, size, index + 1);
+		default:
+			return index + 1 < size && stream[index + 1].opcode == IR_LABEL
+				&& !cseIsGuardLabel(stream, size, index + 1);
+	}
+}
+
+/**
+ * Returns a new value
+ * @param numbering Value numbering
+ * @return Value
+ */
+static size_t cseNewValue(cseNumbering_t *numbering) {
+	numbering->firsts[numbering->values] = CSE_NONE;
+	return numbering->values++;
+}
+
+/**
+ * Returns the value of the operand, a variable read before its assignment in the block holds a new value
+ * @param numbering Value numbering
+ * @param operand Variable or constant operand
+ * @return Value
+ */
+static size_t cseOperandValue(cseNumbering_t *numbering, const irOperand_t *operand) {
+	if (operand->type == IR_OPERAND_VARIABLE) {
+		for (size_t i = 0; i < numbering->variableCount; ++i) {
+			if (irOperandEqual(&numbering->variables[i].variable, operand)) {
+				return numbering->variables[i].value;
+			}
+		}
+		cseVariable_t *variable = &numbering->variables[numbering->variableCount++];
+		variable->variable = *operand;
+		variable->value = cseNewValue(numbering);
+		return variable->value;
+	}
+	for (size_t i = 0; i < numbering->expressionCount; ++i) {
+		cseExpression_t *expression = &numbering->expressions[i];
+		if (expression->opcode == IR_OPCODE_COUNT && irOperandEqual(&expression->constant, operand)) {
+			return expression->value;
+		}
+	}
+	cseExpression_t *expression = &numbering->expressions[numbering->expressionCount++];
+	expression->opcode = IR_OPCODE_COUNT;
+	expression->constant = *operand;
+	expression->value = cseNewValue(numbering);
+	return expression->value;
+}
+
+/**
+ * Returns the value of the operation
+ * @param numbering Value numbering
+ * @param opcode Three address opcode
+ * @param operands Values of the operands
+ * @param count Number of the operands (1 or 2)
+ * @return Value
+ */
+static size_t cseOperationValue(cseNumbering_t *numbering, irOpcode_t opcode, const size_t *operands, size_t count) {
+	size_t key[2] = {operands[0], count == 2 ? operands[1] : CSE_NONE};
+	if (count == 2 && cseIsCommutative(opcode) && key[0] > key[1]) {
+		key[0] = operands[1];
+		key[1] = operands[0];
+	}
+	for (size_t i = 0; i < numbering->expressionCount; ++i) {
+		cseExpression_t *expression = &numbering->expressions[i];
+		if (expression->opcode == opcode && expression->operands[0] == key[0] && expression->operands[1] == key[1]) {
+			return expression->value;
+		}
+	}
+	cseExpression_t *expression = &numbering->expressions[numbering->expressionCount++];
+	expression->opcode = opcode;
+	expression->operands[0] = key[0];
+	expression->operands[1] = key[1];
+	expression->value = cseNewValue(numbering);
+	return expression->value;
+}
+
+/**
+ * Assigns the value to the variable
+ * @param numbering Value numbering
+ * @param operand Variable operand
+ * @param value Value
+ */
+static void cseAssign(cseNumbering_t *numbering, const irOperand_t *operand, size_t value) {
+	for (size_t i = 0; i < numbering->variableCount; ++i) {
+		if (irOperandEqual(&numbering->variables[i].variable, operand)) {
+			numbering->variables[i].value = value;
+			return;
+		}
+	}
+	cseVariable_t *variable = &numbering->variables[numbering->variableCount++];
+	variable->variable = *operand;
+	variable->value = value;
+}
+
+/**
+ * Finds a variable holding the value
+ * @param numbering Value numbering
+ * @param value Value
+ * @return Variable or NULL if no variable holds the value
+ */
+static const irOperand_t* cseHolder(const cseNumbering_t *numbering, size_t value) {
+	for (size_t i = 0; i < numbering->variableCount; ++i) {
+		if (numbering->variables[i].value == value) {
+			return &numbering->variables[i].variable;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Checks if the guard was already passed, otherwise records it
+ * @param numbering Value numbering
+ * @param jump Conditional jump of the guard
+ * @return Was the guard passed?
+ */
+static bool cseGuardPassed(cseNumbering_t *numbering, const irInstruction_t *jump) {
+	cseGuard_t guard = {.opcode = jump->opcode};
+	for (unsigned i = 0; i < 2; ++i) {
+		guard.operands[i] = cseOperandValue(numbering, &jump->operands[i + 1]);
+	}
+	if (guard.operands[0] > guard.operands[1]) {
+		size_t operand = guard.operands[0];
+		guard.operands[0] = guard.operands[1];
+		guard.operands[1] = operand;
+	}
+	for (size_t i = 0; i < numbering->guardCount; ++i) {
+		const cseGuard_t *passed = &numbering->guards[i];
+		if (passed->opcode == guard.opcode && passed->operands[0] == guard.operands[0]
+			&& passed->operands[1] == guard.operands[1]) {
+			return true;
+		}
+	}
+	numbering->guards[numbering->guardCount++] = guard;
+	return false;
+}
+
+/**
+ * Pops the value from the data stack
+ * @param numbering Value numbering
+ * @return Value slot, the value pushed before the block is a new value
+ */
+static cseSlot_t csePop(cseNumbering_t *numbering) {
+	if (numbering->stackSize == 0) {
+		cseSlot_t slot = {.value = cseNewValue(numbering), .begin = CSE_NONE};
+		return slot;
+	}
+	return numbering->stack[--numbering->stackSize];
+}
+
+/**
+ * Cancels the reuses and first computations inside the stack computation replaced by a reuse
+ * @param numbering Value numbering
+ * @param begin First instruction of the replaced computation
+ * @param end Reusing instruction
+ */
+static void cseCancelInner(cseNumbering_t *numbering, size_t begin, size_t end) {
+	for (size_t i = begin; i < end; ++i) {
+		cseInstruction_t *instruction = &numbering->instructions[i];
+		if (instruction->action == CSE_REUSE && instruction->first != CSE_NONE) {
+			cseInstruction_t *first = &numbering->instructions[instruction->first];
+			first->uses--;
+			first->saving -= i - instruction->begin;
+		}
+		instruction->action = CSE_KEEP;
+		if (instruction->value != CSE_NONE && numbering->firsts[instruction->value] == i) {
+			numbering->firsts[instruction->value] = CSE_NONE;
+		}
+	}
+}
+
+/**
+ * Numbers the stack operation and decides if the computation is replaced by the push of an earlier value
+ * @param numbering Value numbering
+ * @param index Index of the instruction in the block
+ * @param opcode Three address version of the stack operation
+ * @param pure First instruction of the sequence of pushes and stack operations ending at the instruction
+ */
+static void cseNumberStackOperation(cseNumbering_t *numbering, size_t index, irOpcode_t opcode, size_t pure) {
+	size_t count = irOpcodeOperands(opcode) - 1;
+	cseSlot_t slots[2];
+	size_t operands[2];
+	for (size_t i = count; i-- > 0;) {
+		slots[i] = csePop(numbering);
+		operands[i] = slots[i].value;
+	}
+	cseInstruction_t *instruction = &numbering->instructions[index];
+	instruction->value = cseOperationValue(numbering, opcode, operands, count);
+	instruction->begin = slots[0].begin;
+	for (size_t i = 0; i < count; ++i) {
+		if (slots[i].begin == CSE_NONE) {
+			instruction->begin = CSE_NONE;
+		}
+	}
+	cseSlot_t slot = {.value = instruction->value, .begin = instruction->begin};
+	numbering->stack[numbering->stackSize++] = slot;
+
+	// the replaced computation must not have other effects than pushing the value
+	if (instruction->begin == CSE_NONE || instruction->begin < pure) {
+		if (numbering->firsts[instruction->value] == CSE_NONE) {
+			numbering->firsts[instruction->value] = index;
+		}
+		return;
+	}
+	const irOperand_t *holder = cseHolder(numbering, instruction->value);
+	size_t first = numbering->firsts[instruction->value];
+	if (holder == NULL && first == CSE_NONE) {
+		numbering->firsts[instruction->value] = index;
+		return;
+	}
+	cseCancelInner(numbering, instruction->begin, index);
+	instruction->action = CSE_REUSE;
+	if (holder != NULL) {
+		instruction->holder = *holder;
+		instruction->first = CSE_NONE;
+		return;
+	}
+	instruction->first = first;
+	numbering->instructions[first].uses++;
+	numbering->instructions[first].saving += index - instruction->begin;
+}
+
+/**
+ * Numbers the values of the block instructions and decides the actions
+ * @param numbering Value numbering
+ * @param stream Instructions of the function
+ * @param streamSize Number of the function instructions
+ * @param begin Index of the first instruction of the block
+ * @param size Number of the block instructions
+ */
+static void cseNumberBlock(cseNumbering_t *numbering, const irInstruction_t *stream, size_t streamSize, size_t begin,
+		size_t size) {
+	const irInstruction_t *block = stream + begin;
+	numbering->expressionCount = 0;
+	numbering->variableCount = 0;
+	numbering->stackSize = 0;
+	numbering->guardCount = 0;
+	numbering->values = 0;
+	size_t pure = 0;
+	for (size_t i = 0; i < size; ++i) {
+		cseInstruction_t empty = {.action = CSE_KEEP, .value = CSE_NONE, .begin = CSE_NONE, .first = CSE_NONE};
+		numbering->instructions[i] = empty;
+	}
+	for (size_t i = 0; i < size; ++i) {
+		const irInstruction_t *instruction = &block[i];
+		irOpcode_t opcode = instruction->opcode;
+		irOpcode_t stackOpcode = cseStackOpcode(opcode);
+		if (opcode == IR_PUSHS) {
+			cseSlot_t slot = {.value = cseOperandValue(numbering, &instruction->operands[0]), .begin = i};
+			numbering->stack[numbering->stackSize++] = slot;
+			continue;
+		}
+		if (stackOpcode != IR_OPCODE_COUNT) {
+			cseNumberStackOperation(numbering, i, stackOpcode, pure);
+			continue;
+		}
+		// instructions with other effects than pushing a value split the stack computations
+		pure = i + 1;
+		if (opcode == IR_MOVE || cseIsOperation(opcode)) {
+			size_t value;
+			if (opcode == IR_MOVE) {
+				value = cseOperandValue(numbering, &instruction->operands[1]);
+			} else {
+				size_t count = irOpcodeOperands(opcode) - 1;
+				size_t operands[2];
+				for (size_t j = 0; j < count; ++j) {
+					operands[j] = cseOperandValue(numbering, &instruction->operands[j + 1]);
+				}
+				value = cseOperationValue(numbering, opcode, operands, count);
+			}
+			if (cseOperandValue(numbering, &instruction->operands[0]) == value) {
+				numbering->instructions[i].action = CSE_REMOVE;
+			} else {
+				cseAssign(numbering, &instruction->operands[0], value);
+			}
+			continue;
+		}
+		switch (opcode) {
+			case IR_POPS:
+				cseAssign(numbering, &instruction->operands[0], csePop(numbering).value);
+				break;
+			case IR_DEFVAR:
+			case IR_READ:
+			case IR_SETCHAR:
+				cseAssign(numbering, &instruction->operands[0], cseNewValue(numbering));
+				break;
+			case IR_JUMPIFEQS:
+			case IR_JUMPIFNEQS:
+				csePop(numbering);
+				csePop(numbering);
+				break;
+			case IR_JUMPIFEQ:
+			case IR_JUMPIFNEQ:
+				// the guard passed again is removed with its exit and label
+				if (i + 2 < size && cseIsGuardLabel(stream, streamSize, begin + i + 2)
+					&& cseGuardPassed(numbering, instruction)) {
+					for (size_t j = i; j < i + 3; ++j) {
+						numbering->instructions[j].action = CSE_REMOVE;
+					}
+					i += 2;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * Keeps the first computation of the reused value in a temporary, the operation of the pushed operands
+ * stores the value directly, otherwise the value is popped to the temporary and pushed back
+ * @param program Program owning the name of the temporary
+ * @param numbering Value numbering
+ * @param index Index of the stack operation in the block, it is the last instruction of the output
+ * @param output Optimized stream
+ * @param stats Statistics to update
+ * @param temporaries Number of the temporaries used by the block
+ * @return Execution status
+ */
+static bool cseKeep(irProgram_t *program, cseNumbering_t *numbering, size_t index, cseStream_t *output,
+		cseStats_t *stats, size_t *temporaries) {
+	cseInstruction_t *instruction = &numbering->instructions[index];
+	irOpcode_t opcode = cseStackOpcode(output->instructions[output->size - 1].opcode);
+	size_t count = irOpcodeOperands(opcode) - 1;
+	size_t begin = instruction->begin == CSE_NONE ? CSE_NONE : numbering->instructions[instruction->begin].emitted;
+	bool direct = begin != CSE_NONE && output->size - begin == count + 1;
+	for (size_t i = 0; direct && i < count; ++i) {
+		direct = output->instructions[begin + i].opcode == IR_PUSHS;
+	}
+	// binary operation saves a push, unary operation keeps the size, pop and push are added otherwise
+	long cost = direct ? 1 - (long) count : 2;
+	if ((long) instruction->saving <= cost) {
+		instruction->cancelled = true;
+		return true;
+	}
+
+	char name[32];
+	sprintf(name, "$$cse%zu", (*temporaries)++);
+	strView_t temporaryName = irProgramAddName(program, name);
+	if (strViewIsNull(temporaryName)) {
+		return false;
+	}
+	instruction->temporary = irVariable(FRAME_GLOBAL, temporaryName);
+	irInstruction_t push = {.opcode = IR_PUSHS, .operands = {instruction->temporary}};
+	if (direct) {
+		irInstruction_t operation = {.opcode = opcode, .operands = {instruction->temporary}};
+		for (size_t i = 0; i < count; ++i) {
+			operation.operands[i + 1] = output->instructions[begin + i].operands[0];
+		}
+		output->size = begin;
+		stats->removed += count - 1;
+		return cseAppend(output, &operation) && cseAppend(output, &push);
+	}
+	irInstruction_t pop = {.opcode = IR_POPS, .operands = {instruction->temporary}};
+	stats->added += 2;
+	return cseAppend(output, &pop) && cseAppend(output, &push);
+}
+
+/**
+ * Rewrites the block by the decided actions
+ * @param program Program owning the names of the temporaries
+ * @param numbering Value numbering of the block
+ * @param block Instructions of the block
+ * @param size Number of the block instructions
+ * @param output Optimized stream
+ * @param stats Statistics to update
+ * @return Execution status
+ */
+static bool cseRewriteBlock(irProgram_t *program, cseNumbering_t *numbering, const irInstruction_t *block,
+		size_t size, cseStream_t *output, cseStats_t *stats) {
+	size_t temporaries = 0;
+	for (size_t i = 0; i < size; ++i) {
+		cseInstruction_t *instruction = &numbering->instructions[i];
+		instruction->emitted = output->size;
+		if (instruction->action == CSE_REMOVE) {
+			stats->redundant++;
+			stats->removed++;
+			continue;
+		}
+		if (instruction->action == CSE_REUSE
+			&& (instruction->first == CSE_NONE || !numbering->instructions[instruction->first].cancelled)) {
+			// the pushes and operations of the computation are replaced by one push
+			size_t begin = numbering->instructions[instruction->begin].emitted;
+			irInstruction_t push = {.opcode = IR_PUSHS, .operands = {instruction->first == CSE_NONE
+				? instruction->holder : numbering->instructions[instruction->first].temporary}};
+			stats->reused++;
+			stats->removed += output->size - begin;
+			output->size = begin;
+			if (!cseAppend(output, &push)) {
+				return false;
+			}
+			continue;
+		}
+		if (!cseAppend(output, &block[i])) {
+			return false;
+		}
+		if (instruction->uses > 0 && !cseKeep(program, numbering, i, output, stats, &temporaries)) {
+			return false;
+		}
+	}
+	if (temporaries > stats->temporaries) {
+		stats->temporaries = temporaries;
+	}
+	return true;
+}
+
+bool cseEliminateFunction(irProgram_t *program, irFunction_t *function, cseStats_t *stats) {
+	if (program == NULL || function == NULL || stats == NULL) {
+		return false;
+	}
+	// preformatted code is not optimized
+	if (!strViewIsNull(function->code)) {
+		return true;
+	}
+	size_t size = 0;
+	for (const irBlock_t *block = function->first; block != NULL; block = block->next) {
+		size += block->count;
+	}
+	if (size == 0) {
+		return true;
+	}
+	irInstruction_t *stream = malloc(size * sizeof(irInstruction_t));
+	// tables of the numbering are sized for the whole function
+	cseNumbering_t numbering = {
+		.expressions = malloc(size * 3 * sizeof(cseExpression_t)),
+		.variables = malloc(size * 3 * sizeof(cseVariable_t)),
+		.stack = malloc(size * sizeof(cseSlot_t)),
+		.guards = malloc(size * sizeof(cseGuard_t)),
+		.firsts = malloc(size * CSE_VALUES_PER_INSTRUCTION * sizeof(size_t)),
+		.instructions = malloc(size * sizeof(cseInstruction_t)),
+	};
+	cseStream_t output = {.instructions = NULL, .size = 0, .capacity = 0};
+	bool success = stream != NULL && numbering.expressions != NULL && numbering.variables != NULL
+		&& numbering.stack != NULL && numbering.guards != NULL && numbering.firsts != NULL
+		&& numbering.instructions != NULL;
+	if (success) {
+		size_t count = 0;
+		for (const irBlock_t *block = function->first; block != NULL; block = block->next) {
+			memcpy(stream + count, block->instructions, block->count * sizeof(irInstruction_t));
+			count += block->count;
+		}
+	}
+	size_t begin = 0;
+	for (size_t i = 0; success && i < size; ++i) {
+		if (i + 1 < size && !cseEndsBlock(stream, size, i)) {
+			continue;
+		}
+		cseNumberBlock(&numbering, stream, size, begin, i + 1 - begin);
+		success = cseRewriteBlock(program, &numbering, stream + begin, i + 1 - begin, &output, stats);
+		begin = i + 1;
+	}
+	// rebuild the basic blocks
+	irPosition_t start = {.block = NULL, .index = 0};
+	success = success && irFunctionTruncate(function, start);
+	for (size_t i = 0; success && i < output.size; ++i) {
+		success = irEmitInstruction(function, &output.instructions[i]);
+	}
+	free(stream);
+	free(numbering.expressions);
+	free(numbering.variables);
+	free(numbering.stack);
+	free(numbering.guards);
+	free(numbering.firsts);
+	free(numbering.instructions);
+	free(output.instructions);
+	return success;
+}
+
+bool cseEliminate(irProgram_t *program, cseStats_t *stats) {
+	if (program == NULL || program->main == NULL) {
+		return false;
+	}
+	cseStats_t programStats = {.reused = 0, .redundant = 0, .removed = 0, .added = 0, .temporaries = 0};
+	if (stats == NULL) {
+		stats = &programStats;
+	}
+	for (irFunction_t *function = program->first; function != NULL; function = function->next) {
+		if (!cseEliminateFunction(program, function, stats)) {
+			return false;
+		}
+	}
+	// temporaries are global, the values are not kept over calls
+	for (size_t i = stats->temporaries; i-- > 0;) {
+		char name[32];
+		sprintf(name, "$$cse%zu", i);
+		strView_t temporaryName = irProgramAddName(program, name);
+		irInstruction_t definition = {.opcode = IR_DEFVAR, .operands = {irVariable(FRAME_GLOBAL, temporaryName)}};
+		if (strViewIsNull(temporaryName) || !irFunctionPrepend(program->main, &definition)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void csePrintStats(FILE *file, const cseStats_t *stats) {
+	fprintf(file, "cse: %zu values reused, %zu redundant instructions, %zu temporaries\n", stats->reused,
+		stats->redundant, stats->temporaries);
+	fprintf(file, "cse: %zu instructions removed, %zu added\n", stats->removed, stats->added);
+}
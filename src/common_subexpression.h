@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include "intermediate_code.h"
+
+/**
+ * Common subexpression elimination statistics
+ */
+typedef struct cse_stats {
+	size_t reused; // number of the recomputed values replaced by the earlier computation
+	size_t redundant; // number of the removed instructions computing the value the destination already holds
+	size_t removed; // number of the removed instructions
+	size_t added; // number of the instructions added to keep the values in the temporaries
+	size_t temporaries; // number of the temporary variables
+} cseStats_t;
+
+/**
+ * Eliminates common subexpressions of the function by the local value numbering,
+ * the values are numbered in the straight-line code between the labels, calls and frame changes
+ * (conditional jumps and the type guards exiting the program keep the numbering),
+ * a recomputed value is pushed from the variable holding it or from the temporary variable
+ * keeping its first computation on the data stack
+ * @param program Program owning the names of the temporary variables
+ * @param function Function to optimize
+ * @param stats Statistics to update, the temporaries are counted for all the functions
+ * @return Execution status
+ */
+bool cseEliminateFunction(irProgram_t *program, irFunction_t *function, cseStats_t *stats);
+
+/**
+ * Eliminates common subexpressions of all the program functions,
+ * the temporary variables are defined in the main function prologue
+ * @param program Program to optimize
+ * @param stats Statistics to update, can be NULL
+ * @return Execution status
+ */
+bool cseEliminate(irProgram_t *program, cseStats_t *stats);
+
+/**
+ * Prints the statistics report
+ * @param file Output file
+ * @param stats Statistics
+ */
+void csePrintStats(FILE *file, const cseStats_t *stats);
@@ -0,0 +1,416 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "constant_propagation.h"
+#include "semantic_analysis.h"
+
+void constEnvironmentInit(constEnvironment_t* environment) {
+	environment->symbols = NULL;
+	environment->values = NULL;
+	environment->size = 0;
+	environment->capacity = 0;
+}
+
+void constEnvironmentFree(constEnvironment_t* environment) {
+	free(environment->symbols);
+	free(environment->values);
+	constEnvironmentInit(environment);
+}
+
+/**
+ * Copies the environment
+ * @param destination initialized environment to copy to
+ * @param source environment to copy
+ * @return execution status
+ */
+static bool constEnvironmentCopy(constEnvironment_t* destination, const constEnvironment_t* source) {
+	for(size_t i = 0; i < source->size; i++) {
+		if(!constEnvironmentSet(destination, source->symbols[i], source->values[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+token_t* constEnvironmentGet(const constEnvironment_t* environment, const symbol_t* symbol) {
+	for(size_t i = 0; i < environment->size; i++) {
+		if(environment->symbols[i] == symbol) {
+			return environment->values[i];
+		}
+	}
+	return NULL;
+}
+
+bool constEnvironmentSet(constEnvironment_t* environment, symbol_t* symbol, token_t* value) {
+	for(size_t i = 0; i < environment->size; i++) {
+		if(environment->symbols[i] == symbol) {
+			environment->values[i] = value;
+			return true;
+		}
+	}
+	// unknown is the default value
+	if(value == NULL) {
+		return true;
+	}
+	if(environment->size == environment->capacity) {
+		size_t capacity = (environment->capacity == 0)? 16 : environment->capacity * 2;
+		symbol_t** symbols = realloc(environment->symbols, capacity * sizeof(symbol_t*));
+		if(symbols == NULL) {
+			return false;
+		}
+		environment->symbols = symbols;
+		token_t** values = realloc(environment->values, capacity * sizeof(token_t*));
+		if(values == NULL) {
+			return false;
+		}
+		environment->values = values;
+		environment->capacity = capacity;
+	}
+	environment->symbols[environment->size] = symbol;
+	environment->values[environment->size] = value;
+	environment->size++;
+	return true;
+}
+
+/**
+ * Compares literal tokens
+ * @param token1 first literal
+ * @param token2 second literal
+ * @return are the literals same?
+ */
+static bool constTokenEqual(const token_t* token1, const token_t* token2) {
+	if(token1 == NULL || token2 == NULL || token1->type != token2->type) {
+		return false;
+	}
+	switch(token1->type) {
+		case T_NUMBER:
+			return token1->data.intval == token2->data.intval;
+		case T_FLOAT:
+			return memcmp(&token1->data.floatval, &token2->data.floatval, sizeof(double)) == 0;
+		case T_STRING:
+		case T_STRING_ML:
+			return token1->data.strval->size == token2->data.strval->size
+				&& memcmp(token1->data.strval->string, token2->data.strval->string, token1->data.strval->size) == 0;
+		default:
+			return true;
+	}
+}
+
+/**
+ * Keeps only the values which are same in both environments (join of the control flow)
+ * @param environment environment to update
+ * @param other environment of the other path
+ */
+static void constEnvironmentMerge(constEnvironment_t* environment, const constEnvironment_t* other) {
+	for(size_t i = 0; i < environment->size; i++) {
+		if(!constTokenEqual(environment->values[i], constEnvironmentGet(other, environment->symbols[i]))) {
+			environment->values[i] = NULL;
+		}
+	}
+}
+
+/**
+ * Forgets values of all the variables assigned in the element
+ * @param environment environment
+ * @param element tree element
+ */
+static void constEnvironmentKill(constEnvironment_t* environment, treeElement_t* element) {
+	if(element->type == E_TOKEN) {
+		return;
+	}
+	if(element->type == E_ASSIGN && element->data.elements[0].symbol != NULL) {
+		constEnvironmentSet(environment, element->data.elements[0].symbol, NULL);
+	}
+	for(unsigned int i = 0; i < element->nodeSize; i++) {
+		constEnvironmentKill(environment, &element->data.elements[i]);
+	}
+}
+
+/**
+ * Checks if the literal condition is true, same as the generated condition code
+ * @param token literal token
+ * @return is the condition true?
+ */
+static bool constIsTrue(const token_t* token) {
+	switch(token->type) {
+		case T_NUMBER:
+			return token->data.intval != 0;
+		case T_FLOAT:
+			return token->data.floatval != 0.0;
+		case T_STRING:
+		case T_STRING_ML:
+			return token->data.strval->size != 0;
+		case T_BOOL_TRUE:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/**
+ * Hands the identifier names viewed by symbols over to the symbols, so that the element can be freed
+ * @param element element to be freed
+ */
+static void constReleaseNames(treeElement_t* element) {
+	if(element->type == E_TOKEN) {
+		token_t* token = element->data.token;
+		if(token->type == T_ID && element->symbol != NULL && token->data.strval != NULL
+				&& symbolTakeName(element->symbol, token->data.strval)) {
+			token->data.strval = NULL;
+		}
+		return;
+	}
+	for(unsigned int i = 0; i < element->nodeSize; i++) {
+		constReleaseNames(&element->data.elements[i]);
+	}
+}
+
+/**
+ * Replaces identifier element by copy of the literal
+ * @param element identifier element
+ * @param value literal token
+ * @param errCode error code
+ */
+static void constReplaceIdentifier(treeElement_t* element, const token_t* value, int* errCode) {
+	token_t token = *value;
+	if(value->type == T_STRING || value->type == T_STRING_ML) {
+		token.data.strval = dynStrClone(value->data.strval);
+		token.operand = dynStrClone(value->operand);
+		if(token.data.strval == NULL || token.operand == NULL) {
+			dynStrFree(token.data.strval);
+			dynStrFree(token.operand);
+			*errCode = ERROR_INTERNAL;
+			return;
+		}
+	}
+	constReleaseNames(element);
+	treeFree(*element);
+	initTokenTreeElement(element, token);
+}
+
+/**
+ * Substitutes known values of variables into the expression
+ * @param element expression element
+ * @param environment environment
+ * @param errCode error code
+ */
+static void constSubstitute(treeElement_t* element, constEnvironment_t* environment, int* errCode) {
+	switch(element->type) {
+		case E_TOKEN:
+			if(element->data.token->type == T_ID && element->symbol != NULL
+					&& element->symbol->type == SYMBOL_VARIABLE) {
+				token_t* value = constEnvironmentGet(environment, element->symbol);
+				if(value != NULL) {
+					constReplaceIdentifier(element, value, errCode);
+				}
+			}
+			return;
+
+		case E_ASSIGN:
+			// assignment inside of expression
+			constSubstitute(&element->data.elements[1], environment, errCode);
+			constEnvironmentSet(environment, element->data.elements[0].symbol, NULL);
+			return;
+
+		case E_S_FUNCTION_CALL:
+			// function name is not substituted
+			if(element->nodeSize > 1) {
+				constSubstitute(&element->data.elements[1], environment, errCode);
+			}
+			return;
+
+		default:
+			for(unsigned int i = 0; i < element->nodeSize && *errCode == ERROR_SUCCESS; i++) {
+				constSubstitute(&element->data.elements[i], environment, errCode);
+			}
+			return;
+	}
+}
+
+/**
+ * Substitutes known values into the expression and folds it
+ * @param element expression element
+ * @param environment environment
+ * @param errCode error code
+ * @return literal token of the folded expression, NULL if the value is not known
+ */
+static token_t* constEvaluate(treeElement_t* element, constEnvironment_t* environment, int* errCode) {
+	constSubstitute(element, environment, errCode);
+	if(*errCode != ERROR_SUCCESS) {
+		return NULL;
+	}
+	semanticFold(element, errCode);
+	if(*errCode != ERROR_SUCCESS) {
+		return NULL;
+	}
+	return getLiteral(element);
+}
+
+/**
+ * Replaces the statement by statements of the block
+ * @param parent block containing the statement
+ * @param index statement index
+ * @param block block to move the statements from, NULL to remove the statement
+ * @param errCode error code
+ */
+static void constReplaceStatement(treeElement_t* parent, unsigned int index, treeElement_t* block, int* errCode) {
+	treeElement_t* statements = NULL;
+	unsigned int count = 0;
+	if(block != NULL) {
+		// take the statements, so that they are not freed with the replaced statement
+		statements = block->data.elements;
+		count = block->nodeSize;
+		block->data.elements = NULL;
+		block->nodeSize = 0;
+	}
+	// symbols may still view names of the identifiers in the replaced statement
+	constReleaseNames(&parent->data.elements[index]);
+	if(!treeReplaceElement(parent, index, statements, count)) {
+		for(unsigned int i = 0; i < count; i++) {
+			treeFree(statements[i]);
+		}
+		*errCode = ERROR_INTERNAL;
+	}
+	free(statements);
+}
+
+/**
+ * Propagates constants through the block of code
+ * @param block tree element with block of code
+ * @param environment known values at the beginning of the block, updated to the values at its end
+ * @param errCode error code
+ */
+static void constPropagateBlock(treeElement_t* block, constEnvironment_t* environment, int* errCode) {
+	unsigned int i = 0;
+	while(i < block->nodeSize && *errCode == ERROR_SUCCESS) {
+		treeElement_t* statement = &block->data.elements[i];
+		switch(statement->type) {
+			case E_ASSIGN: {
+				token_t* value = constEvaluate(&statement->data.elements[1], environment, errCode);
+				if(*errCode == ERROR_SUCCESS && !constEnvironmentSet(environment, statement->data.elements[0].symbol, value)) {
+					*errCode = ERROR_INTERNAL;
+				}
+				break;
+			}
+
+			case E_S_EXPRESSION:
+			case E_S_RETURN:
+				for(unsigned int j = 0; j < statement->nodeSize; j++) {
+					constEvaluate(&statement->data.elements[j], environment, errCode);
+				}
+				break;
+
+			case E_S_IF: {
+				token_t* condition = constEvaluate(&statement->data.elements[0], environment, errCode);
+				if(*errCode != ERROR_SUCCESS) {
+					return;
+				}
+				treeElement_t* elseBlock = (statement->nodeSize > 2)? &statement->data.elements[2].data.elements[0] : NULL;
+				if(condition != NULL) {
+					// only one of the branches is ever executed, its statements are processed next
+					constReplaceStatement(block, i, constIsTrue(condition)? &statement->data.elements[1] : elseBlock,
+							errCode);
+					continue;
+				}
+				constEnvironment_t elseEnvironment;
+				constEnvironmentInit(&elseEnvironment);
+				if(!constEnvironmentCopy(&elseEnvironment, environment)) {
+					*errCode = ERROR_INTERNAL;
+				}
+				constPropagateBlock(&statement->data.elements[1], environment, errCode);
+				if(elseBlock != NULL) {
+					constPropagateBlock(elseBlock, &elseEnvironment, errCode);
+				}
+				constEnvironmentMerge(environment, &elseEnvironment);
+				constEnvironmentFree(&elseEnvironment);
+				break;
+			}
+
+			case E_S_WHILE: {
+				// loop is never entered if the condition is false at its beginning
+				treeElement_t entryCondition;
+				if(!treeCopy(&entryCondition, &statement->data.elements[0])) {
+					*errCode = ERROR_INTERNAL;
+					return;
+				}
+				token_t* condition = constEvaluate(&entryCondition, environment, errCode);
+				bool entered = condition == NULL || constIsTrue(condition);
+				treeFree(entryCondition);
+				if(*errCode != ERROR_SUCCESS) {
+					return;
+				}
+				if(!entered) {
+					constReplaceStatement(block, i, NULL, errCode);
+					continue;
+				}
+				// values assigned in the body are not known in the condition and after the loop
+				constEnvironmentKill(environment, &statement->data.elements[1]);
+				constEvaluate(&statement->data.elements[0], environment, errCode);
+				if(*errCode != ERROR_SUCCESS) {
+					return;
+				}
+				constEnvironment_t bodyEnvironment;
+				constEnvironmentInit(&bodyEnvironment);
+				if(!constEnvironmentCopy(&bodyEnvironment, environment)) {
+					*errCode = ERROR_INTERNAL;
+				}
+				constPropagateBlock(&statement->data.elements[1], &bodyEnvironment, errCode);
+				constEnvironmentFree(&bodyEnvironment);
+				break;
+			}
+
+			default:
+				break;
+		}
+		i++;
+	}
+}
+
+void constPropagate(treeElement_t* codeElement, int* errCode) {
+	if(codeElement->type != E_CODE) {
+		*errCode = ERROR_INTERNAL;
+		return;
+	}
+
+	// top-level code is executed in order, functions can't assign global variables
+	constEnvironment_t environment;
+	constEnvironmentInit(&environment);
+
+	for(unsigned int i = 0; i < codeElement->nodeSize && *errCode == ERROR_SUCCESS; i++) {
+		treeElement_t* element = &codeElement->data.elements[i];
+		if(element->type == E_CODE_BLOCK) {
+			constPropagateBlock(element, &environment, errCode);
+		} else if(element->type == E_S_FUNCTION_DEF) {
+			// function body can be executed at any time, so no value is known at its beginning
+			for(unsigned int j = 0; j < element->nodeSize; j++) {
+				if(element->data.elements[j].type == E_CODE_BLOCK) {
+					constEnvironment_t functionEnvironment;
+					constEnvironmentInit(&functionEnvironment);
+					constPropagateBlock(&element->data.elements[j], &functionEnvironment, errCode);
+					constEnvironmentFree(&functionEnvironment);
+				}
+			}
+		}
+	}
+
+	constEnvironmentFree(&environment);
+}
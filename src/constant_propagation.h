@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#pragma once
+
+#include "parse_tree.h"
+#include "symtable.h"
+
+/**
+ * Known values of variables at a point of the program
+ */
+typedef struct const_environment {
+	symbol_t **symbols; // variable symbols
+	token_t **values; // borrowed literal tokens of the assignments, NULL if the value is not known
+	size_t size;
+	size_t capacity;
+} constEnvironment_t;
+
+/**
+ * Initializes an empty environment
+ * @param environment environment to initialize
+ */
+void constEnvironmentInit(constEnvironment_t* environment);
+
+/**
+ * Frees the environment
+ * @param environment environment to free
+ */
+void constEnvironmentFree(constEnvironment_t* environment);
+
+/**
+ * Returns known value of the variable
+ * @param environment environment
+ * @param symbol variable symbol
+ * @return literal token, NULL if the value is not known
+ */
+token_t* constEnvironmentGet(const constEnvironment_t* environment, const symbol_t* symbol);
+
+/**
+ * Sets value of the variable
+ * @param environment environment
+ * @param symbol variable symbol
+ * @param value literal token, NULL if the value is not known
+ * @return execution status
+ */
+bool constEnvironmentSet(constEnvironment_t* environment, symbol_t* symbol, token_t* value);
+
+/**
+ * Propagates constants assigned to variables in the top-level code and function bodies,
+ * substitutes them into expressions, folds the expressions and removes branches
+ * which are never executed. The tree must be semantically checked.
+ * @param codeElement tree element containing the program code
+ * @param errCode error code
+ */
+void constPropagate(treeElement_t* codeElement, int* errCode);
@@ -18,16 +18,83 @@
 
 #include "dynamic_string.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/// Determines whether the character has to be written as an escape sequence in IFJcode19
+#define ESC_CLASS(c) ((c) <= 32 || (c) == '#' || (c) == '\\' || (c) == 127)
+/// Escape sequence of the character (backslash followed by three decimal digits)
+#define ESC_SEQ(c) {'\\', '0' + (c) / 100, '0' + (c) / 10 % 10, '0' + (c) % 10}
+#define ESC_4(M, c) M(c), M((c) + 1), M((c) + 2), M((c) + 3)
+#define ESC_16(M, c) ESC_4(M, c), ESC_4(M, (c) + 4), ESC_4(M, (c) + 8), ESC_4(M, (c) + 12)
+#define ESC_64(M, c) ESC_16(M, c), ESC_16(M, (c) + 16), ESC_16(M, (c) + 32), ESC_16(M, (c) + 48)
+#define ESC_256(M) ESC_64(M, 0), ESC_64(M, 64), ESC_64(M, 128), ESC_64(M, 192)
+
+/// Classification of all bytes, true if the byte has to be escaped
+static const bool dynStrEscapeClass[256] = {ESC_256(ESC_CLASS)};
+
+/// Precomputed escape sequences of all bytes
+static const char dynStrEscapeSequence[256][4] = {ESC_256(ESC_SEQ)};
+
+#ifdef __SSE2__
+/**
+ * Returns the mask of bytes in the chunk which have to be escaped
+ * @param chunk Chunk of 16 bytes
+ * @return Bit mask of bytes to escape
+ */
+static inline int dynStrEscapeMask(__m128i chunk) {
+	// unsigned chunk >= 33
+	__m128i printable = _mm_cmpeq_epi8(_mm_max_epu8(chunk, _mm_set1_epi8(33)), chunk);
+	__m128i special = _mm_or_si128(
+		_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('#')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))),
+		_mm_cmpeq_epi8(chunk, _mm_set1_epi8(127))
+	);
+	return (~_mm_movemask_epi8(printable) & 0xFFFF) | _mm_movemask_epi8(special);
+}
+#endif
+
+/**
+ * Counts characters which have to be escaped
+ * @param str String
+ * @param size String size
+ * @return Count of characters to escape
+ */
+static unsigned long dynStrEscapeCount(const unsigned char *str, unsigned long size) {
+	unsigned long count = 0;
+	unsigned long i = 0;
+#ifdef __SSE2__
+	for (; i + 16 <= size; i += 16) {
+		count += __builtin_popcount(dynStrEscapeMask(_mm_loadu_si128((const __m128i *) (str + i))));
+	}
+#endif
+	for (; i < size; ++i) {
+		count += dynStrEscapeClass[str[i]];
+	}
+	return count;
+}
+
+/**
+ * Writes the character or its escape sequence before the position
+ * @param str Output string
+ * @param position Position after the written character, moved to the beginning of the written sequence
+ * @param c Character to write
+ */
+static inline void dynStrEscapeChar(char *str, unsigned long *position, unsigned char c) {
+	if (dynStrEscapeClass[c]) {
+		*position -= 4;
+		memcpy(str + *position, dynStrEscapeSequence[c], 4);
+	} else {
+		str[--(*position)] = (char) c;
+	}
+}
+
 dynStr_t *dynStrInit() {
 	dynStr_t *string = malloc(sizeof(dynStr_t));
 	if (string == NULL) {
 		return NULL;
 	}
-	string->string = malloc(DYN_STR_LENGTH);
-	if (string->string == NULL) {
-		free(string);
-		return NULL;
-	}
+	string->string = string->buffer;
 	string->alloc_size = DYN_STR_LENGTH;
 	dynStrClear(string);
 	return string;
@@ -51,32 +118,52 @@ void dynStrClear(dynStr_t *string) {
 	}
 	string->string[0] = 0;
 	string->size = 0;
-	char *tmp = realloc(string->string, DYN_STR_LENGTH);
-	if (tmp == NULL) {
-		return;
-	}
-	string->string = tmp;
 }
 
 void dynStrFree(dynStr_t *string) {
 	if (string != NULL) {
-		free(string->string);
+		if (string->string != string->buffer) {
+			free(string->string);
+		}
 		free(string);
 	}
 }
 
-bool dynStrAppendChar(dynStr_t *string, char c) {
+bool dynStrReserve(dynStr_t *string, unsigned long size) {
 	if (string == NULL) {
 		return false;
 	}
-	if (string->size + 1 >= string->alloc_size) {
-		unsigned long newSize = string->alloc_size + DYN_STR_LENGTH;
-		char *tmp = realloc(string->string, newSize);
+	if (size < string->alloc_size) {
+		return true;
+	}
+	unsigned long newSize = string->alloc_size;
+	while (newSize <= size) {
+		newSize *= 2;
+	}
+	char *tmp;
+	if (string->string == string->buffer) {
+		tmp = malloc(newSize);
 		if (tmp == NULL) {
 			return false;
 		}
-		string->string = tmp;
-		string->alloc_size = newSize;
+		memcpy(tmp, string->buffer, string->size + 1);
+	} else {
+		tmp = realloc(string->string, newSize);
+		if (tmp == NULL) {
+			return false;
+		}
+	}
+	string->string = tmp;
+	string->alloc_size = newSize;
+	return true;
+}
+
+bool dynStrAppendChar(dynStr_t *string, char c) {
+	if (string == NULL) {
+		return false;
+	}
+	if (string->size + 1 >= string->alloc_size && !dynStrReserve(string, string->size + 1)) {
+		return false;
 	}
 	string->string[string->size++] = c;
 	string->string[string->size] = 0;
@@ -87,18 +174,18 @@ bool dynStrAppendString(dynStr_t *string, const char* str) {
 	if (string == NULL || str == NULL) {
 		return false;
 	}
-	size_t strLen = strlen(str);
-	if (string->size + strLen + 1 >= string->alloc_size) {
-		unsigned long newSize = string->alloc_size + strLen + DYN_STR_LENGTH;
-		char* tmp = realloc(string->string, newSize);
-		if (tmp == NULL) {
-			return false;
-		}
-		string->string = tmp;
-		string->alloc_size = newSize;
+	return dynStrAppendBuffer(string, str, strlen(str));
+}
+
+bool dynStrAppendBuffer(dynStr_t *string, const char* buffer, size_t length) {
+	if (string == NULL || buffer == NULL) {
+		return false;
+	}
+	if (!dynStrReserve(string, string->size + length)) {
+		return false;
 	}
-	strcat(string->string, str);
-	string->size += strLen;
+	memcpy(string->string + string->size, buffer, length);
+	string->size += length;
 	string->string[string->size] = 0;
 	return true;
 }
@@ -110,7 +197,7 @@ bool dynStrEqual(dynStr_t* string1, dynStr_t *string2) {
 	if (string1 == NULL || string2 == NULL) {
 		return false;
 	}
-	return strcmp(string1->string, string2->string) == 0;
+	return string1->size == string2->size && memcmp(string1->string, string2->string, string1->size) == 0;
 }
 
 bool dynStrEqualString(dynStr_t* string, const char* str) {
@@ -129,14 +216,14 @@ bool dynStrCopy(dynStr_t *dst, dynStr_t *src) {
 	if (dst == NULL || src == NULL) {
 		return false;
 	}
-	char* tmp = realloc(dst->string, src->alloc_size);
-	if (tmp == NULL) {
+	if (dst == src) {
+		return true;
+	}
+	if (!dynStrReserve(dst, src->size)) {
 		return false;
 	}
-	dst->string = tmp;
-	dst->alloc_size = src->alloc_size;
+	memcpy(dst->string, src->string, src->size + 1);
 	dst->size = src->size;
-	strcpy(dst->string, src->string);
 	return true;
 }
 
@@ -156,28 +243,38 @@ bool dynStrEscape(dynStr_t *string) {
 	if (string == NULL) {
 		return false;
 	}
-	dynStr_t *tmp = dynStrInit();
-	if (tmp == NULL) {
+	unsigned long size = string->size;
+	unsigned long escaped = dynStrEscapeCount((const unsigned char *) string->string, size);
+	if (escaped == 0) {
+		return true;
+	}
+	unsigned long newSize = size + 3 * escaped;
+	if (!dynStrReserve(string, newSize)) {
 		return false;
 	}
-	for (size_t i = 0; i < strlen(string->string); i++) {
-		char c = string->string[i];
-		if (!isprint(c) || (c == ' ') || (c == '#') || (c == '\\')) {
-			char esc[5];
-			sprintf(esc, "\\%03d", c);
-			if (!dynStrAppendString(tmp, esc)) {
-				return false;
-			}
-		} else {
-			if (!dynStrAppendChar(tmp, c)) {
-				return false;
-			}
+	// Expands the string in place from its end, the prefix before the first escaped character stays untouched
+	char *str = string->string;
+	unsigned long i = size;
+	unsigned long j = newSize;
+	str[newSize] = 0;
+#ifdef __SSE2__
+	while (i >= 16 && i < j) {
+		__m128i chunk = _mm_loadu_si128((const __m128i *) (str + i - 16));
+		if (dynStrEscapeMask(chunk) == 0) {
+			i -= 16;
+			j -= 16;
+			_mm_storeu_si128((__m128i *) (str + j), chunk);
+			continue;
+		}
+		for (int k = 0; k < 16; ++k) {
+			dynStrEscapeChar(str, &j, (unsigned char) str[--i]);
 		}
 	}
-	if (!dynStrCopy(string, tmp)) {
-		return false;
+#endif
+	while (i > 0 && i < j) {
+		dynStrEscapeChar(str, &j, (unsigned char) str[--i]);
 	}
-	dynStrFree(tmp);
+	string->size = newSize;
 	return true;
 }
 
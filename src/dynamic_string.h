@@ -25,12 +25,14 @@
 #include <stdlib.h>
 #include <string.h>
 
-#define DYN_STR_LENGTH 8
+/// Capacity of the inline buffer, strings shorter than this never touch the heap
+#define DYN_STR_LENGTH 24
 
 typedef struct dynamic_string {
-	char* string;
+	char* string; // points either to the inline buffer or to the heap
 	unsigned long size;
 	unsigned long alloc_size;
+	char buffer[DYN_STR_LENGTH];
 } dynStr_t;
 
 /**
@@ -47,7 +49,7 @@ dynStr_t *dynStrInit();
 dynStr_t *dynStrInitString(const char* str);
 
 /**
- * Clears a dynamic string
+ * Clears a dynamic string, the allocated capacity is retained
  * @param string Dynamic string
  */
 void dynStrClear(dynStr_t *string);
@@ -74,6 +76,23 @@ bool dynStrAppendChar(dynStr_t *string, char c);
  */
 bool dynStrAppendString(dynStr_t *string, const char* str);
 
+/**
+ * Appends a buffer of the known length to a dynamic string
+ * @param string Dynamic string
+ * @param buffer Buffer to append
+ * @param length Buffer length
+ * @return Execution status
+ */
+bool dynStrAppendBuffer(dynStr_t *string, const char* buffer, size_t length);
+
+/**
+ * Ensures the dynamic string can hold the string of the size without reallocation
+ * @param string Dynamic string
+ * @param size Requested string size (without the terminating null byte)
+ * @return Execution status
+ */
+bool dynStrReserve(dynStr_t *string, unsigned long size);
+
 /**
  * Determines whether two dynamic strings have the same value
  * @param string1 First dynamic string to compare
@@ -113,7 +132,8 @@ bool dynStrCopy(dynStr_t *dst, dynStr_t *src);
 dynStr_t *dynStrClone(dynStr_t *src);
 
 /**
- * Escape the dynamic string
+ * Escapes the dynamic string in place as the IFJcode19 string literal
+ * (bytes 0-32, '#', '\\' and 127 are written as \xyz, other bytes are kept)
  * @param string Dynamic string
  * @return Execution status
  */
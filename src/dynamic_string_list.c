@@ -18,6 +18,26 @@
 
 #include "dynamic_string_list.h"
 
+/**
+ * Links the element at the end of the list
+ * @param list Dynamic string list
+ * @param element Element to link
+ * @return Execution status
+ */
+static bool dynStrListAppend(dynStrList_t *list, dynStrListEl_t *element) {
+	if (element == NULL) {
+		return false;
+	}
+	if (list->head == NULL) {
+		list->head = list->tail = element;
+	} else {
+		element->prev = list->tail;
+		list->tail->next = element;
+		list->tail = element;
+	}
+	return true;
+}
+
 dynStrList_t *dynStrListInit() {
 	dynStrList_t *list = malloc(sizeof(dynStrList_t));
 	if (list == NULL) {
@@ -95,18 +115,14 @@ bool dynStrListPushBack(dynStrList_t *list, dynStr_t *string) {
 	if (list == NULL || string == NULL) {
 		return false;
 	}
-	dynStrListEl_t *element = dynStrListElInit(string);
-	if (element == NULL) {
+	return dynStrListAppend(list, dynStrListElInit(string));
+}
+
+bool dynStrListPushBackView(dynStrList_t *list, strView_t view) {
+	if (list == NULL || strViewIsNull(view)) {
 		return false;
 	}
-	if (list->head == NULL) {
-		list->head = list->tail = element;
-	} else {
-		element->prev = list->tail;
-		list->tail->next = element;
-		list->tail = element;
-	}
-	return true;
+	return dynStrListAppend(list, dynStrListElInitView(view));
 }
 
 dynStrListEl_t *dynStrListFront(dynStrList_t *list) {
@@ -161,7 +177,7 @@ void dynStrListPrint(dynStrList_t *list) {
 		return;
 	}
 	for (dynStrListEl_t *element = dynStrListFront(list); element != NULL; element = dynStrListElNext(element)) {
-		printf("%s", dynStrGetString(dynStrListElGet(element)));
+		strViewPrint(dynStrListElGetView(element), stdout);
 	}
 }
 
@@ -176,6 +192,22 @@ dynStrListEl_t *dynStrListElInit(dynStr_t *string) {
 	element->next = NULL;
 	element->prev = NULL;
 	element->string = string;
+	element->view = strViewNull();
+	return element;
+}
+
+dynStrListEl_t *dynStrListElInitView(strView_t view) {
+	if (strViewIsNull(view)) {
+		return NULL;
+	}
+	dynStrListEl_t *element = malloc(sizeof(dynStrListEl_t));
+	if (element == NULL) {
+		return NULL;
+	}
+	element->next = NULL;
+	element->prev = NULL;
+	element->string = NULL;
+	element->view = view;
 	return element;
 }
 
@@ -190,3 +222,13 @@ void dynStrListElFree(dynStrListEl_t *element) {
 dynStr_t *dynStrListElGet(dynStrListEl_t *element) {
 	return element->string;
 }
+
+strView_t dynStrListElGetView(dynStrListEl_t *element) {
+	if (element == NULL) {
+		return strViewNull();
+	}
+	if (element->string != NULL) {
+		return strViewDynStr(element->string);
+	}
+	return element->view;
+}
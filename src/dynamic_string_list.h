@@ -21,13 +21,15 @@
 #include <stdbool.h>
 
 #include "dynamic_string.h"
+#include "string_view.h"
 
 typedef struct dynamic_string_list_element dynStrListEl_t;
 
 struct dynamic_string_list_element {
 	dynStrListEl_t *next;
 	dynStrListEl_t *prev;
-	dynStr_t *string;
+	dynStr_t *string; // owned dynamic string, NULL if the element borrows a view
+	strView_t view; // borrowed string view, used only if the string is NULL
 };
 
 
@@ -96,6 +98,14 @@ bool dynStrListPushFront(dynStrList_t *list, dynStr_t *string);
  */
 bool dynStrListPushBack(dynStrList_t *list, dynStr_t *string);
 
+/**
+ * Adds a new element borrowing the string view at the end
+ * @param list Dynamic string list
+ * @param view String view to add, the viewed string has to outlive the list
+ * @return Execution status
+ */
+bool dynStrListPushBackView(dynStrList_t *list, strView_t view);
+
 /**
  * Returns the first element
  * @param list Dynamic string list
@@ -144,6 +154,13 @@ void dynStrListPrint(dynStrList_t *list);
  */
 dynStrListEl_t *dynStrListElInit(dynStr_t *string);
 
+/**
+ * Initializes a new dynamic string list element borrowing the string view
+ * @param view String view
+ * @return Initialized dynamic string element
+ */
+dynStrListEl_t *dynStrListElInitView(strView_t view);
+
 /**
  * Frees a dynamic string list element
  * @param element Dynamic string element to free
@@ -153,6 +170,13 @@ void dynStrListElFree(dynStrListEl_t *element);
 /**
  * Returns the dynamic string from dynamic string list element
  * @param element Dynamic string list element
- * @return Dynamic string
+ * @return Dynamic string, NULL if the element borrows a view
  */
 dynStr_t *dynStrListElGet(dynStrListEl_t *element);
+
+/**
+ * Returns the view of the string from dynamic string list element
+ * @param element Dynamic string list element
+ * @return String view (of the owned dynamic string or the borrowed one)
+ */
+strView_t dynStrListElGetView(dynStrListEl_t *element);
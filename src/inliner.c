@@ -0,0 +1,375 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "inliner.h"
+
+/**
+ * Growing instruction stream
+ */
+typedef struct inliner_stream {
+	irInstruction_t *instructions;
+	size_t size;
+	size_t capacity;
+} inlinerStream_t;
+
+/**
+ * Appends the instruction to the stream
+ * @param stream Instruction stream
+ * @param instruction Instruction
+ * @return Execution status
+ */
+static bool inlinerAppend(inlinerStream_t *stream, const irInstruction_t *instruction) {
+	if (stream->size == stream->capacity) {
+		size_t capacity = stream->capacity == 0 ? 64 : stream->capacity * 2;
+		irInstruction_t *instructions = realloc(stream->instructions, capacity * sizeof(irInstruction_t));
+		if (instructions == NULL) {
+			return false;
+		}
+		stream->instructions = instructions;
+		stream->capacity = capacity;
+	}
+	stream->instructions[stream->size++] = *instruction;
+	return true;
+}
+
+/**
+ * Counts instructions of the program functions
+ * @param program Program
+ * @return Number of instructions, preformatted code is not counted
+ */
+static size_t inlinerProgramSize(const irProgram_t *program) {
+	size_t size = 0;
+	for (const irFunction_t *function = program->first; function != NULL; function = function->next) {
+		for (const irBlock_t *block = function->first; block != NULL; block = block->next) {
+			size += block->count;
+		}
+	}
+	return size;
+}
+
+/**
+ * Counts calls of the function in the program
+ * @param program Program
+ * @param name Function name
+ * @return Number of calls
+ */
+static size_t inlinerCalls(const irProgram_t *program, strView_t name) {
+	size_t calls = 0;
+	for (const irFunction_t *function = program->first; function != NULL; function = function->next) {
+		for (const irBlock_t *block = function->first; block != NULL; block = block->next) {
+			for (size_t i = 0; i < block->count; ++i) {
+				const irInstruction_t *instruction = &block->instructions[i];
+				calls += instruction->opcode == IR_CALL && strViewEqual(instruction->operands[0].data.label.name, name);
+			}
+		}
+	}
+	return calls;
+}
+
+/**
+ * Finds the function which is inlined by the cost model
+ * @param program Program
+ * @param name Called function name
+ * @param stack The call uses the stack calling convention
+ * @return Function or NULL if the call is kept
+ */
+static irFunction_t* inlinerSelect(const irProgram_t *program, strView_t name, bool stack) {
+	for (irFunction_t *function = program->first; function != NULL; function = function->next) {
+		if (function == program->main || !strViewEqual(function->name, name)) {
+			continue;
+		}
+		size_t size;
+		if (!(stack ? inlinerIsStackLeaf(function, &size) : inlinerIsLeaf(function, &size))) {
+			return NULL;
+		}
+		// the only call does not duplicate any code, the function is removed
+		return (size <= INLINER_MAX_SIZE || inlinerCalls(program, name) == 1) ? function : NULL;
+	}
+	return NULL;
+}
+
+/**
+ * Renames the operand of the inlined body, local variables are moved to the temporary frame
+ * and labels get the instance suffix
+ * @param program Program owning the new names
+ * @param operand Operand to rename
+ * @param instance Number of the inlined body
+ * @return Execution status
+ */
+static bool inlinerRename(irProgram_t *program, irOperand_t *operand, size_t instance) {
+	if (operand->type == IR_OPERAND_VARIABLE && operand->data.variable.frame == FRAME_LOCAL) {
+		// the symbol would print the local frame
+		operand->data.variable.frame = FRAME_TEMP;
+		operand->data.variable.symbol = NULL;
+		return true;
+	}
+	if (operand->type != IR_OPERAND_LABEL) {
+		return true;
+	}
+	strView_t name = operand->data.label.name;
+	char *buffer = malloc(name.length + 48);
+	if (buffer == NULL) {
+		return false;
+	}
+	memcpy(buffer, name.string, name.length);
+	size_t length = name.length;
+	if (operand->data.label.index >= 0) {
+		length += sprintf(buffer + length, "%ld", operand->data.label.index);
+	}
+	sprintf(buffer + length, "$%zu", instance);
+	operand->data.label.name = irProgramAddName(program, buffer);
+	operand->data.label.index = -1;
+	free(buffer);
+	return !strViewIsNull(operand->data.label.name);
+}
+
+/**
+ * Appends the body of the inlined function, returns jump to the end of the body
+ * @param program Program owning the new names
+ * @param callee Inlined function
+ * @param stream Instruction stream of the caller
+ * @param instance Number of the inlined body
+ * @return Execution status
+ */
+static bool inlinerExpand(irProgram_t *program, const irFunction_t *callee, inlinerStream_t *stream, size_t instance) {
+	irOperand_t end = irLabel(strViewString("$inlineEnd"), (long) instance);
+	// returns after the last other instruction (labels aside) fall through to the end of the body
+	size_t tail = 0;
+	size_t position = 0;
+	for (const irBlock_t *block = callee->first; block != NULL; block = block->next) {
+		for (size_t i = 0; i < block->count; ++i) {
+			position++;
+			irOpcode_t opcode = block->instructions[i].opcode;
+			if (opcode != IR_RETURN && opcode != IR_LABEL && opcode != IR_POPFRAME) {
+				tail = position;
+			}
+		}
+	}
+	bool jumped = false;
+	position = 0;
+	for (const irBlock_t *block = callee->first; block != NULL; block = block->next) {
+		for (size_t i = 0; i < block->count; ++i) {
+			irInstruction_t instruction = block->instructions[i];
+			if (instruction.opcode == IR_PUSHFRAME || instruction.opcode == IR_POPFRAME) {
+				// frame of the stack calling convention stays temporary
+				position++;
+				continue;
+			}
+			if (instruction.opcode == IR_RETURN) {
+				if (++position > tail) {
+					continue;
+				}
+				instruction.operands[0] = end;
+				instruction.opcode = IR_JUMP;
+				jumped = true;
+			} else {
+				position++;
+				for (unsigned k = 0; k < irOpcodeOperands(instruction.opcode); ++k) {
+					if (!inlinerRename(program, &instruction.operands[k], instance)) {
+						return false;
+					}
+				}
+			}
+			if (!inlinerAppend(stream, &instruction)) {
+				return false;
+			}
+		}
+	}
+	irInstruction_t label = {.opcode = IR_LABEL, .operands = {end}};
+	return !jumped || inlinerAppend(stream, &label);
+}
+
+/**
+ * Inlines the selected calls of the function
+ * @param program Program
+ * @param function Function to optimize
+ * @param instance Number of the inlined bodies, updated
+ * @param stats Statistics to update, can be NULL
+ * @return Execution status
+ */
+static bool inlinerFunction(irProgram_t *program, irFunction_t *function, size_t *instance, inlinerStats_t *stats) {
+	inlinerStream_t code = {.instructions = NULL, .size = 0, .capacity = 0};
+	for (const irBlock_t *block = function->first; block != NULL; block = block->next) {
+		for (size_t i = 0; i < block->count; ++i) {
+			if (!inlinerAppend(&code, &block->instructions[i])) {
+				free(code.instructions);
+				return false;
+			}
+		}
+	}
+	inlinerStream_t stream = {.instructions = NULL, .size = 0, .capacity = 0};
+	bool success = true;
+	bool changed = false;
+	for (size_t i = 0; success && i < code.size; ++i) {
+		// PUSHFRAME; CALL f; POPFRAME -> body of f in the temporary frame
+		irFunction_t *callee = NULL;
+		size_t skipped = 0;
+		if (i + 2 < code.size && code.instructions[i].opcode == IR_PUSHFRAME
+			&& code.instructions[i + 1].opcode == IR_CALL && code.instructions[i + 2].opcode == IR_POPFRAME) {
+			callee = inlinerSelect(program, code.instructions[i + 1].operands[0].data.label.name, false);
+			skipped = 2;
+		} else if (code.instructions[i].opcode == IR_CALL && (i == 0 || code.instructions[i - 1].opcode != IR_PUSHFRAME)) {
+			// CALL f -> body of f creating its frame as the temporary one
+			callee = inlinerSelect(program, code.instructions[i].operands[0].data.label.name, true);
+		}
+		if (callee == NULL || callee == function) {
+			success = inlinerAppend(&stream, &code.instructions[i]);
+			continue;
+		}
+		success = inlinerExpand(program, callee, &stream, (*instance)++);
+		changed = true;
+		i += skipped;
+		if (stats != NULL) {
+			stats->calls++;
+		}
+	}
+	free(code.instructions);
+	if (success && changed) {
+		// rebuild the basic blocks
+		irPosition_t begin = {.block = NULL, .index = 0};
+		success = irFunctionTruncate(function, begin);
+		for (size_t i = 0; success && i < stream.size; ++i) {
+			success = irEmitInstruction(function, &stream.instructions[i]);
+		}
+	}
+	free(stream.instructions);
+	return success;
+}
+
+/**
+ * Checks if the instruction can be a part of the inlined body
+ * @param instruction Instruction
+ * @return Does the instruction keep the frames and the temporary frame untouched?
+ */
+static bool inlinerIsLeafInstruction(const irInstruction_t *instruction) {
+	switch (instruction->opcode) {
+		case IR_CREATEFRAME:
+		case IR_PUSHFRAME:
+		case IR_POPFRAME:
+		case IR_CALL:
+			return false;
+		default:
+			break;
+	}
+	for (unsigned k = 0; k < irOpcodeOperands(instruction->opcode); ++k) {
+		const irOperand_t *operand = &instruction->operands[k];
+		if (operand->type == IR_OPERAND_VARIABLE && operand->data.variable.frame == FRAME_TEMP) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool inlinerIsLeaf(const irFunction_t *function, size_t *size) {
+	if (function == NULL || !strViewIsNull(function->code)) {
+		return false;
+	}
+	size_t count = 0;
+	for (const irBlock_t *block = function->first; block != NULL; block = block->next) {
+		for (size_t i = 0; i < block->count; ++i) {
+			if (!inlinerIsLeafInstruction(&block->instructions[i])) {
+				return false;
+			}
+			count++;
+		}
+	}
+	if (size != NULL) {
+		*size = count;
+	}
+	return true;
+}
+
+bool inlinerIsStackLeaf(const irFunction_t *function, size_t *size) {
+	if (function == NULL || !strViewIsNull(function->code)) {
+		return false;
+	}
+	size_t count = 0;
+	bool framed = false;
+	bool popped = false;
+	for (const irBlock_t *block = function->first; block != NULL; block = block->next) {
+		for (size_t i = 0; i < block->count; ++i) {
+			const irInstruction_t *instruction = &block->instructions[i];
+			if (popped && instruction->opcode != IR_RETURN) {
+				return false;
+			}
+			popped = false;
+			if (count == 0 && instruction->opcode == IR_CREATEFRAME) {
+				framed = true;
+			} else if (count == 1 && framed) {
+				if (instruction->opcode != IR_PUSHFRAME) {
+					return false;
+				}
+			} else if (framed && instruction->opcode == IR_POPFRAME) {
+				popped = true;
+			} else if (!inlinerIsLeafInstruction(instruction)) {
+				return false;
+			}
+			count++;
+		}
+	}
+	if (popped || (framed && count < 2)) {
+		return false;
+	}
+	if (size != NULL) {
+		*size = count;
+	}
+	return true;
+}
+
+bool inlineFunctions(irProgram_t *program, inlinerStats_t *stats) {
+	if (program == NULL) {
+		return false;
+	}
+	if (stats != NULL) {
+		stats->before += inlinerProgramSize(program);
+	}
+	size_t instance = 0;
+	for (irFunction_t *function = program->first; function != NULL; function = function->next) {
+		if (strViewIsNull(function->code) && !inlinerFunction(program, function, &instance, stats)) {
+			return false;
+		}
+	}
+	// functions whose calls were all inlined
+	irFunction_t *function = program->first;
+	while (function != NULL) {
+		irFunction_t *next = function->next;
+		// leaf functions of both calling conventions
+		if (function != program->main && inlinerIsStackLeaf(function, NULL)
+			&& inlinerCalls(program, function->name) == 0) {
+			if (!irProgramRemoveFunction(program, function)) {
+				return false;
+			}
+			if (stats != NULL) {
+				stats->removed++;
+			}
+		}
+		function = next;
+	}
+	if (stats != NULL) {
+		stats->after += inlinerProgramSize(program);
+	}
+	return true;
+}
+
+void inlinerPrintStats(FILE *file, const inlinerStats_t *stats) {
+	fprintf(file, "inliner: %zu calls inlined, %zu functions removed\n", stats->calls, stats->removed);
+	fprintf(file, "inliner: %zu instructions before, %zu after\n", stats->before, stats->after);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include "intermediate_code.h"
+
+/// largest function (in instructions) inlined at every call site, functions called once are always inlined
+#define INLINER_MAX_SIZE 16
+
+/**
+ * Inliner statistics
+ */
+typedef struct inliner_stats {
+	size_t calls; // number of inlined calls
+	size_t removed; // number of functions removed after all their calls were inlined
+	size_t before; // number of instructions before inlining
+	size_t after; // number of instructions after inlining
+} inlinerStats_t;
+
+/**
+ * Checks if the function can be inlined, it must not create frames nor call functions,
+ * so its body can run in the temporary frame of the call
+ * @param function Function
+ * @param size Number of the function instructions, can be NULL
+ * @return Can the function be inlined?
+ */
+bool inlinerIsLeaf(const irFunction_t *function, size_t *size);
+
+/**
+ * Checks if the function of the stack calling convention can be inlined, it can create its own frame
+ * in the prologue and pop it before returning, otherwise it is a leaf, so the frame can stay temporary
+ * @param function Function
+ * @param size Number of the function instructions, can be NULL
+ * @return Can the function be inlined?
+ */
+bool inlinerIsStackLeaf(const irFunction_t *function, size_t *size);
+
+/**
+ * Replaces calls of the small leaf functions by their bodies, the body runs in the temporary frame
+ * created for the call (or by the function of the stack calling convention), local variables are moved to it
+ * and returns jump after the body,
+ * functions without remaining calls are removed
+ * @param program Program to optimize
+ * @param stats Statistics to update, can be NULL
+ * @return Execution status
+ */
+bool inlineFunctions(irProgram_t *program, inlinerStats_t *stats);
+
+/**
+ * Prints the statistics report
+ * @param file Output file
+ * @param stats Statistics
+ */
+void inlinerPrintStats(FILE *file, const inlinerStats_t *stats);
@@ -18,347 +18,588 @@
 
 #include "inter_code_generator.h"
 
-// string names of the frames
-const char* FRAME_NAME[] = {
-        [FRAME_GLOBAL] = "GF",
-        [FRAME_LOCAL] = "LF",
-        [FRAME_TEMP] = "TF"
-};
-
-int processCode(treeElement_t codeElement, symTable_t* symTable) {
+#include <string.h>
+#include <unistd.h>
+#include "common_subexpression.h"
+#include "inliner.h"
+#include "peephole.h"
+#include "type_inference.h"
+
+/**
+ * Create label operand
+ * @param name label name
+ * @param index number appended to the name (label counter)
+ * @return operand
+ */
+static irOperand_t numberedLabel(const char* name, long index) {
+    return irLabel(strViewString(name), index);
+}
 
-    if(codeElement.type != E_CODE){
-        return ERROR_SEMANTIC_OTHER;
-    }
+/**
+ * Create operand of the generated global variable
+ * @param name variable name
+ * @return operand
+ */
+static irOperand_t globalVariable(const char* name) {
+    return irVariable(FRAME_GLOBAL, strViewString(name));
+}
 
-    //TODO
-    // list dealocation!
+/**
+ * Create string constant operand
+ * @param value escaped string
+ * @return operand
+ */
+static irOperand_t stringConstant(const char* value) {
+    return irString(strViewString(value));
+}
 
-    // string list where code is generated to
-    dynStrList_t* codeStrList;
-    codeStrList = dynStrListInit();
+/**
+ * Create the constant which the condition value of the single known type is false for
+ * @param types set of possible condition types inferred by the type inference
+ * @param constant false constant
+ * @return is the condition type known?
+ */
+static bool falseConstant(unsigned int types, irOperand_t* constant) {
+    switch (types) {
+        case VALUE_INT:
+            *constant = irInt(0);
+            return true;
+        case VALUE_FLOAT:
+            *constant = irFloat(0.0);
+            return true;
+        case VALUE_STRING:
+            *constant = stringConstant("");
+            return true;
+        case VALUE_BOOL:
+            *constant = irBool(false);
+            return true;
+        case VALUE_NONE:
+            *constant = irNil();
+            return true;
+        default:
+            return false;
+    }
+}
 
-    if(codeStrList == NULL) {
+/**
+ * Generate instruction of the expression with the destination variable
+ * @param function function unit where code is generated to
+ * @param instruction instruction generated by the expression
+ * @param destination destination variable
+ * @return execution status
+ */
+static int emitInstruction(irFunction_t* function, const codeInstruction_t* instruction, irOperand_t destination) {
+    // expression without instruction
+    if(!instruction->generated) {
+        return ERROR_SUCCESS;
+    }
+    irInstruction_t complete = instruction->instruction;
+    complete.operands[0] = destination;
+    if(!irEmitInstruction(function, &complete)) {
         return ERROR_INTERNAL;
     }
+    return ERROR_SUCCESS;
+}
 
-    // clear assigment to use it in variable definition
-    symTableClearAssigment(symTable);
-
-    // name of function to determine if variable is global or local
-    dynStr_t* context = NULL;
+/**
+ * Generated global variables, defined in the main function prologue only if they are used
+ */
+typedef enum helper_variable {
+    HELPER_CONDITION, // result of the comparison kept only for the jump
+    HELPER_RESULT, // result of the inlined embedded function, dropped return value of the stack calling convention
+    HELPER_TYPE, // type of the checked embedded function argument
+    HELPER_TEMP_IF, // if condition value and its type for the runtime type dispatch
+    HELPER_TEMP_IF_TYPE,
+    HELPER_TEMP_WHILE, // while condition value and its type for the runtime type dispatch
+    HELPER_TEMP_WHILE_TYPE,
+    HELPER_ARGUMENT0, // evaluated embedded function arguments, HELPER_ARGUMENTS variables in a row
+    HELPER_COUNT = HELPER_ARGUMENT0 + 8
+} helperVariable_t;
+
+/// number of the argument variables
+#define HELPER_ARGUMENTS (HELPER_COUNT - HELPER_ARGUMENT0)
+
+/// names of the generated global variables
+static const char* helperNames[HELPER_COUNT] = {"$$condition", "$$result", "$$type", "$$tempIf", "$$tempIfType",
+        "$$tempWhile", "$$tempWhileType", "$$argument0", "$$argument1", "$$argument2", "$$argument3", "$$argument4",
+        "$$argument5", "$$argument6", "$$argument7"};
+
+/// the generated global variable is used and has to be defined in the main function
+static bool helperUsed[HELPER_COUNT];
+
+/**
+ * Create operand of the generated global variable and mark it as used
+ * @param variable generated variable
+ * @return operand
+ */
+static irOperand_t helperVariable(helperVariable_t variable) {
+    helperUsed[variable] = true;
+    return globalVariable(helperNames[variable]);
+}
 
-	generateEmbeddedFunctions(codeStrList);
+/// user functions take arguments and return values on the data stack
+static bool stackCalls;
 
-	// Main function label
-	dynStr_t *mainLabel = dynStrInitString("LABEL $$main\n");
-	if (mainLabel == NULL) {
-		return ERROR_INTERNAL;
-	}
-	if(!dynStrListPushBack(codeStrList, mainLabel)) {
-		dynStrFree(mainLabel);
-		return ERROR_INTERNAL;
-	}
+/// the generated user function has its own local frame, it is popped before returning
+static bool functionFrame;
 
-	static int cblockVarNameCounter = 0;
+/// self tail calls are compiled into jumps to the function entry
+static bool tailCalls;
 
-    for (unsigned i = 0; i < codeElement.nodeSize; i++) {
-        int retval = ERROR_SUCCESS;
+/// while loops with the condition variable of unknown type get a copy specialized for its type
+static bool loopVersioning;
 
-        bool pushToStack = true;
-        dynStr_t* temp;
+/// parameters of the generated user function and its entry label after the prologue
+static treeElement_t functionParams;
+static irOperand_t functionEntry;
 
-        // process code content
-        switch (codeElement.data.elements[i].type) {
-            case E_TOKEN:
-                retval = processExpression(codeElement.data.elements[i], &pushToStack, symTable, context, codeStrList);
-                temp = dynStrInit();
-                if(numberToDynStr(temp, "DEFVAR GF@cblockVar%d\nPOP GF@cblockVar%d\n", cblockVarNameCounter)){
-                    dynStrFree(temp);
-                    retval = ERROR_INTERNAL;
-                    break;
-                }
-                if(dynStrListPushBack(codeStrList, temp)) {
-                    dynStrFree(temp);
-                    retval = ERROR_INTERNAL;
-                    break;
-                }
-                break;
-            case E_S_FUNCTION_DEF:
-                retval = processFunctionDefinition(codeElement.data.elements[i], symTable, context, codeStrList);
-                break;
-            case E_CODE_BLOCK:
-                retval = processCodeBlock(codeElement.data.elements[i], symTable, context, codeStrList);
-                break;
-            default:
-                return ERROR_SEMANTIC_OTHER; // failed to process the code
+/**
+ * Check if the function is embedded, embedded functions always use the frame calling convention
+ * @param name function name
+ * @return is the function embedded?
+ */
+static bool functionIsEmbedded(strView_t name) {
+    static const char* embedded[] = {"inputs", "inputi", "inputf", "print", "len", "substr", "ord", "chr"};
+    for (size_t i = 0; i < sizeof(embedded) / sizeof(embedded[0]); i++) {
+        if(strViewEqualString(name, embedded[i])) {
+            return true;
         }
-        if(retval)
-            return retval;
     }
-
-	// Main function jump
-	dynStr_t *mainJump = dynStrInitString("JUMP $$main\n");
-	if (mainJump == NULL) {
-		return ERROR_INTERNAL;
-	}
-	if(!dynStrListPushFront(codeStrList, mainJump)) {
-		dynStrFree(mainJump);
-		return ERROR_INTERNAL;
-	}
-
-	// IFJcode19 shebang
-	dynStr_t* header = dynStrInitString(".IFJcode19\n");
-	if(header == NULL) {
-		return ERROR_INTERNAL;
-	}
-	if(!dynStrListPushFront(codeStrList, header)) {
-		dynStrFree(header);
-		return ERROR_INTERNAL;
-	}
-
-    //TODO
-    // process code content ending
-
-	dynStrListPrint(codeStrList);
-
-    return ERROR_SUCCESS;
+    return false;
 }
 
-int processEToken(treeElement_t eTokenElement, dynStr_t* outputDynStr, bool id_only,
-        symTable_t* symTable, dynStr_t* context, bool* varDefined) {
+/**
+ * Check if the call of the function passes the arguments and the return value on the data stack
+ * @param name called function name
+ * @return does the call use the stack calling convention?
+ */
+static bool callUsesStack(strView_t name) {
+    return stackCalls && !functionIsEmbedded(name);
+}
 
-    if(eTokenElement.type != E_TOKEN) {
-        return ERROR_SEMANTIC_OTHER;
+/**
+ * Check if the code uses a local variable
+ * @param element tree element
+ * @return is there a local variable?
+ */
+static bool usesLocalVariable(treeElement_t element) {
+    if(element.type == E_TOKEN) {
+        return element.symbol != NULL && element.symbol->type == SYMBOL_VARIABLE
+                && !strViewIsNull(element.symbol->context);
+    }
+    for (unsigned i = 0; i < element.nodeSize; i++) {
+        if(usesLocalVariable(element.data.elements[i])) {
+            return true;
+        }
     }
+    return false;
+}
 
-    if(!outputDynStr) {
-        return ERROR_INTERNAL;
+/**
+ * Unwrap the expression in parentheses
+ * @param element expression element
+ * @return inner element
+ */
+static treeElement_t unwrapExpression(treeElement_t element) {
+    while(element.type == E_S_EXPRESSION && element.nodeSize == 1) {
+        element = element.data.elements[0];
     }
+    return element;
+}
 
-    if(id_only && eTokenElement.data.token->type != T_ID) {
-        return ERROR_SEMANTIC_OTHER;
+/**
+ * Check if the return statement returns the value of the call of the function itself
+ * @param returnElement tree element with return statement
+ * @param context local scope function name
+ * @return is it a self tail call?
+ */
+static bool returnIsTailCall(treeElement_t returnElement, strView_t context) {
+    if(!tailCalls || strViewIsNull(context) || returnElement.nodeSize != 1) {
+        return false;
     }
+    treeElement_t value = unwrapExpression(returnElement.data.elements[0]);
+    return value.type == E_S_FUNCTION_CALL
+            && strViewEqual(strViewDynStr(value.data.elements[0].data.token->data.strval), context);
+}
 
-    int retval = ERROR_SUCCESS;
+/**
+ * Check if the code contains a self tail call
+ * @param element tree element
+ * @param context local scope function name
+ * @return is there a self tail call?
+ */
+static bool hasTailCall(treeElement_t element, strView_t context) {
+    if(element.type == E_TOKEN) {
+        return false;
+    }
+    if(element.type == E_S_RETURN) {
+        return returnIsTailCall(element, context);
+    }
+    for (unsigned i = 0; i < element.nodeSize; i++) {
+        if(hasTailCall(element.data.elements[i], context)) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    switch (eTokenElement.data.token->type) {
-        case T_NUMBER:
-            // add type
-            if(numberToDynStr(outputDynStr, "int@%ld", eTokenElement.data.token->data.intval)){
-                dynStrFree(outputDynStr);
-                return ERROR_INTERNAL;
-            }
-            break;
-        case T_FLOAT:
-            // add type
-            if(floatToDynStr(outputDynStr, "float@%a", eTokenElement.data.token->data.floatval)){
-                dynStrFree(outputDynStr);
-                return ERROR_INTERNAL;
-            }
-            break;
-        case T_STRING_ML:
-        case T_STRING:
-            if(!dynStrEscape(eTokenElement.data.token->data.strval)) {
-                return ERROR_INTERNAL;
-            }
-            if(!dynStrAppendString(outputDynStr, "string@")){
-                return ERROR_INTERNAL;
-            }
-            if(!dynStrAppendString(outputDynStr, eTokenElement.data.token->data.strval->string)) {
-                return ERROR_INTERNAL;
-            }
-            break;
-        case T_ID:
-            if(!id_only) { // variable - add  FRAME_TYPE@
-                // determine if variable is local or global
-                symbolFrame_t idFrame = symTableGetFrame(symTable, eTokenElement.data.token->data.strval, context);
-                if (!dynStrAppendString(outputDynStr, FRAME_NAME[idFrame])) {
-                    return ERROR_INTERNAL;
-                }
-                if (!dynStrAppendString(outputDynStr, "@")) {
-                    return ERROR_INTERNAL;
-                }
-            }
-            // add name
-            if(!dynStrAppendString(outputDynStr, dynStrGetString(eTokenElement.data.token->data.strval))) {
-                return ERROR_INTERNAL;
-            }
-            if(varDefined) {
-                // tells if variable is defined
-                *varDefined = symTableIsVariableAssigned(symTable, eTokenElement.data.token->data.strval, context);
-                // sets value to true
-                if(!(*varDefined)) {
-                    retval = symTableInsertVariable(symTable, eTokenElement.data.token->data.strval, context, true);
-                }
-                if(retval) {
-                    return retval;
-                }
-            }
-            break;
-		case T_BOOL_TRUE:
-		    if(!dynStrAppendString(outputDynStr, "bool@true")){
-			    dynStrFree(outputDynStr);
-			    return ERROR_INTERNAL;
-		    }
-		    break;
-		case T_BOOL_FALSE:
-		    if(!dynStrAppendString(outputDynStr, "bool@false")){
-			    dynStrFree(outputDynStr);
-			    return ERROR_INTERNAL;
-		    }
-		    break;
-		case T_KW_NONE:
-			if(!dynStrAppendString(outputDynStr, "nil@nil")){
-				dynStrFree(outputDynStr);
-				return ERROR_INTERNAL;
-			}
-			break;
-        default:
-            return ERROR_SEMANTIC_OTHER;
+/**
+ * Define the variables of the scope in its prologue, their assignments (also in loops
+ * and in the code jumping back to the function entry) only move the values then
+ * @param element tree element
+ * @param context local scope function name, null view for the global variables
+ * @param function function unit where code is generated to
+ * @return execution status
+ */
+static int defineVariables(treeElement_t element, strView_t context, irFunction_t* function) {
+    if(element.type == E_TOKEN) {
+        symbol_t* symbol = element.symbol;
+        if(symbol == NULL || symbol->type != SYMBOL_VARIABLE || symbol->info.variable.assigned
+        || !strViewEqual(symbol->context, context)) {
+            return ERROR_SUCCESS;
+        }
+        symbol->info.variable.assigned = true;
+        return irEmit(function, IR_DEFVAR, irSymbol(symbol)) ? ERROR_SUCCESS : ERROR_INTERNAL;
+    }
+    for (unsigned i = 0; i < element.nodeSize; i++) {
+        int retval = defineVariables(element.data.elements[i], context, function);
+        if(retval) {
+            return retval;
+        }
     }
+    return ERROR_SUCCESS;
+}
 
+/**
+ * Generate check of the embedded function argument type, the program exits with the type error
+ * if the argument has different type, the check is omitted if the argument type is known
+ * @param argument argument operand
+ * @param types set of possible argument types inferred by the type inference
+ * @param expected expected argument type
+ * @param function function unit where code is generated to
+ * @return execution status
+ */
+static int processArgumentCheck(irOperand_t argument, unsigned int types, valueType_t expected,
+        irFunction_t* function) {
+    static unsigned checkCounter = 0;
+    if(types == (unsigned int) expected) {
+        return ERROR_SUCCESS;
+    }
+    irOperand_t type = helperVariable(HELPER_TYPE);
+    irOperand_t label = numberedLabel("$argumentChecked", checkCounter++);
+    const char* typeName = expected == VALUE_STRING ? "string" : "int";
+    if(!irEmit(function, IR_TYPE, type, argument)
+    || !irEmit(function, IR_JUMPIFEQ, label, type, stringConstant(typeName))
+    || !irEmit(function, IR_EXIT, irInt(ERROR_SEMANTIC_EXPRESSION))
+    || !irEmit(function, IR_LABEL, label)) {
+        return ERROR_INTERNAL;
+    }
     return ERROR_SUCCESS;
 }
 
-int processFunctionDefinition(treeElement_t defElement,symTable_t *symTable, dynStr_t* context,
-        dynStrList_t* codeStrList) {
+/**
+ * Check if the function call is an embedded function inlined by processEmbeddedCall
+ * @param callElement function call element
+ * @return is the call inlined?
+ */
+static bool embeddedCallIsInlined(treeElement_t callElement) {
+    strView_t name = strViewDynStr(callElement.data.elements[0].data.token->data.strval);
+    return strViewEqualString(name, "len") || strViewEqualString(name, "chr") || strViewEqualString(name, "ord");
+}
 
-    if(defElement.type != E_S_FUNCTION_DEF) {
+/**
+ * Process call of the len, chr or ord embedded function directly at the call site,
+ * arguments of the unknown type are checked inline
+ * @param callElement function call element
+ * @param pushToStack if true, the value is pushed to the stack
+ * @param instruction instruction generated if the value is not pushed to the stack
+ * @param symTable symbol table
+ * @param context local scope function name
+ * @param function function unit where code is generated to
+ * @return execution status
+ */
+static int processEmbeddedCall(treeElement_t callElement, bool pushToStack, codeInstruction_t* instruction,
+        symTable_t* symTable, strView_t context, irFunction_t* function) {
+    static unsigned ordCounter = 0;
+    strView_t name = strViewDynStr(callElement.data.elements[0].data.token->data.strval);
+    bool ord = strViewEqualString(name, "ord");
+    unsigned argc = ord ? 2 : 1;
+    if(callElement.nodeSize != 2 || callElement.data.elements[1].nodeSize != argc) {
         return ERROR_SEMANTIC_OTHER;
     }
+    treeElement_t* args = callElement.data.elements[1].data.elements;
 
-    int retval = ERROR_SUCCESS;
-
-    // processing function name
-    // (label to jump to when function is called)
-    dynStr_t* temp = dynStrInitString("LABEL ");
-    if(temp == NULL) {
-        return ERROR_INTERNAL;
+    // constants and variables are used directly, other arguments are evaluated on the stack in order
+    irOperand_t operands[2];
+    bool evaluated[2] = {false, false};
+    for (unsigned i = 0; i < argc; i++) {
+        treeElement_t arg = unwrapExpression(args[i]);
+        int retval = ERROR_SUCCESS;
+        if(arg.type == E_TOKEN) {
+            retval = processEToken(arg, &operands[i], false, NULL);
+        } else {
+            bool push = true;
+            codeInstruction_t argInstruction = {.generated = false};
+            retval = processExpression(args[i], &push, &argInstruction, symTable, context, function);
+            evaluated[i] = true;
+        }
+        if(retval) {
+            return retval;
+        }
+    }
+    for (unsigned i = argc; i-- > 0;) {
+        if(evaluated[i]) {
+            operands[i] = helperVariable(HELPER_ARGUMENT0 + i);
+            if(!irEmit(function, IR_POPS, operands[i])) {
+                return ERROR_INTERNAL;
+            }
+        }
     }
-    // dynamic string with function name, to determine variable context
-    dynStr_t* function_name = dynStrInit();
-    retval = processEToken(defElement.data.elements[0], function_name, true, symTable, context, NULL);
 
+    bool chr = strViewEqualString(name, "chr");
+    int retval = processArgumentCheck(operands[0], unwrapExpression(args[0]).valueTypes,
+            chr ? VALUE_INT : VALUE_STRING, function);
+    if(!retval && ord) {
+        retval = processArgumentCheck(operands[1], unwrapExpression(args[1]).valueTypes, VALUE_INT, function);
+    }
     if(retval) {
-        dynStrFree(function_name);
         return retval;
     }
-    if(!dynStrAppendString(temp, dynStrGetString(function_name))) {
-        dynStrFree(function_name);
-        return ERROR_INTERNAL;
-    }
-    if(!dynStrAppendString(temp, " \n")) {
-        dynStrFree(function_name);
+
+    if(!pushToStack && !chr && !ord) {
+        // length of the checked string is stored directly to the destination
+        instruction->generated = true;
+        instruction->instruction.opcode = IR_STRLEN;
+        instruction->instruction.operands[1] = operands[0];
+        return ERROR_SUCCESS;
+    }
+    irOperand_t result = helperVariable(HELPER_RESULT);
+    if(ord) {
+        // None if the index is out of the string
+        irOperand_t condition = helperVariable(HELPER_CONDITION);
+        irOperand_t end = numberedLabel("$ordEnd", ordCounter++);
+        if(!irEmit(function, IR_MOVE, result, irNil())
+        || !irEmit(function, IR_LT, condition, operands[1], irInt(0))
+        || !irEmit(function, IR_JUMPIFEQ, end, condition, irBool(true))
+        || !irEmit(function, IR_STRLEN, result, operands[0])
+        || !irEmit(function, IR_LT, condition, operands[1], result)
+        || !irEmit(function, IR_MOVE, result, irNil())
+        || !irEmit(function, IR_JUMPIFEQ, end, condition, irBool(false))
+        || !irEmit(function, IR_STRI2INT, result, operands[0], operands[1])
+        || !irEmit(function, IR_LABEL, end)) {
+            return ERROR_INTERNAL;
+        }
+    } else if(!irEmit(function, chr ? IR_INT2CHAR : IR_STRLEN, result, operands[0])) {
+        // chr is kept even if its value is not used, it fails for the invalid code point
         return ERROR_INTERNAL;
     }
 
-    // process function body
-    retval = processCodeBlock(defElement.data.elements[2], symTable, function_name, codeStrList);
-
-    dynStrFree(function_name);
-    //TODO
-    // add print return?
-    // add error check
-
-    return retval;
+    if(pushToStack) {
+        return irEmit(function, IR_PUSHS, result) ? ERROR_SUCCESS : ERROR_INTERNAL;
+    }
+    instruction->generated = true;
+    instruction->instruction.opcode = IR_MOVE;
+    instruction->instruction.operands[1] = result;
+    return ERROR_SUCCESS;
 }
 
-int processCodeBlock(treeElement_t codeBlockElement, symTable_t* symTable, dynStr_t* context, dynStrList_t* codeStrList) {
+/**
+ * Check if the expression calls a function which is not inlined, it can change the variables or do input and output
+ * @param element expression element
+ * @return is there such call?
+ */
+static bool expressionHasCall(treeElement_t element) {
+    if(element.type == E_TOKEN) {
+        return false;
+    }
+    if(element.type == E_S_FUNCTION_CALL && !embeddedCallIsInlined(element)) {
+        return true;
+    }
+    // name of the inlined function is a token
+    for (unsigned i = 0; i < element.nodeSize; i++) {
+        if(expressionHasCall(element.data.elements[i])) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    if(codeBlockElement.type != E_CODE_BLOCK) {
-        return ERROR_SEMANTIC_OTHER;
+/**
+ * Generate write of the print argument, None is written for the nil value
+ * @param value argument operand
+ * @param types set of possible argument types inferred by the type inference, 0 if unknown
+ * @param function function unit where code is generated to
+ * @return execution status
+ */
+static int processPrintValue(irOperand_t value, unsigned int types, irFunction_t* function) {
+    static unsigned printCounter = 0;
+    if(value.type == IR_OPERAND_NIL || types == VALUE_NONE) {
+        return irEmit(function, IR_WRITE, stringConstant("None")) ? ERROR_SUCCESS : ERROR_INTERNAL;
+    }
+    if(value.type != IR_OPERAND_VARIABLE || (types != 0 && !(types & VALUE_NONE))) {
+        return irEmit(function, IR_WRITE, value) ? ERROR_SUCCESS : ERROR_INTERNAL;
     }
+    unsigned counter = printCounter++;
+    irOperand_t notNone = numberedLabel("$printValue", counter);
+    irOperand_t written = numberedLabel("$printed", counter);
+    if(!irEmit(function, IR_JUMPIFNEQ, notNone, value, irNil())
+    || !irEmit(function, IR_WRITE, stringConstant("None"))
+    || !irEmit(function, IR_JUMP, written)
+    || !irEmit(function, IR_LABEL, notNone)
+    || !irEmit(function, IR_WRITE, value)
+    || !irEmit(function, IR_LABEL, written)) {
+        return ERROR_INTERNAL;
+    }
+    return ERROR_SUCCESS;
+}
 
-    // BLOCK START
+/**
+ * Check if the call argument is evaluated on the stack before it is passed, constants and variables are used directly
+ * @param arg argument expression
+ * @param hasCall some of the arguments calls a function which can change the variables
+ * @return is the argument evaluated?
+ */
+static bool argumentIsEvaluated(treeElement_t arg, bool hasCall) {
+    arg = unwrapExpression(arg);
+    return arg.type != E_TOKEN || (hasCall && arg.data.token->type == T_ID);
+}
 
-    for(unsigned i = 0; i < codeBlockElement.nodeSize; i++) {
+/**
+ * Process print call into the writes of its arguments separated by spaces, the arguments are evaluated first
+ * @param callElement print call element
+ * @param symTable symbol table
+ * @param context local scope function name
+ * @param function function unit where code is generated to
+ * @return execution status
+ */
+static int processPrint(treeElement_t callElement, symTable_t* symTable, strView_t context, irFunction_t* function) {
+    unsigned argc = callElement.nodeSize == 1 ? 0 : callElement.data.elements[1].nodeSize;
+    treeElement_t* args = argc == 0 ? NULL : callElement.data.elements[1].data.elements;
 
-        int retval = ERROR_SUCCESS;
-	    bool pushToStack = false;
+    // variables are read directly only if no argument call can change them
+    bool hasCall = false;
+    for (unsigned i = 0; i < argc; i++) {
+        hasCall = hasCall || expressionHasCall(args[i]);
+    }
+    unsigned evaluated = 0;
+    for (unsigned i = 0; i < argc; i++) {
+        evaluated += argumentIsEvaluated(args[i], hasCall);
+    }
+    if(evaluated > HELPER_ARGUMENTS) {
+        // embedded function writes the values from the stack
+        return processFunctionCall(callElement, symTable, context, function);
+    }
 
-        switch (codeBlockElement.data.elements[i].type) {
-            case E_S_EXPRESSION:
-                retval = processExpression(codeBlockElement.data.elements[i], &pushToStack, symTable, context, codeStrList);
-                break;
-            case E_ASSIGN:
-                retval = processAssign(codeBlockElement.data.elements[i], symTable, context, codeStrList);
-                break;
-            case E_S_IF:
-                retval = processIf(codeBlockElement.data.elements[i], symTable, context, codeStrList);
-                break;
-            case E_S_WHILE:
-                retval = processWhile(codeBlockElement.data.elements[i], symTable, context, codeStrList);
-                break;
-            default:
-                return ERROR_SEMANTIC_OTHER;
+    // evaluated values are stored in order before anything is written
+    irOperand_t* operands = malloc((argc == 0 ? 1 : argc) * sizeof(irOperand_t));
+    if(operands == NULL) {
+        return ERROR_INTERNAL;
+    }
+    int retval = ERROR_SUCCESS;
+    unsigned argument = 0;
+    for (unsigned i = 0; i < argc && !retval; i++) {
+        if(!argumentIsEvaluated(args[i], hasCall)) {
+            retval = processEToken(unwrapExpression(args[i]), &operands[i], false, NULL);
+            continue;
+        }
+        bool pushToStack = true;
+        codeInstruction_t instruction = {.generated = false};
+        retval = processExpression(args[i], &pushToStack, &instruction, symTable, context, function);
+        operands[i] = helperVariable(HELPER_ARGUMENT0 + argument++);
+    }
+    for (unsigned i = argc; i-- > 0 && !retval;) {
+        if(argumentIsEvaluated(args[i], hasCall) && !irEmit(function, IR_POPS, operands[i])) {
+            retval = ERROR_INTERNAL;
         }
-        if(retval)
-            return retval;
     }
 
-    // BLOCK END
-
-    return ERROR_SUCCESS;
+    for (unsigned i = 0; i < argc && !retval; i++) {
+        if(i > 0 && !irEmit(function, IR_WRITE, stringConstant("\\032"))) {
+            retval = ERROR_INTERNAL;
+            break;
+        }
+        retval = processPrintValue(operands[i], unwrapExpression(args[i]).valueTypes, function);
+    }
+    free(operands);
+    if(!retval && !irEmit(function, IR_WRITE, stringConstant("\\010"))) {
+        retval = ERROR_INTERNAL;
+    }
+    return retval;
 }
 
-int processExpression(treeElement_t expElement, bool* pushToStack,
-        symTable_t* symTable, dynStr_t* context, dynStrList_t* codeStrList) {
-
-    if(expElement.type != E_S_EXPRESSION) {
-        return ERROR_SEMANTIC_OTHER;
+/**
+ * Process function call whose value is used by the expression
+ * @param callElement function call element
+ * @param pushToStack if true, the value is pushed to the stack
+ * @param instruction instruction generated if the value is not pushed to the stack
+ * @param symTable symbol table
+ * @param context local scope function name
+ * @param function function unit where code is generated to
+ * @return execution status
+ */
+static int processCallValue(treeElement_t callElement, bool pushToStack, codeInstruction_t* instruction,
+        symTable_t* symTable, strView_t context, irFunction_t* function) {
+    if(embeddedCallIsInlined(callElement)) {
+        return processEmbeddedCall(callElement, pushToStack, instruction, symTable, context, function);
+    }
+    bool print = strViewEqualString(strViewDynStr(callElement.data.elements[0].data.token->data.strval), "print");
+    int retval = print ? processPrint(callElement, symTable, context, function)
+            : processFunctionCall(callElement, symTable, context, function);
+    if(retval) {
+        return retval;
     }
+    strView_t fname = strViewDynStr(callElement.data.elements[0].data.token->data.strval);
+    if(callUsesStack(fname)) {
+        if(pushToStack) {
+            return ERROR_SUCCESS;
+        }
+        // pop the return value from the stack
+        instruction->generated = true;
+        instruction->instruction.opcode = IR_POPS;
+        return ERROR_SUCCESS;
+    }
+    // print returns None
+    irOperand_t value = print ? irNil() : irVariable(FRAME_TEMP, strViewString("%retval"));
+    if(pushToStack) {
+        return irEmit(function, IR_PUSHS, value) ? ERROR_SUCCESS : ERROR_INTERNAL;
+    }
+    // move return value from the popped frame
+    instruction->generated = true;
+    instruction->instruction.opcode = IR_MOVE;
+    instruction->instruction.operands[1] = value;
+    return ERROR_SUCCESS;
+}
 
-    //TODO
-    // add pushToStack / use variables
-
+/**
+ * Process operand of the operation, its value is pushed to the stack if pushToStack is set
+ * @param element operand element
+ * @param convert convert the int value to float
+ * @param pushToStack if true, generates pushs instruction for variables and constants,
+ *                    operations with non-token operands set it
+ * @param instruction instruction generated if the value is not pushed to the stack
+ * @param operand token operand
+ * @param symTable symbol table
+ * @param context local scope function name
+ * @param function function unit where code is generated to
+ * @return execution status
+ */
+static int processOperand(treeElement_t element, bool convert, bool* pushToStack, codeInstruction_t* instruction,
+        irOperand_t* operand, symTable_t* symTable, strView_t context, irFunction_t* function) {
     int retval = ERROR_SUCCESS;
-    dynStr_t* temp;
-	treeElement_t element = expElement.data.elements[0];
-
     switch (element.type) {
         case E_TOKEN:
-            //TODO
-            // allocation / dealocation
-            temp = dynStrInit();
-            if(*pushToStack) {
-                if (!dynStrAppendString(temp, "PUSHS ")) {
-                    dynStrFree(temp);
-                    return ERROR_INTERNAL;
-                }
-            }
-            retval = processEToken(element, temp, false, symTable, context, NULL);
-            if(retval) {
-                dynStrFree(temp);
-                return ERROR_INTERNAL;
+            retval = processEToken(element, operand, false, NULL);
+            if (!retval && convert && operand->type == IR_OPERAND_INT) {
+                // literal is converted at compile time
+                *operand = irFloat((double) operand->data.intval);
+                convert = false;
             }
-            // add eol after value
-            if (!dynStrAppendString(temp, "\n")) {
-                dynStrFree(temp);
-                return ERROR_INTERNAL;
-            }
-            // add move operation if not pushing
-            if(!(*pushToStack)){
-                // add to list
-                if(!dynStrListPushBack(codeStrList, temp)) {
-                    dynStrFree(temp);
-                    return ERROR_INTERNAL;
-                }
-                // add operation
-                temp = dynStrInit();
-                if (!dynStrAppendString(temp, "MOVE ")) {
-                    dynStrFree(temp);
-                    return ERROR_INTERNAL;
-                }
-            }
-            // add to list
-            if(!dynStrListPushBack(codeStrList, temp)) {
-                dynStrFree(temp);
-                return ERROR_INTERNAL;
+            if (!retval && *pushToStack && !irEmit(function, IR_PUSHS, *operand)) {
+                retval = ERROR_INTERNAL;
             }
             break;
         case E_S_EXPRESSION:
-            retval = processExpression(element, pushToStack, symTable, context, codeStrList);
+            retval = processExpression(element, pushToStack, instruction, symTable, context, function);
             break;
         case E_ADD:
         case E_SUB:
@@ -368,622 +609,1015 @@ int processExpression(treeElement_t expElement, bool* pushToStack,
         case E_AND:
         case E_OR:
         case E_EQ:
+        case E_NEQ:
         case E_GT:
+        case E_GTE:
         case E_LT:
-            retval = processBinaryOperation(element, pushToStack, symTable, context, codeStrList);
+        case E_LTE:
+            retval = processBinaryOperation(element, pushToStack, instruction, symTable, context, function);
             break;
         case E_NOT:
-			retval = processUnaryOperation(element, pushToStack, symTable, context, codeStrList);
+            retval = processUnaryOperation(element, pushToStack, instruction, symTable, context, function);
             break;
         case E_S_FUNCTION_CALL:
-            retval = processFunctionCall(element, symTable, context, codeStrList);
+            retval = processCallValue(element, *pushToStack, instruction, symTable, context, function);
             break;
         case E_ASSIGN:
-            retval = processAssign(element, symTable, context, codeStrList);
+            retval = processAssign(element, symTable, context, function);
             break;
         default:
             return ERROR_SEMANTIC_OTHER;
     }
-
+    if (!retval && convert && !irEmit(function, IR_INT2FLOATS)) {
+        retval = ERROR_INTERNAL;
+    }
     return retval;
 }
 
-int processBinaryOperation(treeElement_t operationElement, bool* pushToStack, symTable_t* symTable, dynStr_t* context,
-        dynStrList_t* codeStrList) {
-
-    if (operationElement.nodeSize != 2) {
+/**
+ * Generate conditional jump on the comparison, its result is not stored
+ * @param comparison comparison element
+ * @param jumpIfTrue jump if the comparison is true, otherwise if it is false
+ * @param label jump target
+ * @param symTable symbol table
+ * @param context local scope function name
+ * @param function function unit where code is generated to
+ * @return execution status
+ */
+static int processComparisonBranch(treeElement_t comparison, bool jumpIfTrue, irOperand_t label,
+        symTable_t* symTable, strView_t context, irFunction_t* function) {
+    if (comparison.nodeSize != 2) {
         return ERROR_SEMANTIC_OTHER;
     }
 
-    int retval = ERROR_SUCCESS;
+    treeElement_t* operandElements = comparison.data.elements;
+    bool pushToStack = operandElements[0].type != E_TOKEN || operandElements[1].type != E_TOKEN;
+    bool convert[2];
+    for (int i = 0; i < 2; i++) {
+        convert[i] = typeIsConverted(comparison.type, operandElements[i].valueTypes,
+                operandElements[1 - i].valueTypes);
+        if (convert[i]) {
+            pushToStack = true;
+        }
+    }
 
-    if (operationElement.data.elements[0].type != E_TOKEN ||
-        operationElement.data.elements[1].type != E_TOKEN) {
-        *pushToStack = true;
+    irOperand_t operands[2];
+    codeInstruction_t instruction = {.generated = false};
+    for (int i = 0; i < 2; i++) {
+        int retval = processOperand(operandElements[i], convert[i], &pushToStack, &instruction, &operands[i],
+                symTable, context, function);
+        if (retval) {
+            return retval;
+        }
     }
 
-    dynStr_t *temp[3] = {NULL, NULL, NULL};
+    // a != b is not (a == b), a >= b is not (a < b), a <= b is not (a > b)
+    bool negated = comparison.type == E_NEQ || comparison.type == E_GTE || comparison.type == E_LTE;
+    bool jumpIf = jumpIfTrue != negated;
 
-    // extract data in reverse order (for pushing them to stack)
-    for (int i = 1; i >= 0; i--) {
-        switch (operationElement.data.elements[i].type) {
-            case E_TOKEN:
-                temp[i] = dynStrInit();
-                if (*pushToStack) {
-                    if (!dynStrAppendString(temp[i], "PUSHS ")) {
-                        retval = ERROR_INTERNAL;
-                        break;
-                    }
-                }
-                retval = processEToken(operationElement.data.elements[i], temp[i], false, symTable, context, NULL);
-                if (retval) {
-                    break;
-                }
-                if (*pushToStack) {
-                    if (!dynStrAppendString(temp[i], "\n")) {
-                        retval = ERROR_INTERNAL;
-                        break;
-                    }
-                    if (!dynStrListPushBack(codeStrList, temp[i])) {
-                        retval = ERROR_INTERNAL;
-                        break;
-                    }
-                }
-                break;
-            case E_S_EXPRESSION:
-                retval = processExpression(operationElement.data.elements[i], pushToStack, symTable, context, codeStrList);
-                break;
-            case E_ADD:
-            case E_SUB:
-            case E_MUL:
-            case E_DIV:
-            case E_DIV_INT:
-            case E_AND:
-            case E_OR:
-            case E_EQ:
-            case E_GT:
-            case E_LT:
-                retval = processBinaryOperation(operationElement.data.elements[i], pushToStack, symTable, context, codeStrList);
-                break;
-            case E_NOT:
-                retval = processUnaryOperation(operationElement.data.elements[i], pushToStack, symTable, context, codeStrList);
-                break;
-            case E_S_FUNCTION_CALL:
-                retval = processFunctionCall(operationElement.data.elements[i], symTable, context, codeStrList);
-                break;
-            case E_ASSIGN:
-                retval = processAssign(operationElement.data.elements[i], symTable, context, codeStrList);
-                break;
-            default:
-                return ERROR_SEMANTIC_OTHER;
-        }
-        if (retval) {
-            // free dynamic strings if they are not appended to the codeStrList
-            if (operationElement.data.elements[i].type == E_TOKEN) {
-                dynStrFree(temp[i]);
-            }
-            if(!(*pushToStack)) {
-                if (operationElement.data.elements[(i + 1) % 2].type == E_TOKEN) {
-                    dynStrFree(temp[(i + 1) % 2]);
-                }
-            }
-            return retval;
-        }
-    }
-
-
-    temp[2] = dynStrInit(); // init last string
-    // determine operation
-    // if value is not pushed, var name is added to operation in calling function
-    // and strings are concatenated
-    switch (operationElement.type) {
-        case E_ADD:
-            if(*pushToStack)
-                retval = !dynStrAppendString(temp[2], "ADDS\n");
-            else
-                retval = !dynStrAppendString(temp[2], "ADD ");
-            break;
-        case E_SUB:
-            if(*pushToStack)
-                retval = !dynStrAppendString(temp[2], "SUBS\n");
-            else
-                retval = !dynStrAppendString(temp[2], "SUB ");
-            break;
-        case E_MUL:
-            if(*pushToStack)
-                retval = !dynStrAppendString(temp[2], "MULS\n");
-            else
-                retval = !dynStrAppendString(temp[2], "MUL ");
-            break;
-        case E_DIV:
-            if(*pushToStack)
-                retval = !dynStrAppendString(temp[2], "DIVS\n");
-            else
-                retval = !dynStrAppendString(temp[2], "DIV ");
-            break;
-        case E_DIV_INT:
-            if(*pushToStack)
-                retval = !dynStrAppendString(temp[2], "IDIVS\n");
-            else
-                retval = !dynStrAppendString(temp[2], "IDIV ");
-            break;
-        case E_AND:
-            if(*pushToStack)
-                retval = !dynStrAppendString(temp[2], "ANDS\n");
-            else
-                retval = !dynStrAppendString(temp[2], "AND ");
-            break;
-        case E_OR:
-            if(*pushToStack)
-                retval = !dynStrAppendString(temp[2], "ORS\n");
-            else
-                retval = !dynStrAppendString(temp[2], "OR ");
-            break;
-        case E_EQ:
-            if(*pushToStack)
-                retval = !dynStrAppendString(temp[2], "EQS\n");
-            else
-                retval = !dynStrAppendString(temp[2], "EQ ");
-            break;
-        case E_LT:
-            if(*pushToStack)
-                retval = !dynStrAppendString(temp[2], "LTS\n");
-            else
-                retval = !dynStrAppendString(temp[2], "LT ");
-            break;
-        case E_GT:
-            if(*pushToStack)
-                retval = !dynStrAppendString(temp[2], "GTS\n");
-            else
-                retval = !dynStrAppendString(temp[2], "GT ");
-            break;
-        default:
-            return ERROR_SEMANTIC_OTHER;
-    }
-    // check for error
-    if (retval) {
-        dynStrFree(temp[2]);
-        if (!(*pushToStack)) {
-            dynStrFree(temp[1]);
-            dynStrFree(temp[0]);
+    if (comparison.type == E_EQ || comparison.type == E_NEQ) {
+        if (pushToStack) {
+            return irEmit(function, jumpIf ? IR_JUMPIFEQS : IR_JUMPIFNEQS, label) ? ERROR_SUCCESS : ERROR_INTERNAL;
         }
-        return ERROR_INTERNAL;
+        return irEmit(function, jumpIf ? IR_JUMPIFEQ : IR_JUMPIFNEQ, label, operands[0], operands[1])
+            ? ERROR_SUCCESS : ERROR_INTERNAL;
     }
-    if(!(*pushToStack)) {
-        // concatenate strings, add space and eol
-        // output is like "str1 str2\n"
-        if(!dynStrAppendString(temp[0], " ")
-        || !dynStrAppendString(temp[0], dynStrGetString(temp[1]))
-        || !dynStrAppendString(temp[0], "\n")) {
-            dynStrFree(temp[0]);
-            dynStrFree(temp[1]);
-            dynStrFree(temp[2]);
-            return ERROR_INTERNAL;
-        }
-        // free second string after concatenation
-        dynStrFree(temp[1]);
 
-        if(!dynStrListPushBack(codeStrList, temp[0])) {
-            dynStrFree(temp[0]);
-            dynStrFree(temp[2]);
+    bool less = comparison.type == E_LT || comparison.type == E_GTE;
+    if (pushToStack) {
+        if (!irEmit(function, less ? IR_LTS : IR_GTS)
+        || !irEmit(function, IR_PUSHS, irBool(jumpIf))
+        || !irEmit(function, IR_JUMPIFEQS, label)) {
             return ERROR_INTERNAL;
         }
+        return ERROR_SUCCESS;
     }
 
-    // add to list
-    if (!dynStrListPushBack(codeStrList, temp[2])) {
-        dynStrFree(temp[2]);
-        if (!(*pushToStack)) {
-            dynStrFree(temp[1]);
-            dynStrFree(temp[0]);
-        }
+    // result of the relational operation is kept only for the jump
+    irOperand_t condition = helperVariable(HELPER_CONDITION);
+    if (!irEmit(function, less ? IR_LT : IR_GT, condition, operands[0], operands[1])
+    || !irEmit(function, IR_JUMPIFEQ, label, condition, irBool(jumpIf))) {
         return ERROR_INTERNAL;
     }
-
     return ERROR_SUCCESS;
 }
 
-int processUnaryOperation(treeElement_t operationElement, bool* pushToStack, symTable_t* symTable,
-        dynStr_t* context, dynStrList_t* codeStrList){
+/**
+ * Check if the condition is lowered into jumps by processCondition
+ * @param condElement condition element
+ * @return is the condition lowered?
+ */
+static bool conditionIsLowered(treeElement_t condElement) {
+    irOperand_t falseValue;
+    if(falseConstant(condElement.valueTypes, &falseValue)) {
+        return true;
+    }
+    // logical operations are lowered when the types are inferred, whatever types their operands have
+    treeElement_t element = unwrapExpression(condElement);
+    return condElement.valueTypes != 0 && (element.type == E_AND || element.type == E_OR || element.type == E_NOT);
+}
 
-    if(operationElement.nodeSize != 1) {
-        return ERROR_SEMANTIC_OTHER;
-    }
+/**
+ * Generate conditional jump on the condition
+ * @param condElement condition element
+ * @param jumpIfTrue jump if the condition is true, otherwise if it is false
+ * @param label jump target
+ * @param logicalOperand condition is operand of a logical operation, so its value of unknown type has to be bool
+ * @param symTable symbol table
+ * @param context local scope function name
+ * @param function function unit where code is generated to
+ * @return execution status
+ */
+static int processJump(treeElement_t condElement, bool jumpIfTrue, irOperand_t label, bool logicalOperand,
+        symTable_t* symTable, strView_t context, irFunction_t* function) {
+    // used to make labels unique
+    static unsigned skipCounter = 0;
 
+    treeElement_t element = unwrapExpression(condElement);
     int retval = ERROR_SUCCESS;
-
-    dynStr_t* temp[2] = { NULL, NULL };
-
-    switch (operationElement.data.elements[0].type) {
-        case E_TOKEN:
-            temp[0] = dynStrInit();
-            if(*pushToStack) {
-                if (!dynStrAppendString(temp[0], "PUSHS ")) {
-                    dynStrFree(temp[0]);
-                    retval = ERROR_INTERNAL;
-                    break;
-                }
+    switch (element.type) {
+        case E_NOT:
+            if(element.nodeSize != 1) {
+                return ERROR_SEMANTIC_OTHER;
             }
-            retval = processEToken(operationElement.data.elements[0], temp[0], false, symTable, context, NULL);
-            if(retval)
-                break;
-            if(*pushToStack) {
-                if (!dynStrAppendString(temp[0], "\n")) {
+            // negation swaps the jump
+            return processJump(element.data.elements[0], !jumpIfTrue, label, true, symTable, context, function);
+        case E_AND:
+        case E_OR:
+            if(element.nodeSize != 2) {
+                return ERROR_SEMANTIC_OTHER;
+            }
+            if((element.type == E_AND) != jumpIfTrue) {
+                // false operand of and jumps (jump if false), true operand of or jumps (jump if true)
+                retval = processJump(element.data.elements[0], jumpIfTrue, label, true, symTable, context, function);
+                if(retval) {
+                    return retval;
+                }
+                return processJump(element.data.elements[1], jumpIfTrue, label, true, symTable, context, function);
+            } else {
+                // left operand decides the result, right one is skipped
+                irOperand_t skip = numberedLabel("$skip", skipCounter++);
+                retval = processJump(element.data.elements[0], !jumpIfTrue, skip, true, symTable, context, function);
+                if(!retval) {
+                    retval = processJump(element.data.elements[1], jumpIfTrue, label, true, symTable, context, function);
+                }
+                if(!retval && !irEmit(function, IR_LABEL, skip)) {
                     retval = ERROR_INTERNAL;
                 }
+                return retval;
             }
-            break;
-        case E_S_EXPRESSION:
-            *pushToStack = true;
-            retval = processExpression(operationElement.data.elements[0], pushToStack, symTable, context, codeStrList);
-            break;
-        case E_ADD:
-        case E_SUB:
-        case E_MUL:
-        case E_DIV:
-        case E_DIV_INT:
-        case E_AND:
-        case E_OR:
         case E_EQ:
+        case E_NEQ:
         case E_GT:
+        case E_GTE:
         case E_LT:
-            *pushToStack = true;
-            retval = processBinaryOperation(operationElement.data.elements[0], pushToStack, symTable, context, codeStrList);
-            break;
-        case E_NOT:
-            *pushToStack = true;
-            retval = processUnaryOperation(operationElement.data.elements[0], pushToStack, symTable, context, codeStrList);
-            break;
-        case E_S_FUNCTION_CALL:
-            *pushToStack = true;
-            retval = processFunctionCall(operationElement.data.elements[0], symTable, context, codeStrList);
-            break;
-        case E_ASSIGN:
-            *pushToStack = true;
-            retval = processAssign(operationElement.data.elements[0], symTable, context, codeStrList);
-            break;
+        case E_LTE:
+            return processComparisonBranch(element, jumpIfTrue, label, symTable, context, function);
         default:
+            break;
+    }
+
+    irOperand_t falseValue;
+    if(!falseConstant(element.valueTypes, &falseValue)) {
+        if(!logicalOperand) {
             return ERROR_SEMANTIC_OTHER;
+        }
+        // logical instructions accept only bool operands
+        falseValue = irBool(false);
     }
+
+    // value is compared with the false value of its type
+    treeElement_t expression = {.type = E_S_EXPRESSION, .data.elements = &element, .nodeSize = 1};
+    bool pushToStack = true;
+    codeInstruction_t instruction = {.generated = false};
+    retval = processExpression(expression, &pushToStack, &instruction, symTable, context, function);
     if(retval) {
-        dynStrFree(temp[0]);
         return retval;
     }
+    if(!irEmit(function, IR_PUSHS, falseValue)
+    || !irEmit(function, jumpIfTrue ? IR_JUMPIFNEQS : IR_JUMPIFEQS, label)) {
+        return ERROR_INTERNAL;
+    }
+    return ERROR_SUCCESS;
+}
 
-    temp[1] = dynStrInit();
+/**
+ * Generate short-circuit logical operation, its value is pushed to the stack,
+ * right operand is evaluated only if the left one doesn't decide the result
+ * @param operationElement and/or element
+ * @param symTable symbol table
+ * @param context local scope function name
+ * @param function function unit where code is generated to
+ * @return execution status
+ */
+static int processLogicalOperation(treeElement_t operationElement, symTable_t* symTable, strView_t context,
+        irFunction_t* function) {
+    // used to make labels unique
+    static unsigned logicalCounter = 0;
 
-    switch (operationElement.type){
-        case E_NOT:
-            if(*pushToStack)
-                retval = !dynStrAppendString(temp[1], "NOTS\n");
-            else
-                retval = !dynStrAppendString(temp[1], "NOT ");
-            break;
-        default:
-            retval = ERROR_SEMANTIC_OTHER;
+    if(operationElement.nodeSize != 2) {
+        return ERROR_SEMANTIC_OTHER;
     }
 
-    // check for errors
+    unsigned counter = logicalCounter++;
+    irOperand_t decided = numberedLabel("$decided", counter);
+    irOperand_t end = numberedLabel("$logicalEnd", counter);
+    // false decides and, true decides or
+    bool decidingValue = operationElement.type == E_OR;
+
+    int retval = processJump(operationElement.data.elements[0], decidingValue, decided, true, symTable, context,
+            function);
     if(retval) {
-        dynStrFree(temp[1]);
-        dynStrFree(temp[0]);
         return retval;
     }
 
-    // push value if any
-    if(!(*pushToStack)) {
-        if (!dynStrListPushBack(codeStrList, temp[0])) {
-            dynStrFree(temp[0]);
-            dynStrFree(temp[1]);
-            return ERROR_INTERNAL;
-        }
+    // result is the right operand
+    treeElement_t right = operationElement.data.elements[1];
+    bool pushToStack = true;
+    codeInstruction_t instruction = {.generated = false};
+    irOperand_t operand;
+    retval = processOperand(right, false, &pushToStack, &instruction, &operand, symTable, context, function);
+    if(retval) {
+        return retval;
     }
-    // push operation
-    if(!dynStrListPushBack(codeStrList, temp[1])) {
-        dynStrFree(temp[0]);
-        dynStrFree(temp[1]);
+
+    if(!irEmit(function, IR_JUMP, end)
+    || !irEmit(function, IR_LABEL, decided)
+    || !irEmit(function, IR_PUSHS, irBool(decidingValue))
+    || !irEmit(function, IR_LABEL, end)) {
         return ERROR_INTERNAL;
     }
-
     return ERROR_SUCCESS;
 }
 
-int processIf(treeElement_t ifElement, symTable_t* symTable, dynStr_t* context, dynStrList_t* codeStrList) {
-    if(ifElement.type != E_S_IF) {
-        return ERROR_SEMANTIC_OTHER;
-    }
+/**
+ * Measure the code of the function which is not generated, it is generated to a scratch program
+ * @param defElement tree element with function definition
+ * @param symTable symbol table
+ * @return size of the function code in bytes, 0 if it cannot be generated
+ */
+static size_t prunedFunctionSize(treeElement_t defElement, symTable_t* symTable) {
+    // generated variables used only by the pruned function are not defined
+    bool used[HELPER_COUNT];
+    memcpy(used, helperUsed, sizeof(used));
+    size_t size = 0;
+    irProgram_t* scratch = irProgramInit();
+    codeEmitter_t* emitter = codeEmitterInit();
+    if(scratch != NULL && emitter != NULL && processFunctionDefinition(defElement, symTable, scratch) == ERROR_SUCCESS
+    && irPrintFunction(emitter, scratch->first)) {
+        size = codeEmitterSize(emitter);
+    }
+    codeEmitterFree(emitter);
+    irProgramFree(scratch);
+    memcpy(helperUsed, used, sizeof(used));
+    return size;
+}
 
-    // used to make labels unique
-    static unsigned ifCounter = 0;
+/**
+ * Generate the program code
+ * @param codeElement tree element containing the program code
+ * @param symTable symbol table
+ * @param program program where code is generated to
+ * @param options code generation options, functions which are not marked as used are pruned if optimizing
+ * @return execution status
+ */
+static int processProgram(treeElement_t codeElement, symTable_t* symTable, irProgram_t* program,
+        const codeOptions_t* options) {
+    // clear assigment to use it in variable definition
+    symTableClearAssigment(symTable);
 
-    bool pushToStack = true;
+    // name of function to determine if variable is global or local
+    strView_t context = strViewNull();
 
-    int retval = ERROR_SUCCESS; // return value
+    int retval = ERROR_SUCCESS;
 
-    // expression
-    retval = processExpression(ifElement.data.elements[0], &pushToStack, symTable, context, codeStrList);
-    if(retval){
-        return retval;
+    // Main function
+    program->main = irProgramAddFunction(program, strViewString("$$main"));
+    if(program->main == NULL) {
+        return ERROR_INTERNAL;
+    }
+    for (unsigned i = 0; i < HELPER_COUNT; i++) {
+        helperUsed[i] = false;
     }
+    stackCalls = options->stackCalls;
+    tailCalls = options->optimization > 0;
+    loopVersioning = options->optimization > 0;
 
-    // workaround because function call doesn't work
-    if(ifCounter == 0) {
-        // define variables on firs if processing
-        dynStr_t* tmp = dynStrInit();
-        if(!dynStrAppendString(tmp, "DEFVAR GF@$$tempIf\n")) {
-            dynStrFree(tmp);
-            return ERROR_INTERNAL;
+    // global variables are defined before all the top-level code
+    for (unsigned i = 0; i < codeElement.nodeSize; i++) {
+        if(codeElement.data.elements[i].type == E_CODE_BLOCK) {
+            retval = defineVariables(codeElement.data.elements[i], context, program->main);
+            if(retval) {
+                return retval;
+            }
         }
-        if(!dynStrAppendString(tmp, "DEFVAR GF@$$tempIfType\n")) {
-            dynStrFree(tmp);
-            return ERROR_INTERNAL;
+    }
+
+    unsigned pruned = 0;
+    size_t prunedSize = 0;
+    for (unsigned i = 0; i < codeElement.nodeSize; i++) {
+        treeElement_t element = codeElement.data.elements[i];
+        // process code content
+        switch (element.type) {
+            case E_S_FUNCTION_DEF:
+                if(options->optimization > 0 && element.data.elements[0].symbol != NULL
+                && !element.data.elements[0].symbol->used) {
+                    // not reachable from the top-level code
+                    pruned++;
+                    if(options->verbose) {
+                        size_t size = prunedFunctionSize(element, symTable);
+                        fprintf(stderr, "functions: pruned %s (%zu bytes)\n",
+                                element.data.elements[0].data.token->data.strval->string, size);
+                        prunedSize += size;
+                    }
+                    break;
+                }
+                retval = processFunctionDefinition(element, symTable, program);
+                break;
+            case E_CODE_BLOCK:
+                retval = processCodeBlock(element, symTable, context, program->main);
+                break;
+            default:
+                return ERROR_SEMANTIC_OTHER; // failed to process the code
         }
-        // add to code list
-        retval = !dynStrListPushBack(codeStrList, tmp);
-        if(retval) {
-            dynStrFree(tmp);
+        if(retval)
+            return retval;
+    }
+    if(options->verbose && options->optimization > 0) {
+        fprintf(stderr, "functions: %u pruned, %zu bytes saved\n", pruned, prunedSize);
+    }
+
+    for (unsigned i = HELPER_COUNT; i-- > 0;) {
+        if(!helperUsed[i]) {
+            continue;
+        }
+        // defined once before all the code using them
+        irInstruction_t definition = {.opcode = IR_DEFVAR, .operands = {globalVariable(helperNames[i])}};
+        if(!irFunctionPrepend(program->main, &definition)) {
             return ERROR_INTERNAL;
         }
     }
-    // add if body
-    dynStr_t* temp = dynStrInit();
-    if(!dynStrAppendString(temp, "POPS GF@$$tempIf\n")) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    // only the embedded functions called by the program are generated
+    retval = generateEmbeddedFunctions(program);
+    if(retval) {
+        return retval;
     }
-    if(!dynStrAppendString(temp, "TYPE GF@$$tempIfType GF@$$tempIf\n")) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    //TODO
+    // process code content ending
+
+    return ERROR_SUCCESS;
+}
+
+int processCode(treeElement_t codeElement, symTable_t* symTable, const codeOptions_t* options) {
+
+    if(codeElement.type != E_CODE){
+        return ERROR_SEMANTIC_OTHER;
     }
-    if(!dynStrAppendString(temp, "PUSHS GF@$$tempIf\n")) {
-        dynStrFree(temp);
+
+    // program where code is generated to
+    irProgram_t* program = irProgramInit();
+    if(program == NULL) {
         return ERROR_INTERNAL;
     }
-    retval = numberToDynStr(temp, "JUMPIFEQ $$float%d GF@$$tempIfType string@float\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    int retval = processProgram(codeElement, symTable, program, options);
+    if(retval == ERROR_SUCCESS && options->optimization > 0) {
+        inlinerStats_t stats = {.calls = 0, .removed = 0, .before = 0, .after = 0};
+        if(!inlineFunctions(program, &stats)) {
+            retval = ERROR_INTERNAL;
+        } else if(options->verbose) {
+            inlinerPrintStats(stderr, &stats);
+        }
     }
-    retval = numberToDynStr(temp, "JUMPIFEQ $$int%d GF@$$tempIfType string@int\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+    if(retval == ERROR_SUCCESS && options->optimization > 0) {
+        cseStats_t stats = {.reused = 0, .redundant = 0, .removed = 0, .added = 0, .temporaries = 0};
+        if(!cseEliminate(program, &stats)) {
+            retval = ERROR_INTERNAL;
+        } else if(options->verbose) {
+            csePrintStats(stderr, &stats);
+        }
     }
-    retval = numberToDynStr(temp, "JUMPIFEQ $$bool%d GF@$$tempIfType string@bool\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+    if(retval == ERROR_SUCCESS && options->optimization > 0) {
+        peepholeStats_t stats = {.applied = {0}, .removed = {0}};
+        if(!peepholeOptimize(program, &stats)) {
+            retval = ERROR_INTERNAL;
+        } else if(options->verbose) {
+            peepholePrintStats(stderr, &stats);
+        }
     }
-    retval = numberToDynStr(temp, "JUMPIFEQ $$string%d GF@$$tempIfType string@string\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+    if(retval == ERROR_SUCCESS) {
+        // print the program and write the whole code at once
+        codeEmitter_t* emitter = codeEmitterInit();
+        if(emitter == NULL || !irPrint(emitter, program)) {
+            retval = ERROR_INTERNAL;
+        } else {
+            fflush(stdout);
+            if(!codeEmitterWrite(emitter, STDOUT_FILENO)) {
+                retval = ERROR_INTERNAL;
+            }
+        }
+        codeEmitterFree(emitter);
     }
-    retval = numberToDynStr(temp, "JUMPIFEQ $$nil%d GF@$$tempIfType string@nil\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    irProgramFree(program);
+    return retval;
+}
+
+int processEToken(treeElement_t eTokenElement, irOperand_t* operand, bool id_only, bool* varDefined) {
+
+    if(eTokenElement.type != E_TOKEN) {
+        return ERROR_SEMANTIC_OTHER;
     }
-    if(!dynStrAppendString(temp, "EXIT int@4\n")) {
-        dynStrFree(temp);
+
+    if(!operand) {
         return ERROR_INTERNAL;
     }
-    retval = numberToDynStr(temp, "LABEL $$float%d\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    token_t* token = eTokenElement.data.token;
+
+    if(id_only && token->type != T_ID) {
+        return ERROR_SEMANTIC_OTHER;
     }
-    if(!dynStrAppendString(temp, "PUSHS float@0x0p+0\n")) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    // operand of the string escaped by the scanner starts with the type
+    const size_t stringPrefix = strlen("string@");
+
+    switch (token->type) {
+        case T_NUMBER:
+            *operand = irInt(token->data.intval);
+            break;
+        case T_FLOAT:
+            *operand = irFloat(token->data.floatval);
+            break;
+        case T_STRING_ML:
+        case T_STRING:
+            // operand escaped by the scanner
+            if(token->operand == NULL || token->operand->size < stringPrefix) {
+                return ERROR_INTERNAL;
+            }
+            *operand = irString(strViewInit(token->operand->string + stringPrefix,
+                    token->operand->size - stringPrefix));
+            break;
+        case T_ID:
+            if(id_only) { // add name only
+                *operand = irLabel(strViewDynStr(token->data.strval), -1);
+                break;
+            }
+            // variable resolved by the semantic analysis
+            if(eTokenElement.symbol == NULL || eTokenElement.symbol->type != SYMBOL_VARIABLE) {
+                return ERROR_INTERNAL;
+            }
+            *operand = irSymbol(eTokenElement.symbol);
+            if(varDefined) {
+                // tells if variable is defined and sets it to defined
+                *varDefined = eTokenElement.symbol->info.variable.assigned;
+                eTokenElement.symbol->info.variable.assigned = true;
+            }
+            break;
+        case T_BOOL_TRUE:
+            *operand = irBool(true);
+            break;
+        case T_BOOL_FALSE:
+            *operand = irBool(false);
+            break;
+        case T_KW_NONE:
+            *operand = irNil();
+            break;
+        default:
+            return ERROR_SEMANTIC_OTHER;
     }
-    retval = numberToDynStr(temp, "JUMPIFNEQS $if%d\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
+
+    return ERROR_SUCCESS;
+}
+
+/**
+ * Return from the function, the frame of the function is popped by the stack calling convention
+ * @param function function unit where code is generated to
+ * @return execution status
+ */
+static int processFunctionExit(irFunction_t* function) {
+    if(stackCalls && functionFrame && !irEmit(function, IR_POPFRAME)) {
         return ERROR_INTERNAL;
     }
-    retval = numberToDynStr(temp, "JUMP $$nil%d\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+    return irEmit(function, IR_RETURN) ? ERROR_SUCCESS : ERROR_INTERNAL;
+}
+
+int processFunctionDefinition(treeElement_t defElement, symTable_t *symTable, irProgram_t* program) {
+
+    if(defElement.type != E_S_FUNCTION_DEF) {
+        return ERROR_SEMANTIC_OTHER;
     }
-    retval = numberToDynStr(temp, "LABEL $$int%d\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    int retval = ERROR_SUCCESS;
+
+    treeElement_t nameElement = defElement.data.elements[0];
+    if(nameElement.type != E_TOKEN || nameElement.data.token->type != T_ID) {
+        return ERROR_SEMANTIC_OTHER;
     }
-    retval = numberToDynStr(temp, "PUSHS int@0\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
+    // function name borrowed from the token, to determine variable context
+    strView_t function_name = strViewDynStr(nameElement.data.token->data.strval);
+
+    irFunction_t* function = irProgramAddFunction(program, function_name);
+    if(function == NULL) {
         return ERROR_INTERNAL;
     }
-    retval = numberToDynStr(temp, "JUMPIFNEQS $if%d\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    // function body is the last element, parameters are left out if there are none
+    treeElement_t body = defElement.data.elements[defElement.nodeSize - 1];
+    treeElement_t params = {.type = E_S_FUNCTION_DEF_PARAMS, .nodeSize = 0};
+    if(defElement.nodeSize > 2) {
+        params = defElement.data.elements[1];
     }
-    retval = numberToDynStr(temp, "JUMP $$nil%d\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+    // parameters are defined by the call, their assignments don't define them again
+    for (unsigned i = 0; i < params.nodeSize; i++) {
+        symbol_t* param = symTableFind(symTable, strViewDynStr(params.data.elements[i].data.token->data.strval),
+                function_name);
+        if(param == NULL) {
+            return ERROR_INTERNAL;
+        }
+        param->info.variable.assigned = true;
+    }
+
+    if(stackCalls) {
+        // function without parameters and local variables runs in the frame of its caller
+        functionFrame = params.nodeSize > 0 || usesLocalVariable(body);
+        if(functionFrame && (!irEmit(function, IR_CREATEFRAME) || !irEmit(function, IR_PUSHFRAME))) {
+            return ERROR_INTERNAL;
+        }
+        // the last argument is on the top of the stack
+        for (unsigned i = params.nodeSize; i-- > 0;) {
+            irOperand_t param = irVariable(FRAME_LOCAL, strViewDynStr(params.data.elements[i].data.token->data.strval));
+            if(!irEmit(function, IR_DEFVAR, param) || !irEmit(function, IR_POPS, param)) {
+                return ERROR_INTERNAL;
+            }
+        }
+    } else {
+        // function returns None by default
+        irOperand_t returnValue = irVariable(FRAME_LOCAL, strViewString("%retval"));
+        if(!irEmit(function, IR_DEFVAR, returnValue) || !irEmit(function, IR_MOVE, returnValue, irNil())) {
+            return ERROR_INTERNAL;
+        }
     }
-    retval = numberToDynStr(temp, "LABEL $$bool%d\n", ifCounter);
+
+    retval = defineVariables(body, function_name, function);
     if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+        return retval;
     }
-    if(!dynStrAppendString(temp, "PUSHS bool@true\n")) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    functionParams = params;
+    if(hasTailCall(body, function_name)) {
+        // tail calls jump after the prologue
+        static unsigned entryCounter = 0;
+        functionEntry = numberedLabel("$entry", entryCounter++);
+        if(!irEmit(function, IR_LABEL, functionEntry)) {
+            return ERROR_INTERNAL;
+        }
     }
-    retval = numberToDynStr(temp, "JUMPIFEQS $if%d\n", ifCounter);
+
+    // process function body
+    retval = processCodeBlock(body, symTable, function_name, function);
     if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+        return retval;
     }
-    retval = numberToDynStr(temp, "JUMP $$nil%d\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
+
+    if(stackCalls && !irEmit(function, IR_PUSHS, irNil())) {
         return ERROR_INTERNAL;
     }
-    retval = numberToDynStr(temp, "LABEL $$string%d\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
+    return processFunctionExit(function);
+}
+
+/**
+ * Process self tail call, the arguments are evaluated on the stack, assigned to the parameters
+ * and the function continues from its entry in the same frame
+ * @param callElement tree element with the call of the function itself
+ * @param symTable symbol table
+ * @param context local scope function name
+ * @param function function unit where code is generated to
+ * @return execution status
+ */
+static int processTailCall(treeElement_t callElement, symTable_t* symTable, strView_t context,
+        irFunction_t* function) {
+    unsigned argc = callElement.nodeSize == 2 ? callElement.data.elements[1].nodeSize : 0;
+    if(argc != functionParams.nodeSize) {
+        return ERROR_SEMANTIC_ARGC;
+    }
+    // all the arguments are evaluated before any parameter changes
+    for (unsigned i = 0; i < argc; i++) {
+        bool pushToStack = true;
+        codeInstruction_t instruction = {.generated = false};
+        int retval = processExpression(callElement.data.elements[1].data.elements[i], &pushToStack, &instruction,
+                symTable, context, function);
+        if(retval) {
+            return retval;
+        }
+    }
+    for (unsigned i = argc; i-- > 0;) {
+        irOperand_t param = irVariable(FRAME_LOCAL,
+                strViewDynStr(functionParams.data.elements[i].data.token->data.strval));
+        if(!irEmit(function, IR_POPS, param)) {
+            return ERROR_INTERNAL;
+        }
+    }
+    return irEmit(function, IR_JUMP, functionEntry) ? ERROR_SUCCESS : ERROR_INTERNAL;
+}
+
+/**
+ * Process return statement, the value is stored to the return value of the function
+ * or pushed to the stack by the stack calling convention
+ * @param returnElement tree element with return statement
+ * @param symTable symbol table
+ * @param context local scope function name
+ * @param function function unit where code is generated to
+ * @return execution status
+ */
+static int processReturn(treeElement_t returnElement, symTable_t* symTable, strView_t context,
+        irFunction_t* function) {
+    if(returnIsTailCall(returnElement, context)) {
+        return processTailCall(unwrapExpression(returnElement.data.elements[0]), symTable, context, function);
+    }
+    if(returnElement.nodeSize == 1) {
+        irOperand_t returnValue = irVariable(FRAME_LOCAL, strViewString("%retval"));
+        // the value stays on the stack by the stack calling convention
+        bool pushToStack = stackCalls;
+        codeInstruction_t instruction = {.generated = false};
+        int retval = processExpression(returnElement.data.elements[0], &pushToStack, &instruction, symTable,
+                context, function);
+        if(!retval && !stackCalls) {
+            retval = pushToStack ? (irEmit(function, IR_POPS, returnValue) ? ERROR_SUCCESS : ERROR_INTERNAL)
+                    : emitInstruction(function, &instruction, returnValue);
+        }
+        if(retval) {
+            return retval;
+        }
+    } else if(stackCalls && !irEmit(function, IR_PUSHS, irNil())) {
         return ERROR_INTERNAL;
     }
-    if(!dynStrAppendString(temp, "PUSHS string@\n")) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+    return processFunctionExit(function);
+}
+
+int processCodeBlock(treeElement_t codeBlockElement, symTable_t* symTable, strView_t context, irFunction_t* function) {
+
+    if(codeBlockElement.type != E_CODE_BLOCK) {
+        return ERROR_SEMANTIC_OTHER;
+    }
+
+    // BLOCK START
+
+    for(unsigned i = 0; i < codeBlockElement.nodeSize; i++) {
+
+        int retval = ERROR_SUCCESS;
+        bool pushToStack = false;
+        // result of the expression statement is not used
+        codeInstruction_t instruction = {.generated = false};
+
+        switch (codeBlockElement.data.elements[i].type) {
+            case E_S_EXPRESSION:
+                retval = processExpression(codeBlockElement.data.elements[i], &pushToStack, &instruction, symTable,
+                        context, function);
+                if(!retval && instruction.generated && instruction.instruction.opcode == IR_POPS) {
+                    // drop the return value left on the stack
+                    retval = emitInstruction(function, &instruction, helperVariable(HELPER_RESULT));
+                }
+                break;
+            case E_ASSIGN:
+                retval = processAssign(codeBlockElement.data.elements[i], symTable, context, function);
+                break;
+            case E_S_IF:
+                retval = processIf(codeBlockElement.data.elements[i], symTable, context, function);
+                break;
+            case E_S_WHILE:
+                retval = processWhile(codeBlockElement.data.elements[i], symTable, context, function);
+                break;
+            case E_S_RETURN:
+                retval = processReturn(codeBlockElement.data.elements[i], symTable, context, function);
+                break;
+            case E_S_PASS:
+                break;
+            default:
+                return ERROR_SEMANTIC_OTHER;
+        }
+        if(retval)
+            return retval;
+    }
+
+    // BLOCK END
+
+    return ERROR_SUCCESS;
+}
+
+int processExpression(treeElement_t expElement, bool* pushToStack, codeInstruction_t* instruction,
+        symTable_t* symTable, strView_t context, irFunction_t* function) {
+
+    if(expElement.type != E_S_EXPRESSION) {
+        return ERROR_SEMANTIC_OTHER;
+    }
+
+    int retval = ERROR_SUCCESS;
+    treeElement_t element = expElement.data.elements[0];
+    irOperand_t operand;
+
+    switch (element.type) {
+        case E_TOKEN:
+            retval = processEToken(element, &operand, false, NULL);
+            if(retval) {
+                return ERROR_INTERNAL;
+            }
+            if(*pushToStack) {
+                if(!irEmit(function, IR_PUSHS, operand)) {
+                    return ERROR_INTERNAL;
+                }
+                break;
+            }
+            // add move operation if not pushing, destination is added in calling function
+            instruction->generated = true;
+            instruction->instruction.opcode = IR_MOVE;
+            instruction->instruction.operands[1] = operand;
+            break;
+        case E_S_EXPRESSION:
+            retval = processExpression(element, pushToStack, instruction, symTable, context, function);
+            break;
+        case E_ADD:
+        case E_SUB:
+        case E_MUL:
+        case E_DIV:
+        case E_DIV_INT:
+        case E_AND:
+        case E_OR:
+        case E_EQ:
+        case E_NEQ:
+        case E_GT:
+        case E_GTE:
+        case E_LT:
+        case E_LTE:
+            retval = processBinaryOperation(element, pushToStack, instruction, symTable, context, function);
+            break;
+        case E_NOT:
+            retval = processUnaryOperation(element, pushToStack, instruction, symTable, context, function);
+            break;
+        case E_S_FUNCTION_CALL:
+            retval = processCallValue(element, *pushToStack, instruction, symTable, context, function);
+            break;
+        case E_ASSIGN:
+            retval = processAssign(element, symTable, context, function);
+            break;
+        default:
+            return ERROR_SEMANTIC_OTHER;
+    }
+
+    return retval;
+}
+
+int processBinaryOperation(treeElement_t operationElement, bool* pushToStack, codeInstruction_t* instruction,
+        symTable_t* symTable, strView_t context, irFunction_t* function) {
+
+    if (operationElement.nodeSize != 2) {
+        return ERROR_SEMANTIC_OTHER;
     }
-    retval = numberToDynStr(temp, "JUMPIFNEQS $if%d\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    if (operationElement.type == E_AND || operationElement.type == E_OR) {
+        *pushToStack = true;
+        return processLogicalOperation(operationElement, symTable, context, function);
     }
-    retval = numberToDynStr(temp, "LABEL $$nil%d\n", ifCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    int retval = ERROR_SUCCESS;
+
+    // negated comparisons are computed by two instructions on the stack
+    bool negated = operationElement.type == E_NEQ || operationElement.type == E_GTE || operationElement.type == E_LTE;
+
+    if (operationElement.data.elements[0].type != E_TOKEN ||
+        operationElement.data.elements[1].type != E_TOKEN || negated) {
+        *pushToStack = true;
     }
 
-    // add to code list
-    retval = !dynStrListPushBack(codeStrList, temp);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+    // int operands mixed with float ones are converted on the stack when their types are known
+    bool convert[2];
+    for (int i = 0; i < 2; i++) {
+        convert[i] = typeIsConverted(operationElement.type, operationElement.data.elements[i].valueTypes,
+                operationElement.data.elements[1 - i].valueTypes);
+        if (convert[i]) {
+            *pushToStack = true;
+        }
     }
 
-    // fall through to else
+    irOperand_t operands[2];
 
-    // else body
-    if(ifElement.nodeSize > 2) {
-        retval = processElse(ifElement.data.elements[2], symTable, context, codeStrList);
-        if(retval){
+    // extract data in order (first operand is pushed to stack first)
+    for (int i = 0; i < 2; i++) {
+        retval = processOperand(operationElement.data.elements[i], convert[i], pushToStack, instruction, &operands[i],
+                symTable, context, function);
+        if (retval) {
             return retval;
         }
     }
 
-    temp = dynStrInit();
-    retval = numberToDynStr(temp, "JUMP $fi%d\n", ifCounter);
-
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+    // determine operation and its stack version
+    irOpcode_t opcode;
+    irOpcode_t stackOpcode;
+    switch (operationElement.type) {
+        case E_ADD:
+            opcode = IR_ADD;
+            stackOpcode = IR_ADDS;
+            break;
+        case E_SUB:
+            opcode = IR_SUB;
+            stackOpcode = IR_SUBS;
+            break;
+        case E_MUL:
+            opcode = IR_MUL;
+            stackOpcode = IR_MULS;
+            break;
+        case E_DIV:
+            opcode = IR_DIV;
+            stackOpcode = IR_DIVS;
+            break;
+        case E_DIV_INT:
+            opcode = IR_IDIV;
+            stackOpcode = IR_IDIVS;
+            break;
+        case E_AND:
+            opcode = IR_AND;
+            stackOpcode = IR_ANDS;
+            break;
+        case E_OR:
+            opcode = IR_OR;
+            stackOpcode = IR_ORS;
+            break;
+        case E_EQ:
+        case E_NEQ: // not (a == b)
+            opcode = IR_EQ;
+            stackOpcode = IR_EQS;
+            break;
+        case E_LT:
+        case E_GTE: // not (a < b)
+            opcode = IR_LT;
+            stackOpcode = IR_LTS;
+            break;
+        case E_GT:
+        case E_LTE: // not (a > b)
+            opcode = IR_GT;
+            stackOpcode = IR_GTS;
+            break;
+        default:
+            return ERROR_SEMANTIC_OTHER;
     }
-    // add to code list
-    retval = !dynStrListPushBack(codeStrList, temp);
-    if(retval){
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    if(*pushToStack) {
+        if(!irEmit(function, stackOpcode) || (negated && !irEmit(function, IR_NOTS))) {
+            return ERROR_INTERNAL;
+        }
+        return ERROR_SUCCESS;
     }
 
-    // next string have same size
+    // if value is not pushed, var name is added to operation in calling function
+    instruction->generated = true;
+    instruction->instruction.opcode = opcode;
+    instruction->instruction.operands[1] = operands[0];
+    instruction->instruction.operands[2] = operands[1];
 
-    // add jump to fi
-    temp = dynStrInit();
-    retval = numberToDynStr(temp, "JUMP $fi%d\n", ifCounter);
+    return ERROR_SUCCESS;
+}
 
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    // add to code list
-    retval = !dynStrListPushBack(codeStrList, temp);
-    if(retval){
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+int processUnaryOperation(treeElement_t operationElement, bool* pushToStack, codeInstruction_t* instruction,
+        symTable_t* symTable, strView_t context, irFunction_t* function){
+
+    if(operationElement.nodeSize != 1) {
+        return ERROR_SEMANTIC_OTHER;
     }
 
-    // add if label
-    temp = dynStrInit();
-    retval = numberToDynStr(temp, "LABEL $if%d\n", ifCounter);
+    int retval = ERROR_SUCCESS;
 
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    // add to code list
-    retval = !dynStrListPushBack(codeStrList, temp);
-    if(retval){
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
+    irOperand_t operand;
 
-    // if body
-    retval = processCodeBlock(ifElement.data.elements[1], symTable, context, codeStrList);
+    // operations are pushed to the stack
+    if(operationElement.data.elements[0].type != E_TOKEN) {
+        *pushToStack = true;
+    }
+    retval = processOperand(operationElement.data.elements[0], false, pushToStack, instruction, &operand, symTable,
+            context, function);
     if(retval) {
         return retval;
     }
 
-    // add fi (end of if-else)
-    temp = dynStrInit();
-    retval = numberToDynStr(temp, "LABEL $fi%d\n", ifCounter);
-
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+    if(operationElement.type != E_NOT) {
+        return ERROR_SEMANTIC_OTHER;
     }
-    // add to code list
-    retval = !dynStrListPushBack(codeStrList, temp);
-    if(retval){
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    if(*pushToStack) {
+        if(!irEmit(function, IR_NOTS)) {
+            return ERROR_INTERNAL;
+        }
+        return ERROR_SUCCESS;
     }
 
-    ifCounter++;
+    // var name is added to operation in calling function
+    instruction->generated = true;
+    instruction->instruction.opcode = IR_NOT;
+    instruction->instruction.operands[1] = operand;
 
     return ERROR_SUCCESS;
 }
 
-int numberToDynStr(dynStr_t* outputStr, char* formatString, long number) {
-    int retval; // return value
+int processCondition(treeElement_t condElement, bool jumpIfTrue, irOperand_t label, symTable_t* symTable,
+        strView_t context, irFunction_t* function) {
+    return processJump(condElement, jumpIfTrue, label, false, symTable, context, function);
+}
 
-    // get size of string
-    unsigned strSize = snprintf(NULL, 0, formatString, number);
-    char* buffer = malloc(++strSize); // + \0
-    // check allocation
-    if(!buffer) {
-        return ERROR_INTERNAL;
+int processIf(treeElement_t ifElement, symTable_t* symTable, strView_t context, irFunction_t* function) {
+    if(ifElement.type != E_S_IF) {
+        return ERROR_SEMANTIC_OTHER;
     }
 
-    // print string to buffer
-    snprintf(buffer, strSize, formatString, number);
+    // used to make labels unique
+    static unsigned ifCounter = 0;
 
-    // append buffer to dynamic string
-    retval = !dynStrAppendString(outputStr, buffer);
-    free(buffer);
-    if(retval) {
-        return ERROR_INTERNAL;
+    int retval = ERROR_SUCCESS; // return value
+    // nested if statements are processed before the labels of this one are emitted
+    unsigned counter = ifCounter++;
+
+    if(conditionIsLowered(ifElement.data.elements[0])) {
+        // condition type is known, no type dispatch is needed
+        retval = processCondition(ifElement.data.elements[0], true, numberedLabel("$if", counter), symTable,
+                context, function);
+        if(retval) {
+            return retval;
+        }
+    } else {
+        bool pushToStack = true;
+        codeInstruction_t instruction = {.generated = false};
+
+        // expression
+        retval = processExpression(ifElement.data.elements[0], &pushToStack, &instruction, symTable, context,
+                function);
+        if(retval){
+            return retval;
+        }
+
+        // add if body
+        irOperand_t tempIf = helperVariable(HELPER_TEMP_IF);
+        irOperand_t tempIfType = helperVariable(HELPER_TEMP_IF_TYPE);
+        if(!irEmit(function, IR_POPS, tempIf)
+        || !irEmit(function, IR_TYPE, tempIfType, tempIf)
+        || !irEmit(function, IR_PUSHS, tempIf)
+        || !irEmit(function, IR_JUMPIFEQ, numberedLabel("$$float", counter), tempIfType, stringConstant("float"))
+        || !irEmit(function, IR_JUMPIFEQ, numberedLabel("$$int", counter), tempIfType, stringConstant("int"))
+        || !irEmit(function, IR_JUMPIFEQ, numberedLabel("$$bool", counter), tempIfType, stringConstant("bool"))
+        || !irEmit(function, IR_JUMPIFEQ, numberedLabel("$$string", counter), tempIfType, stringConstant("string"))
+        || !irEmit(function, IR_JUMPIFEQ, numberedLabel("$$nil", counter), tempIfType, stringConstant("nil"))
+        || !irEmit(function, IR_EXIT, irInt(4))
+        || !irEmit(function, IR_LABEL, numberedLabel("$$float", counter))
+        || !irEmit(function, IR_PUSHS, irFloat(0.0))
+        || !irEmit(function, IR_JUMPIFNEQS, numberedLabel("$if", counter))
+        || !irEmit(function, IR_JUMP, numberedLabel("$$nil", counter))
+        || !irEmit(function, IR_LABEL, numberedLabel("$$int", counter))
+        || !irEmit(function, IR_PUSHS, irInt(0))
+        || !irEmit(function, IR_JUMPIFNEQS, numberedLabel("$if", counter))
+        || !irEmit(function, IR_JUMP, numberedLabel("$$nil", counter))
+        || !irEmit(function, IR_LABEL, numberedLabel("$$bool", counter))
+        || !irEmit(function, IR_PUSHS, irBool(true))
+        || !irEmit(function, IR_JUMPIFEQS, numberedLabel("$if", counter))
+        || !irEmit(function, IR_JUMP, numberedLabel("$$nil", counter))
+        || !irEmit(function, IR_LABEL, numberedLabel("$$string", counter))
+        || !irEmit(function, IR_PUSHS, stringConstant(""))
+        || !irEmit(function, IR_JUMPIFNEQS, numberedLabel("$if", counter))
+        || !irEmit(function, IR_LABEL, numberedLabel("$$nil", counter))) {
+            return ERROR_INTERNAL;
+        }
     }
 
-    return retval; // ERROR_SUCCESS == 0, ERROR_INTERNAL == 99
-}
+    // fall through to else
 
-int floatToDynStr(dynStr_t* outputStr, char* formatString, double number) {
-    int retval; // return value
+    // else body
+    if(ifElement.nodeSize > 2) {
+        retval = processElse(ifElement.data.elements[2], symTable, context, function);
+        if(retval){
+            return retval;
+        }
+    }
 
-    // get size of string
-    unsigned strSize = snprintf(NULL, 0, formatString, number);
-    char* buffer = malloc(++strSize); // + \0
-    // check allocation
-    if(!buffer) {
+    // add jump to fi (twice) and if label
+    if(!irEmit(function, IR_JUMP, numberedLabel("$fi", counter))
+    || !irEmit(function, IR_JUMP, numberedLabel("$fi", counter))
+    || !irEmit(function, IR_LABEL, numberedLabel("$if", counter))) {
         return ERROR_INTERNAL;
     }
 
-    // print string to buffer
-    snprintf(buffer, strSize, formatString, number);
-
-    // append buffer to dynamic string
-    retval = !dynStrAppendString(outputStr, buffer);
-    free(buffer);
+    // if body
+    retval = processCodeBlock(ifElement.data.elements[1], symTable, context, function);
     if(retval) {
+        return retval;
+    }
+
+    // add fi (end of if-else)
+    if(!irEmit(function, IR_LABEL, numberedLabel("$fi", counter))) {
         return ERROR_INTERNAL;
     }
 
-    return retval; // ERROR_SUCCESS == 0, ERROR_INTERNAL == 99
+    return ERROR_SUCCESS;
 }
 
-int processElse(treeElement_t elseElement, symTable_t* symTable, dynStr_t* context, dynStrList_t* codeStrList) {
+int processElse(treeElement_t elseElement, symTable_t* symTable, strView_t context, irFunction_t* function) {
     if(elseElement.type != E_S_ELSE) {
         return ERROR_SEMANTIC_OTHER;
     }
@@ -994,12 +1628,12 @@ int processElse(treeElement_t elseElement, symTable_t* symTable, dynStr_t* conte
 
     int retval = ERROR_SUCCESS;
 
-    retval = processCodeBlock(elseElement.data.elements[0], symTable, context, codeStrList);
+    retval = processCodeBlock(elseElement.data.elements[0], symTable, context, function);
 
     return retval;
 }
 
-int processAssign(treeElement_t assignElement, symTable_t* symTable, dynStr_t* context, dynStrList_t* codeStrList) {
+int processAssign(treeElement_t assignElement, symTable_t* symTable, strView_t context, irFunction_t* function) {
     if(assignElement.type != E_ASSIGN) {
         return  ERROR_SEMANTIC_OTHER;
     }
@@ -1013,11 +1647,9 @@ int processAssign(treeElement_t assignElement, symTable_t* symTable, dynStr_t* c
         return ERROR_SEMANTIC_OTHER;
     }
 
-    dynStr_t* temp; // temporary stores the line of code
-
-    dynStr_t* varName; // temporary stores variable name
+    irOperand_t variable; // assigned variable
 
-    dynStr_t* varDef; // temporary stores variable definition
+    codeInstruction_t instruction = {.generated = false}; // assignment without destination
 
     int retval = ERROR_SUCCESS; // return code
 
@@ -1027,178 +1659,52 @@ int processAssign(treeElement_t assignElement, symTable_t* symTable, dynStr_t* c
 
     switch (assignElement.data.elements[1].type) {
         case E_S_EXPRESSION: // func call/expression ( l = f() | l = a + b)
-            retval = processExpression(assignElement.data.elements[1], &pushToStack, symTable, context, codeStrList);
+            retval = processExpression(assignElement.data.elements[1], &pushToStack, &instruction, symTable,
+                    context, function);
             if(retval) {
                 return retval;
             }
-            temp = dynStrInit();
-            if(pushToStack) { // pop from stack
-                if (!dynStrAppendString(temp, "POPS ")) {
-                    dynStrFree(temp);
-                    return ERROR_INTERNAL;
-                }
-            } else { // add binary operation from expression processing (last element of stack)
-                dynStr_t* lastStr = dynStrListElGet(dynStrListBack(codeStrList));
-                if(!dynStrAppendString(temp, dynStrGetString(lastStr))) {
-                    dynStrFree(temp);
-                    return ERROR_INTERNAL;
-                }
-                // remove operation from list
-                dynStrListPopBack(codeStrList);
-            }
             // get variable id
-            varName = dynStrInit();
-            retval = processEToken(assignElement.data.elements[0], varName, false, symTable, context, &varDefined);
+            retval = processEToken(assignElement.data.elements[0], &variable, false, &varDefined);
             if(retval) {
-                dynStrFree(temp);
                 return retval;
             }
-            if(!dynStrAppendString(temp, dynStrGetString(varName))) {
-                dynStrFree(temp);
-                dynStrFree(varName);
-                return ERROR_INTERNAL;
-            }
-            if(pushToStack) {
-                // add eol to pop
-                if (!dynStrAppendString(temp, "\n")) {
-                    dynStrFree(temp);
-                    dynStrFree(varName);
-                    return ERROR_INTERNAL;
-                }
-            } else {
-                if(!dynStrAppendString(temp, " ")) {
-                    dynStrFree(temp);
-                    dynStrFree(varName);
-                    return ERROR_INTERNAL;
-                }
-                // add operands to binary operation
-                dynStr_t* lastStr = dynStrListElGet(dynStrListBack(codeStrList));
-                if(!dynStrAppendString(temp, dynStrGetString(lastStr))) {
-                    dynStrFree(temp);
-                    dynStrFree(varName);
-                    return ERROR_INTERNAL;
-                }
-                // remove operands from list
-                dynStrListPopBack(codeStrList);
-            }
-            // add definition
-            if(!varDefined) {
-                varDef = dynStrInit();
-                if(!dynStrAppendString(varDef, "DEFVAR ")) {
-                    dynStrFree(temp);
-                    dynStrFree(varName);
-                    dynStrFree(varDef);
-                    return ERROR_INTERNAL;
-                }
-                // append var name
-                if(!dynStrAppendString(varDef, dynStrGetString(varName))) {
-                    dynStrFree(temp);
-                    dynStrFree(varName);
-                    dynStrFree(varDef);
-                    return ERROR_INTERNAL;
-                }
-                // append eol
-                if(!dynStrAppendString(varDef, "\n")) {
-                    dynStrFree(temp);
-                    dynStrFree(varName);
-                    dynStrFree(varDef);
-                    return ERROR_INTERNAL;
-                }
-                // add to list
-                if(!dynStrListPushBack(codeStrList, varDef)) {
-                    dynStrFree(temp);
-                    dynStrFree(varName);
-                    dynStrFree(varDef);
-                    return ERROR_INTERNAL;
-                }
-            }
-            // free temp variable with name
-            dynStrFree(varName);
             break;
         case E_TOKEN: // value or id ( l = r )
-            temp = dynStrInit();
-            if(!dynStrAppendString(temp, "MOVE ")){
-                dynStrFree(temp);
-                return ERROR_INTERNAL;
-            }
-
             // process left side
-            varName = dynStrInit();
-            retval = processEToken(assignElement.data.elements[0], varName, false, symTable, context, &varDefined);
+            retval = processEToken(assignElement.data.elements[0], &variable, false, &varDefined);
             if(retval) {
-                dynStrFree(temp);
                 return retval;
             }
-            if(!dynStrAppendString(temp, dynStrGetString(varName))) {
-                dynStrFree(temp);
-                dynStrFree(varName);
-                return ERROR_INTERNAL;
-            }
-            if(!dynStrAppendString(temp, " ")) {
-                dynStrFree(temp);
-                dynStrFree(varName);
-                return ERROR_INTERNAL;
-            }
             // process right side
-            retval = processEToken(assignElement.data.elements[1], temp, false, symTable, context, NULL);
+            instruction.generated = true;
+            instruction.instruction.opcode = IR_MOVE;
+            retval = processEToken(assignElement.data.elements[1], &instruction.instruction.operands[1], false, NULL);
             if(retval) {
-                dynStrFree(temp);
-                dynStrFree(varName);
                 return retval;
             }
-            // add eol
-            if(!dynStrAppendString(temp, "\n")){
-                dynStrFree(temp);
-                dynStrFree(varName);
-                return ERROR_INTERNAL;
-            }
-            // add definition
-            if(!varDefined) {
-                varDef = dynStrInit();
-                if(!dynStrAppendString(varDef, "DEFVAR ")) {
-                    dynStrFree(temp);
-                    dynStrFree(varName);
-                    dynStrFree(varDef);
-                    return ERROR_INTERNAL;
-                }
-                // append var name
-                if(!dynStrAppendString(varDef, dynStrGetString(varName))) {
-                    dynStrFree(temp);
-                    dynStrFree(varName);
-                    dynStrFree(varDef);
-                    return ERROR_INTERNAL;
-                }
-                // append eol
-                if(!dynStrAppendString(varDef, "\n")) {
-                    dynStrFree(temp);
-                    dynStrFree(varName);
-                    dynStrFree(varDef);
-                    return ERROR_INTERNAL;
-                }
-                // add to list
-                if(!dynStrListPushBack(codeStrList, varDef)) {
-                    dynStrFree(temp);
-                    dynStrFree(varName);
-                    dynStrFree(varDef);
-                    return ERROR_INTERNAL;
-                }
-            }
-            // free name
-            dynStrFree(varName);
             break;
         default:
             return ERROR_SEMANTIC_OTHER;
     }
-    // add temp to list
-    if(!dynStrListPushBack(codeStrList, temp)) {
-        dynStrFree(temp);
+
+    // add definition
+    if(!varDefined && !irEmit(function, IR_DEFVAR, variable)) {
         return ERROR_INTERNAL;
     }
 
-    return retval;
+    if(pushToStack) { // pop from stack
+        if(!irEmit(function, IR_POPS, variable)) {
+            return ERROR_INTERNAL;
+        }
+        return ERROR_SUCCESS;
+    }
+
+    // add operation from expression processing
+    return emitInstruction(function, &instruction, variable);
 }
 
-int processFunctionCall(treeElement_t callElement, symTable_t* symTable, dynStr_t* context, dynStrList_t* codeStrList) {
+int processFunctionCall(treeElement_t callElement, symTable_t* symTable, strView_t context, irFunction_t* function) {
     if(callElement.type != E_S_FUNCTION_CALL) {
         return ERROR_SEMANTIC_OTHER;
     }
@@ -1207,268 +1713,412 @@ int processFunctionCall(treeElement_t callElement, symTable_t* symTable, dynStr_
         return ERROR_SEMANTIC_OTHER;
     }
 
-    int retval;
-
-    // function name
-    dynStr_t* fname = dynStrInit();
-    retval = processEToken(callElement.data.elements[0], fname, true, symTable, context, NULL);
-    if(retval) {
-        dynStrFree(fname);
-        return retval;
-    }
-	dynStr_t* temp = dynStrInit();
+    int retval = ERROR_SUCCESS;
 
-    // add create frame
-    if(!dynStrAppendString(temp, "CREATEFRAME\n")) {
-        dynStrFree(fname);
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    // add to list
-    if(!dynStrListPushBack(codeStrList, temp)) {
-        dynStrFree(fname);
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+    // function name (borrowed from the token)
+    treeElement_t nameElement = callElement.data.elements[0];
+    if(nameElement.type != E_TOKEN || nameElement.data.token->type != T_ID) {
+        return ERROR_SEMANTIC_OTHER;
     }
+    strView_t fname = strViewDynStr(nameElement.data.token->data.strval);
 
-    // TODO
-    //  remove temporary frame and hardcode it in processFunctionCallParams?
-
-	if (dynStrEqualString(fname, "print")) {
-		long argc = callElement.nodeSize == 1 ? 0 : callElement.data.elements[1].nodeSize;
-		dynStrList_t *printArgs = dynStrListInit();
-		dynStr_t *string = dynStrInitString("PUSHS ");
-		int retVal = numberToDynStr(string, "int@%ld", argc);
-		if (retVal) {
-			return retVal;
-		}
-		if (!dynStrListPushBack(printArgs, string)) {
-			dynStrListFree(printArgs);
-			dynStrFree(string);
+	if (strViewEqualString(fname, "print")) {
+		if (!irEmit(function, IR_CREATEFRAME)) {
 			return ERROR_INTERNAL;
 		}
+		long argc = callElement.nodeSize == 1 ? 0 : callElement.data.elements[1].nodeSize;
+		// arguments are pushed in reverse order, the argument count is on the top of the stack
+		irPosition_t printArgs = irFunctionPosition(function);
 		bool pushToStack = true;
+		codeInstruction_t instruction = {.generated = false};
 		for (long i = 0; i < argc; ++i) {
-			retVal = processExpression(callElement.data.elements[1].data.elements[i], &pushToStack, symTable, context, printArgs);
+			int retVal = processExpression(callElement.data.elements[1].data.elements[i], &pushToStack, &instruction,
+					symTable, context, function);
 			if (retVal) {
-				dynStrListFree(printArgs);
+				irFunctionTruncate(function, printArgs);
 				return retval;
 			}
 		}
-		for (long i = argc; i >= 0; --i) {
-			dynStrListEl_t *element = dynStrListBack(printArgs);
-			dynStrListPushBack(codeStrList, dynStrClone(dynStrListElGet(element)));
-			dynStrListPopBack(printArgs);
-		}
-		dynStrListFree(printArgs);
-		string = dynStrInitString("\n");
-		if (!dynStrListPushBack(codeStrList, string)) {
-			dynStrFree(string);
+		// single argument is already in order, even if its evaluation has more instructions
+		if ((argc > 1 && !irFunctionReverse(function, printArgs)) || !irEmit(function, IR_PUSHS, irInt(argc))) {
 			return ERROR_INTERNAL;
 		}
+	} else if (callUsesStack(fname)) {
+		// arguments are pushed in order, the function creates its frame itself
+		for (unsigned i = 0; callElement.nodeSize == 2 && i < callElement.data.elements[1].nodeSize; i++) {
+			bool pushToStack = true;
+			codeInstruction_t instruction = {.generated = false};
+			retval = processExpression(callElement.data.elements[1].data.elements[i], &pushToStack, &instruction,
+					symTable, context, function);
+			if (retval) {
+				return retval;
+			}
+		}
+		return irEmit(function, IR_CALL, irLabel(fname, -1)) ? ERROR_SUCCESS : ERROR_INTERNAL;
 	} else if (callElement.nodeSize == 2) { // create frame and process params
-	    retval = processFunctionCallParams(callElement.data.elements[1], symTable, fname, codeStrList);
+	    retval = processFunctionCallParams(callElement.data.elements[1], fname, symTable, context, function);
 	    if (retval) {
 		    return retval;
 	    }
+    } else if(!irEmit(function, IR_CREATEFRAME)) {
+        return ERROR_INTERNAL;
     }
 
-    // add pushframe
-    temp = dynStrInitString("PUSHFRAME\n");
-    if(temp == NULL) {
-        dynStrFree(fname);
+    // add pushframe, call the function and pop frame
+    if(!irEmit(function, IR_PUSHFRAME)
+    || !irEmit(function, IR_CALL, irLabel(fname, -1))
+    || !irEmit(function, IR_POPFRAME)) {
         return ERROR_INTERNAL;
     }
-    // add to list
-    if(!dynStrListPushBack(codeStrList, temp)) {
-        dynStrFree(fname);
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    return ERROR_SUCCESS;
+}
+
+int processFunctionCallParams(treeElement_t callParamsElement, strView_t fname, symTable_t* symTable,
+        strView_t context, irFunction_t* function) {
+    if(callParamsElement.type != E_S_FUNCTION_CALL_PARAMS) {
+        return ERROR_SEMANTIC_OTHER;
+    }
+
+    treeElement_t* args = callParamsElement.data.elements;
+    bool hasCall = false;
+    for(unsigned i = 0; i < callParamsElement.nodeSize; i++) {
+        hasCall = hasCall || expressionHasCall(args[i]);
     }
 
-    // call the function
-    temp = dynStrInitString("CALL ");
-    if(temp == NULL) {
-        dynStrFree(fname);
+    // arguments are evaluated before the frame is created, calls in them create their own frames
+    for(unsigned i = 0; i < callParamsElement.nodeSize; i++) {
+        if(!argumentIsEvaluated(args[i], hasCall)) {
+            continue;
+        }
+        bool pushToStack = true;
+        codeInstruction_t instruction = {.generated = false};
+        int retval = processExpression(args[i], &pushToStack, &instruction, symTable, context, function);
+        if(retval) {
+            return retval;
+        }
+    }
+    if(!irEmit(function, IR_CREATEFRAME)) {
         return ERROR_INTERNAL;
     }
-    // function name
-    if(!dynStrAppendString(temp, dynStrGetString(fname))){
-        dynStrFree(fname);
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    // the last evaluated argument is on the top of the stack
+    for(unsigned i = callParamsElement.nodeSize; i-- > 0;) {
+        // get argument variable name
+        strView_t argName = symTableGetArgumentName(symTable, fname, i);
+        // check if name exists
+        if(strViewIsNull(argName)) {
+            return ERROR_SEMANTIC_OTHER;
+        }
+        irOperand_t argument = irVariable(FRAME_TEMP, argName);
+        if(!irEmit(function, IR_DEFVAR, argument)) {
+            return ERROR_INTERNAL;
+        }
+        if(argumentIsEvaluated(args[i], hasCall)) {
+            if(!irEmit(function, IR_POPS, argument)) {
+                return ERROR_INTERNAL;
+            }
+            continue;
+        }
+        irOperand_t value;
+        int retval = processEToken(unwrapExpression(args[i]), &value, false, NULL);
+        if(retval) {
+            return retval;
+        }
+        if(!irEmit(function, IR_MOVE, argument, value)) {
+            return ERROR_INTERNAL;
+        }
+    } // for
+
+    return ERROR_SUCCESS;
+}
+
+/**
+ * Check if the program calls the function
+ * @param program program to scan
+ * @param name function name
+ * @return is there a call of the function?
+ */
+static bool programCalls(const irProgram_t* program, const char* name) {
+    for (const irFunction_t* function = program->first; function != NULL; function = function->next) {
+        for (const irBlock_t* block = function->first; block != NULL; block = block->next) {
+            for (size_t i = 0; i < block->count; i++) {
+                const irInstruction_t* instruction = &block->instructions[i];
+                if(instruction->opcode == IR_CALL
+                && strViewEqualString(instruction->operands[0].data.label.name, name)) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+int generateEmbeddedFunctions(irProgram_t *program) {
+	// embedded functions and their generators
+	static const struct {
+		const char* name;
+		int (*generate)(irProgram_t*);
+	} embedded[] = {
+		{"ord", generateOrdFunction},
+		{"chr", generateChrFunction},
+		{"print", generatePrintFunction},
+		{"inputs", generateInputsFunction},
+		{"inputf", generateInputfFunction},
+		{"inputi", generateInputiFunction},
+		{"len", generateLenFunction},
+	};
+	int retVal = ERROR_SUCCESS;
+	for (size_t i = 0; i < sizeof(embedded) / sizeof(embedded[0]); ++i) {
+		// embedded functions do not call each other, one scan of the program is enough
+		if (programCalls(program, embedded[i].name) && (retVal = embedded[i].generate(program)) != ERROR_SUCCESS) {
+			return retVal;
+		}
+	}
+	return retVal;
+}
+
+/**
+ * Check if the code contains a while statement
+ * @param element tree element
+ * @return is there a loop?
+ */
+static bool hasWhile(treeElement_t element) {
+    if(element.type == E_TOKEN) {
+        return false;
+    }
+    if(element.type == E_S_WHILE) {
+        return true;
+    }
+    for (unsigned i = 0; i < element.nodeSize; i++) {
+        if(hasWhile(element.data.elements[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Check if the assigned value keeps the type of the condition variable of the versioned loop,
+ * the variable is of the specialized type when the value is evaluated
+ * @param value assigned value element
+ * @param symbol condition variable symbol
+ * @param type specialized type of the condition variable
+ * @return is the value of the specialized type?
+ */
+static bool valueKeepsType(treeElement_t value, const symbol_t* symbol, valueType_t type) {
+    value = unwrapExpression(value);
+    if(value.valueTypes == (unsigned int) type || (value.type == E_TOKEN && value.symbol == symbol)) {
+        return true;
+    }
+    // integer operations stay integer, float operations with integer operands stay float
+    bool typeOperation = value.type == E_ADD || value.type == E_SUB || value.type == E_MUL
+            || (type == VALUE_INT && value.type == E_DIV_INT) || (type == VALUE_FLOAT && value.type == E_DIV);
+    if((type != VALUE_INT && type != VALUE_FLOAT) || !typeOperation || value.nodeSize != 2) {
+        return false;
+    }
+    bool hasVariable = false;
+    for (unsigned i = 0; i < 2; i++) {
+        treeElement_t operand = unwrapExpression(value.data.elements[i]);
+        if(operand.type == E_TOKEN && operand.symbol == symbol) {
+            hasVariable = true;
+        } else if(operand.valueTypes == 0 || (operand.valueTypes & ~(VALUE_INT | (unsigned int) type)) != 0) {
+            return false;
+        }
+    }
+    // float operation of the integer operands would change the type
+    return hasVariable;
+}
+
+/**
+ * Check if an assignment in the loop body can change the type of the condition variable
+ * @param element tree element
+ * @param symbol condition variable symbol
+ * @param type specialized type of the condition variable
+ * @return can the type be changed?
+ */
+static bool loopChangesType(treeElement_t element, const symbol_t* symbol, valueType_t type) {
+    if(element.type == E_TOKEN) {
+        return false;
+    }
+    if(element.type == E_ASSIGN && element.nodeSize == 2 && element.data.elements[0].symbol == symbol) {
+        return !valueKeepsType(element.data.elements[1], symbol, type);
     }
-    dynStrFree(fname);
-    if(!dynStrAppendString(temp, "\n")) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+    for (unsigned i = 0; i < element.nodeSize; i++) {
+        if(loopChangesType(element.data.elements[i], symbol, type)) {
+            return true;
+        }
     }
-    if(!dynStrListPushBack(codeStrList, temp)) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+    return false;
+}
+
+/**
+ * Generate the copy of the innermost while loop on the condition variable of unknown type,
+ * the type is checked once on entry and the copy compares the variable directly with the false value
+ * of the type, it exits to the generic loop only if the body can change the type
+ * @param whileElement while statement element
+ * @param counter number of the while statement
+ * @param symTable symbol table
+ * @param context local scope function name
+ * @param function function unit where code is generated to
+ * @return execution status
+ */
+static int processVersionedWhile(treeElement_t whileElement, unsigned counter, symTable_t* symTable,
+        strView_t context, irFunction_t* function) {
+    static const struct {
+        valueType_t type;
+        const char* name;
+    } versions[] = {
+        {VALUE_INT, "int"},
+        {VALUE_FLOAT, "float"},
+        {VALUE_STRING, "string"},
+        {VALUE_BOOL, "bool"},
+    };
+
+    treeElement_t condElement = unwrapExpression(whileElement.data.elements[0]);
+    if(condElement.type != E_TOKEN || condElement.data.token->type != T_ID || condElement.symbol == NULL
+    || condElement.symbol->type != SYMBOL_VARIABLE || hasWhile(whileElement.data.elements[1])) {
+        return ERROR_SUCCESS;
+    }
+
+    // the most likely type of the variable is specialized
+    unsigned int types = condElement.valueTypes != 0 ? condElement.valueTypes : VALUE_UNKNOWN;
+    size_t version = 0;
+    while(version < sizeof(versions) / sizeof(versions[0]) && (types & versions[version].type) == 0) {
+        version++;
+    }
+    if(version == sizeof(versions) / sizeof(versions[0])) {
+        return ERROR_SUCCESS;
+    }
+
+    irOperand_t variable = irSymbol(condElement.symbol);
+    irOperand_t falseValue;
+    falseConstant(versions[version].type, &falseValue);
+    irOperand_t type = helperVariable(HELPER_TEMP_WHILE_TYPE);
+    irOperand_t versionLabel = numberedLabel("$versionWhile", counter);
+    bool guard = loopChangesType(whileElement.data.elements[1], condElement.symbol, versions[version].type);
+
+    // the guard on the type is a part of the loop only if the body can change it
+    if((guard && !irEmit(function, IR_LABEL, versionLabel))
+    || !irEmit(function, IR_TYPE, type, variable)
+    || !irEmit(function, IR_JUMPIFNEQ, numberedLabel("$while", counter), type,
+            stringConstant(versions[version].name))
+    || (!guard && !irEmit(function, IR_LABEL, versionLabel))
+    || !irEmit(function, IR_JUMPIFEQ, numberedLabel("$endWhile", counter), variable, falseValue)) {
+        return ERROR_INTERNAL;
+    }
+
+    int retval = processCodeBlock(whileElement.data.elements[1], symTable, context, function);
+    if(retval) {
+        return retval;
     }
+    return irEmit(function, IR_JUMP, versionLabel) ? ERROR_SUCCESS : ERROR_INTERNAL;
+}
 
-    // pop frame
-    temp = dynStrInitString("POPFRAME\n");
-    if(temp == NULL) {
-        return ERROR_INTERNAL;
+int processWhile(treeElement_t whileElement, symTable_t* symTable, strView_t context, irFunction_t* function) {
+    if (whileElement.type != E_S_WHILE) {
+        return ERROR_SEMANTIC_OTHER;
     }
-    if(!dynStrListPushBack(codeStrList, temp)) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
+
+    if (whileElement.nodeSize != 2) {
+        return ERROR_SEMANTIC_OTHER;
     }
 
+    // used to make labels unique
+    static unsigned whileCounter = 0;
 
-    //TODO
-    // this will be in expression processing:
-    // printf("PUSH %s@$retval\n", FRAME_NAME[current_frame]);
+    bool pushToStack = true;
+    codeInstruction_t instruction = {.generated = false};
 
-    return ERROR_SUCCESS;
-}
+    int retval = ERROR_SUCCESS;
 
-int processFunctionCallParams(treeElement_t callParamsElement, symTable_t* symTable,
-        dynStr_t* context, dynStrList_t* codeStrList) {
-    if(callParamsElement.type != E_S_FUNCTION_CALL_PARAMS) {
-        return ERROR_SEMANTIC_OTHER;
+    bool typeKnown = conditionIsLowered(whileElement.data.elements[0]);
+    irOperand_t tempWhile = typeKnown ? irNil() : helperVariable(HELPER_TEMP_WHILE);
+    irOperand_t tempWhileType = typeKnown ? irNil() : helperVariable(HELPER_TEMP_WHILE_TYPE);
+    unsigned counter = whileCounter++;
+
+    if(!typeKnown && loopVersioning) {
+        retval = processVersionedWhile(whileElement, counter, symTable, context, function);
+        if(retval) {
+            return retval;
+        }
     }
 
-    int retval = ERROR_SUCCESS;
+    // condition is evaluated on every iteration
+    if(!irEmit(function, IR_LABEL, numberedLabel("$while", counter))) {
+        return ERROR_INTERNAL;
+    }
 
-    dynStr_t* temp = NULL;
-    dynStr_t* argName = NULL;
-    // process arg[i]
-    for(unsigned i = 0; i < callParamsElement.nodeSize; i++) {
-        bool pushToStack = false;
-        if (dynStrEqualString(context, "len")) {
-        	pushToStack = true;
-        }
+    if(typeKnown) {
+        // condition type is known, no type dispatch is needed
+        retval = processCondition(whileElement.data.elements[0], false, numberedLabel("$endWhile", counter),
+                symTable, context, function);
+    } else {
+        retval = processExpression(whileElement.data.elements[0], &pushToStack, &instruction, symTable, context,
+                function);
+    }
+    if (retval) {
+        return retval;
+    }
 
-        //TODO
-        // process params and create assignment after loop (because of expressions and function calls)
+    if(!typeKnown && (!irEmit(function, IR_POPS, tempWhile)
+    || !irEmit(function, IR_TYPE, tempWhileType, tempWhile)
+    || !irEmit(function, IR_PUSHS, tempWhile)
+    || !irEmit(function, IR_JUMPIFEQ, numberedLabel("$$floatW", counter), tempWhileType, stringConstant("float"))
+    || !irEmit(function, IR_JUMPIFEQ, numberedLabel("$$intW", counter), tempWhileType, stringConstant("int"))
+    || !irEmit(function, IR_JUMPIFEQ, numberedLabel("$$boolW", counter), tempWhileType, stringConstant("bool"))
+    || !irEmit(function, IR_JUMPIFEQ, numberedLabel("$$stringW", counter), tempWhileType,
+            stringConstant("string"))
+    || !irEmit(function, IR_JUMPIFEQ, numberedLabel("$$nilW", counter), tempWhileType, stringConstant("nil"))
+    || !irEmit(function, IR_EXIT, irInt(4))
+    || !irEmit(function, IR_LABEL, numberedLabel("$$floatW", counter))
+    || !irEmit(function, IR_PUSHS, irFloat(0.0))
+    || !irEmit(function, IR_JUMPIFNEQS, numberedLabel("$startWhile", counter))
+    || !irEmit(function, IR_JUMP, numberedLabel("$endWhile", counter))
+    || !irEmit(function, IR_LABEL, numberedLabel("$$intW", counter))
+    || !irEmit(function, IR_PUSHS, irInt(0))
+    || !irEmit(function, IR_JUMPIFNEQS, numberedLabel("$startWhile", counter))
+    || !irEmit(function, IR_JUMP, numberedLabel("$endWhile", counter))
+    || !irEmit(function, IR_LABEL, numberedLabel("$$boolW", counter))
+    || !irEmit(function, IR_PUSHS, irBool(true))
+    || !irEmit(function, IR_JUMPIFEQS, numberedLabel("$startWhile", counter))
+    || !irEmit(function, IR_JUMP, numberedLabel("$endWhile", counter))
+    || !irEmit(function, IR_LABEL, numberedLabel("$$stringW", counter))
+    || !irEmit(function, IR_PUSHS, stringConstant(""))
+    || !irEmit(function, IR_JUMPIFNEQS, numberedLabel("$startWhile", counter))
+    || !irEmit(function, IR_LABEL, numberedLabel("$$nilW", counter))
+    || !irEmit(function, IR_JUMP, numberedLabel("$endWhile", counter))
+    || !irEmit(function, IR_LABEL, numberedLabel("$startWhile", counter)))) {
+        return ERROR_INTERNAL;
+    }
 
-        // get expression data
-        retval = processExpression(callParamsElement.data.elements[i], &pushToStack, symTable, context, codeStrList);
-        if(retval){
-            return retval;
-        }
-        // get argument variable name
-        argName = symTableGetArgumentName(symTable, context, i);
-        // check if name exists
-        if(!argName) {
-            return ERROR_SEMANTIC_OTHER;
-        }
-        // create data assignment
-        temp = dynStrInit();
-        // value is on stack
-        if(pushToStack) {
-            if(!dynStrAppendString(temp, "POPS ")){
-                dynStrFree(temp);
-                return ERROR_INTERNAL;
-            }
-            if(!dynStrAppendString(temp, "TF@")){
-                dynStrFree(temp);
-                return ERROR_INTERNAL;
-            }
-            if(!dynStrAppendString(temp, dynStrGetString(argName))) {
-                dynStrFree(temp);
-                return ERROR_INTERNAL;
-            }
-            if(!dynStrAppendString(temp, "\n")){
-                dynStrFree(temp);
-                return ERROR_INTERNAL;
-            }
-        }
-        // value is assigned directly to variable
-        else {
-            // get operation from list
-            dynStr_t* lastStr = dynStrListElGet(dynStrListBack(codeStrList));
-            if(!dynStrAppendString(temp, dynStrGetString(lastStr))) {
-                dynStrFree(temp);
-                return ERROR_INTERNAL;
-            }
-            // remove operation from list
-            dynStrListPopBack(codeStrList);
-            if(!dynStrAppendString(temp, "TF@")){
-                dynStrFree(temp);
-                return ERROR_INTERNAL;
-            }
-            if(!dynStrAppendString(temp, dynStrGetString(argName))) {
-                dynStrFree(temp);
-                return ERROR_INTERNAL;
-            }
-            if(!dynStrAppendString(temp, " ")) {
-                dynStrFree(temp);
-                return ERROR_INTERNAL;
-            }
-            // add operands
-            lastStr = dynStrListElGet(dynStrListBack(codeStrList));
-            if(!dynStrAppendString(temp, dynStrGetString(lastStr))) {
-                dynStrFree(temp);
-                return ERROR_INTERNAL;
-            }
-            // remove operands from list
-            dynStrListPopBack(codeStrList);
-        }
-        // add arg to list
-        if(!dynStrListPushBack(codeStrList, temp)) {
-            dynStrFree(temp);
-            return ERROR_INTERNAL;
-        }
+    // Process While body
+    retval = processCodeBlock(whileElement.data.elements[1], symTable, context, function);
+    if (retval) {
+        return retval;
+    }
 
-    } // for
+    // add jump to beginning and end
+    if(!irEmit(function, IR_JUMP, numberedLabel("$while", counter))
+    || !irEmit(function, IR_LABEL, numberedLabel("$endWhile", counter))) {
+        return ERROR_INTERNAL;
+    }
 
     return ERROR_SUCCESS;
 }
 
-int generateEmbeddedFunctions(dynStrList_t *codeStrList) {
-	int retVal = ERROR_SUCCESS;
-	if ((retVal = generateLenFunction(codeStrList)) != ERROR_SUCCESS) {
-		return retVal;
-	}
-	if ((retVal = generateInputiFunction(codeStrList)) != ERROR_SUCCESS) {
-		return retVal;
-	}
-	if ((retVal = generateInputfFunction(codeStrList)) != ERROR_SUCCESS) {
-		return retVal;
-	}
-	if ((retVal = generateInputsFunction(codeStrList)) != ERROR_SUCCESS) {
-		return retVal;
-	}
-	if ((retVal = generatePrintFunction(codeStrList)) != ERROR_SUCCESS) {
-		return retVal;
-	}
-	if ((retVal = generateChrFunction(codeStrList)) != ERROR_SUCCESS) {
-		return retVal;
-	}
-	if ((retVal = generateOrdFunction(codeStrList)) != ERROR_SUCCESS) {
-		return retVal;
-	}
-/*	if ((retVal = generateSubstrFunction(codeStrList)) != ERROR_SUCCESS) {
-		return retVal;
-	}*/
-	return retVal;
-}
-
-int generateLenFunction(dynStrList_t* codeStrList) {
-	dynStr_t *string = dynStrInit();
+int generateLenFunction(irProgram_t* program) {
 	const char* code = "LABEL len\n"
 					"DEFVAR LF@%retval\n"
 					"STRLEN LF@%retval LF@%0\n"
 					"RETURN\n";
-	if(!dynStrAppendString(string, code)){
-		dynStrFree(string);
-		return ERROR_INTERNAL;
-	}
-	if(!dynStrListPushFront(codeStrList, string)) {
-		dynStrFree(string);
+	if(irProgramAddCode(program, strViewString("len"), strViewString(code)) == NULL) {
 		return ERROR_INTERNAL;
 	}
 	return ERROR_SUCCESS;
-
 }
 
-int generatePrintFunction(dynStrList_t* codeStrList) {
-	dynStr_t *string = dynStrInit();
+int generatePrintFunction(irProgram_t* program) {
 	const char* code = "LABEL print\n"
 						"DEFVAR LF@%retval\n"
 						"MOVE LF@%retval nil@nil\n"
@@ -1498,327 +2148,57 @@ int generatePrintFunction(dynStrList_t* codeStrList) {
 						"LABEL $end\n"
 						"WRITE string@\\010\n"
 						"RETURN\n";
-	if(!dynStrAppendString(string, code)) {
-		dynStrFree(string);
-		return ERROR_INTERNAL;
-	}
-	if(!dynStrListPushFront(codeStrList, string)) {
-		dynStrFree(string);
+	if(irProgramAddCode(program, strViewString("print"), strViewString(code)) == NULL) {
 		return ERROR_INTERNAL;
 	}
 	return ERROR_SUCCESS;
 }
 
-int processWhile(treeElement_t whileElement, symTable_t* symTable, dynStr_t* context, dynStrList_t* codeStrList) {
-    if (whileElement.type != E_S_WHILE) {
-        return ERROR_SEMANTIC_OTHER;
-    }
-
-    if (whileElement.nodeSize != 2) {
-        return ERROR_SEMANTIC_OTHER;
-    }
-
-    // used to make labels unique
-    static unsigned whileCounter = 0;
-
-    bool pushToStack = true;
-
-    int retval = ERROR_SUCCESS;
-
-    retval = processExpression(whileElement.data.elements[0], &pushToStack, symTable, context, codeStrList);
-    if (retval) {
-        return retval;
-    }
-
-    dynStr_t *temp = dynStrInit();
-    if (!temp) {
-        return ERROR_INTERNAL;
-    }
-
-    // workaround because function call doesn't work
-    if(whileCounter == 0) {
-        // define variables on firs while processing
-        dynStr_t* tmp = dynStrInit();
-        if(!dynStrAppendString(tmp, "DEFVAR GF@$$tempWhile\n")) {
-            dynStrFree(tmp);
-            return ERROR_INTERNAL;
-        }
-        if(!dynStrAppendString(tmp, "DEFVAR GF@$$tempWhileType\n")) {
-            dynStrFree(tmp);
-            return ERROR_INTERNAL;
-        }
-        // add to code list
-        retval = !dynStrListPushBack(codeStrList, tmp);
-        if(retval) {
-            dynStrFree(tmp);
-            return ERROR_INTERNAL;
-        }
-    }
-
-	retval = numberToDynStr(temp, "LABEL $while%d\n", whileCounter);
-	if (retval) {
-		dynStrFree(temp);
-		return ERROR_INTERNAL;
-	}
-	// add to code list
-	retval = !dynStrListPushBack(codeStrList, temp);
-	if (retval) {
-		dynStrFree(temp);
-		return ERROR_INTERNAL;
-	}
-
-    // add while body
-    temp = dynStrInit();
-    if(!dynStrAppendString(temp, "POPS GF@$$tempWhile\n")) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    if(!dynStrAppendString(temp, "TYPE GF@$$tempWhileType GF@$$tempWhile\n")) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    if(!dynStrAppendString(temp, "PUSHS GF@$$tempWhile\n")) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "JUMPIFEQ $$floatW%d GF@$$tempWhileType string@float\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "JUMPIFEQ $$intW%d GF@$$tempWhileType string@int\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "JUMPIFEQ $$boolW%d GF@$$tempWhileType string@bool\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "JUMPIFEQ $$stringW%d GF@$$tempWhileType string@string\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "JUMPIFEQ $$nilW%d GF@$$tempWhileType string@nil\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    if(!dynStrAppendString(temp, "EXIT int@4\n")) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "LABEL $$floatW%d\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    if(!dynStrAppendString(temp, "PUSHS float@0x0p+0\n")) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "JUMPIFNEQS $startWhile%d\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "JUMP $endWhile%d\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "LABEL $$intW%d\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "PUSHS int@0\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "JUMPIFNEQS $startWhile%d\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "JUMP $endWhile%d\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "LABEL $$boolW%d\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    if(!dynStrAppendString(temp, "PUSHS bool@true\n")) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "JUMPIFEQS $whileStart%d\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "JUMP $endWhile%d\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "LABEL $$stringW%d\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    if(!dynStrAppendString(temp, "PUSHS string@\n")) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "JUMPIFNEQS $whileStart%d\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "LABEL $$nil%d\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = numberToDynStr(temp, "JUMP $endWhile%d\n", whileCounter);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-
-    // add to code list
-    retval = !dynStrListPushBack(codeStrList, temp);
-    if(retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-
-    //TODO
-    // add type detection
-
-    temp = dynStrInit();
-    retval = numberToDynStr(temp, "LABEL $startWhile%d\n", whileCounter);
-    if (retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    // add to cede list
-    retval = !dynStrListPushBack(codeStrList, temp);
-    if (retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-
-    // Process While body
-    retval = processCodeBlock(whileElement.data.elements[1], symTable, context, codeStrList);
-    if (retval) {
-        return retval;
-    }
-
-    // add jump to beginning
-    temp = dynStrInit();
-    retval = numberToDynStr(temp, "JUMP $while%d\n", whileCounter);
-    if (retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    // add to code list
-    retval = !dynStrListPushBack(codeStrList, temp);
-    if (retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-
-    // add end
-    temp = dynStrInit();
-    retval = numberToDynStr(temp, "LABEL $endWhile%d\n", whileCounter);
-    if (retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-    retval = !dynStrListPushBack(codeStrList, temp);
-    if (retval) {
-        dynStrFree(temp);
-        return ERROR_INTERNAL;
-    }
-
-    return ERROR_SUCCESS;
-}
-
-int generateInputiFunction(dynStrList_t* codeStrList) {
+int generateInputiFunction(irProgram_t* program) {
 	const char* code = "LABEL inputi\n"
 						"DEFVAR LF@%retval\n"
 						"READ LF@%retval int\n"
 						"RETURN\n";
-	dynStr_t *string = dynStrInitString(code);
-	if(string == NULL) {
-		return ERROR_INTERNAL;
-	}
-	if(!dynStrListPushFront(codeStrList, string)) {
-		dynStrFree(string);
+	if(irProgramAddCode(program, strViewString("inputi"), strViewString(code)) == NULL) {
 		return ERROR_INTERNAL;
 	}
 	return ERROR_SUCCESS;
 }
 
-int generateChrFunction(dynStrList_t* codeStrList) {
+int generateChrFunction(irProgram_t* program) {
 	const char* code = "LABEL chr\n"
 					   "DEFVAR LF@retval\n"
 					   "INT2CHAR LF@retval LF@%0\n"
 					   "RETURN\n";
-
-	dynStr_t *string = dynStrInitString(code);
-	if(string == NULL) {
-		return ERROR_INTERNAL;
-	}
-
-	if(!dynStrListPushFront(codeStrList, string)) {
-		dynStrFree(string);
+	if(irProgramAddCode(program, strViewString("chr"), strViewString(code)) == NULL) {
 		return ERROR_INTERNAL;
 	}
 	return ERROR_SUCCESS;
 }
 
-int generateInputfFunction(dynStrList_t* codeStrList) {
+int generateInputfFunction(irProgram_t* program) {
 	const char* code = "LABEL inputf\n"
 						"DEFVAR LF@%retval\n"
 						"READ LF@%retval float\n"
 						"RETURN\n";
-	dynStr_t *string = dynStrInitString(code);
-	if(string == NULL) {
-		return ERROR_INTERNAL;
-	}
-	if(!dynStrListPushFront(codeStrList, string)) {
-		dynStrFree(string);
+	if(irProgramAddCode(program, strViewString("inputf"), strViewString(code)) == NULL) {
 		return ERROR_INTERNAL;
 	}
 	return ERROR_SUCCESS;
 }
 
-int generateInputsFunction(dynStrList_t* codeStrList) {
+int generateInputsFunction(irProgram_t* program) {
 	const char* code = "LABEL inputs\n"
 						"DEFVAR LF@%retval\n"
 						"READ LF@%retval int\n"
 						"RETURN\n";
-	dynStr_t *string = dynStrInitString(code);
-	if(string == NULL) {
-		return ERROR_INTERNAL;
-	}
-	if(!dynStrListPushFront(codeStrList, string)) {
-		dynStrFree(string);
+	if(irProgramAddCode(program, strViewString("inputs"), strViewString(code)) == NULL) {
 		return ERROR_INTERNAL;
 	}
 	return ERROR_SUCCESS;
 }
 
-int generateCheckVariableType(dynStrList_t* codeStrList) {
+int generateCheckVariableType(irProgram_t* program) {
     const char* code = "LABEL $$checkType\n"
                        "DEFVAR LF@retval\n"
                        "DEFVAR LF@type1\n"
@@ -1834,18 +2214,13 @@ int generateCheckVariableType(dynStrList_t* codeStrList) {
                        "MOVE LF@retval bool@true\n"
                        "RETURN\n"
                        ;
-    dynStr_t *string = dynStrInitString(code);
-    if(string == NULL) {
-        return ERROR_INTERNAL;
-    }
-    if(!dynStrListPushFront(codeStrList, string)) {
-        dynStrFree(string);
+    if(irProgramAddCode(program, strViewString("$$checkType"), strViewString(code)) == NULL) {
         return ERROR_INTERNAL;
     }
     return ERROR_SUCCESS;
 }
 
-int generateChangeVariableType(dynStrList_t* codeStrList) {
+int generateChangeVariableType(irProgram_t* program) {
     const char *code = "LABEL $$changeType\n"
                        "DEFVAR LF@retval1\n"
                        "DEFVAR LF@retval2\n"
@@ -1936,18 +2311,13 @@ int generateChangeVariableType(dynStrList_t* codeStrList) {
                        "MOVE LF@retval1 LF@arg1\n"
                        "MOVE LF@retval2 LF@arg2\n"
                        "RETURN\n";
-    dynStr_t *string = dynStrInitString(code);
-    if(string == NULL) {
-        return ERROR_INTERNAL;
-    }
-    if(!dynStrListPushFront(codeStrList, string)) {
-        dynStrFree(string);
+    if(irProgramAddCode(program, strViewString("$$changeType"), strViewString(code)) == NULL) {
         return ERROR_INTERNAL;
     }
     return ERROR_SUCCESS;
 }
 
-int generateOrdFunction(dynStrList_t* codeStrList) {
+int generateOrdFunction(irProgram_t* program) {
 	const char* code = "LABEL ord\n"
 						"DEFVAR LF@%retval\n"
 						"MOVE LF@%retval nil@nil\n"
@@ -1969,18 +2339,13 @@ int generateOrdFunction(dynStrList_t* codeStrList) {
 						"STRI2INT LF@%retval LF@s LF@i\n"
 						"LABEL $ord$end\n"
 						"RETURN\n";
-	dynStr_t *string = dynStrInitString(code);
-	if(string == NULL) {
-		return ERROR_INTERNAL;
-	}
-	if(!dynStrListPushFront(codeStrList, string)) {
-		dynStrFree(string);
+	if(irProgramAddCode(program, strViewString("ord"), strViewString(code)) == NULL) {
 		return ERROR_INTERNAL;
 	}
 	return ERROR_SUCCESS;
 }
 
-int generateSubstrFunction(dynStrList_t* codeStrList) {
+int generateSubstrFunction(irProgram_t* program) {
 	const char* code = "LABEL substr\n"        // function label
 	                   "DEFVAR $length\n"
 	                   "STRLEN $length s\n"    // get string length
@@ -2021,12 +2386,7 @@ int generateSubstrFunction(dynStrList_t* codeStrList) {
 	                   "LABEL $retNone\n"      // return None
 	                   "MOVE LF@$retval nil@nil\n"
 	                   "RETURN\n";
-	dynStr_t *string = dynStrInitString(code);
-	if(string == NULL) {
-		return ERROR_INTERNAL;
-	}
-	if(!dynStrListPushFront(codeStrList, string)) {
-		dynStrFree(string);
+	if(irProgramAddCode(program, strViewString("substr"), strViewString(code)) == NULL) {
 		return ERROR_INTERNAL;
 	}
 	return ERROR_SUCCESS;
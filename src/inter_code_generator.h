@@ -20,53 +20,66 @@
 
 #include "parse_tree.h"
 #include "parser.h"
-#include "dynamic_string_list.h"
+#include "intermediate_code.h"
 
+/**
+ * Instruction of an expression which is not pushed to the stack,
+ * the destination variable (first operand) is added by the calling function
+ */
+typedef struct code_instruction {
+	bool generated; // false if the expression does not generate any instruction
+	irInstruction_t instruction;
+} codeInstruction_t;
+
+/**
+ * Code generation options
+ */
+typedef struct code_options {
+	unsigned optimization; // optimization level, 0 generates the code as it is
+	bool verbose; // print optimization reports to the standard error output
+	bool stackCalls; // user functions take arguments and return values on the data stack
+} codeOptions_t;
 
 /**
  * Process body of the program
  * @param codeElement tree element containing the program code
  * @param symTable symbol table
- * @param context local scope function name
+ * @param options code generation options
  * @return execution status
  */
-int processCode(treeElement_t codeElement, symTable_t* symTable);
+int processCode(treeElement_t codeElement, symTable_t* symTable, const codeOptions_t* options);
 
 /**
  * Process element with token
- * @param eTokenElement tree element with token
- * @param outputDynStr dynamic string where output will be writen to
- * @param id_only tels if there should be FRAME_TYPE@id or id only in the output
- * @param symTable symbol table
- * @param context local scope function name
+ * @param eTokenElement tree element with token, identifiers must be resolved
+ *                      by the semantic analysis
+ * @param operand operand where output will be writen to
+ * @param id_only tels if there should be FRAME_TYPE@id or id (label) only in the output
  * @param varDefined returns status if variable is defined (true) or not (false)
  *                   ignored if NULL
  * @return execution status
  */
-int processEToken(treeElement_t eTokenElement, dynStr_t* outputDynStr, bool id_only,
-        symTable_t* symTable, dynStr_t* context, bool* varDefined);
+int processEToken(treeElement_t eTokenElement, irOperand_t* operand, bool id_only, bool* varDefined);
 
 /**
  * Process definition of new function
  * @param defElement tree element with function definition
  * @param symTable symbol table
- * @param context local scope function name
- * @param codeStrList list of dynamic strings where code is generated to
+ * @param program program where the function unit is added to
  * @returns execution status
  */
-int processFunctionDefinition(treeElement_t defElement, symTable_t* symTable,
-        dynStr_t* context, dynStrList_t* codeStrList);
+int processFunctionDefinition(treeElement_t defElement, symTable_t* symTable, irProgram_t* program);
 
 /**
  * Process block of code
  * @param codeBlockElement tree element containing block of code to process
  * @param symTable symbol table
  * @param context local scope function name
- * @param codeStrList list of dynamic strings where code is generated to
+ * @param function function unit where code is generated to
  * @return execution status
  */
 int processCodeBlock(treeElement_t codeBlockElement, symTable_t* symTable,
-        dynStr_t* context, dynStrList_t* codeStrList);
+        strView_t context, irFunction_t* function);
 
 /**
  * Process expression
@@ -74,13 +87,14 @@ int processCodeBlock(treeElement_t codeBlockElement, symTable_t* symTable,
  * @param pushToStack if true, generates pushs instruction
  *                    for processed variables and constants
  *                    , is also used to return this value to calling function
+ * @param instruction instruction generated if the value is not pushed to the stack
  * @param symTable symbol table
  * @param context local scope function name
- * @param codeStrList list of dynamic strings where code is generated to
+ * @param function function unit where code is generated to
  * @return execution status
  */
-int processExpression(treeElement_t expElement, bool* pushToStack, symTable_t* symTable,
-        dynStr_t* context, dynStrList_t* codeStrList);
+int processExpression(treeElement_t expElement, bool* pushToStack, codeInstruction_t* instruction,
+        symTable_t* symTable, strView_t context, irFunction_t* function);
 
 /**
  * Process operation with 2 operands
@@ -88,13 +102,14 @@ int processExpression(treeElement_t expElement, bool* pushToStack, symTable_t* s
  * @param pushToStack if true, generates pushs instruction
  *                    for processed variables and constants
  *                    , is also used to return this value to calling function
+ * @param instruction instruction generated if the value is not pushed to the stack
  * @param symTable symbol table
  * @param context local scope function name
- * @param codeStrList list of dynamic strings where code is generated to
+ * @param function function unit where code is generated to
  * @return execution status
  */
 int processBinaryOperation(treeElement_t operationElement, bool* pushToStack,
-        symTable_t* symTable, dynStr_t* context, dynStrList_t* codeStrList);
+        codeInstruction_t* instruction, symTable_t* symTable, strView_t context, irFunction_t* function);
 
 /**
  * Process operation operation with only 1 operand
@@ -102,169 +117,165 @@ int processBinaryOperation(treeElement_t operationElement, bool* pushToStack,
  * @param pushToStack if true, generates pushs instruction
  *                    for processed variables and constants
  *                    , is also used to return this value to calling function
+ * @param instruction instruction generated if the value is not pushed to the stack
  * @param symTable symbol table
  * @param context local scope function name
- * @param codeStrList list of dynamic strings where code is generated to
+ * @param function function unit where code is generated to
  * @return execution status
  */
 int processUnaryOperation(treeElement_t operationElement, bool* pushToStack,
-        symTable_t* symTable, dynStr_t* context, dynStrList_t* codeStrList);
+        codeInstruction_t* instruction, symTable_t* symTable, strView_t context, irFunction_t* function);
 
 /**
- * Process if statement
- * @param ifElement tree element containing if statement
+ * Process condition of the known type into conditional jump without storing its value,
+ * comparisons jump on their operands and negations swap the jump
+ * @param condElement tree element with the condition
+ * @param jumpIfTrue jump if the condition is true, otherwise if it is false
+ * @param label jump target
  * @param symTable symbol table
  * @param context local scope function name
- * @param codeStrList list of dynamic strings where code is generated to
- * @returns execution status
- */
-int processIf(treeElement_t ifElement, symTable_t* symTable, dynStr_t* context, dynStrList_t* codeStrList);
-
-/**
- * Convert number to dynamic string
- * @param outputStr dynamic string where number will be put to
- * @param formatString printf style format string
- * @param number number
- * @param codeStrList list of dynamic strings where code is generated to
+ * @param function function unit where code is generated to
  * @return execution status
  */
-int numberToDynStr(dynStr_t* outputStr, char* formatString, long number);
+int processCondition(treeElement_t condElement, bool jumpIfTrue, irOperand_t label, symTable_t* symTable,
+        strView_t context, irFunction_t* function);
 
 /**
- * Convert float to dynamic string
- * @param outputStr dynamic string where number will be put to
- * @param formatString printf style format string
- * @param number float number
- * @param codeStrList list of dynamic strings where code is generated to
- * @return execution status
+ * Process if statement
+ * @param ifElement tree element containing if statement
+ * @param symTable symbol table
+ * @param context local scope function name
+ * @param function function unit where code is generated to
+ * @returns execution status
  */
-int floatToDynStr(dynStr_t* outputStr, char* formatString, double number);
+int processIf(treeElement_t ifElement, symTable_t* symTable, strView_t context, irFunction_t* function);
 
 /**
  * Process else statement
  * @param elseElement tree element with else code block to process
  * @param symTable symbol table
  * @param context local scope function name
- * @param codeStrList list of dynamic strings where code is generated to
+ * @param function function unit where code is generated to
  * @return execution status
  */
-int processElse(treeElement_t elseElement, symTable_t* symTable, dynStr_t* context, dynStrList_t* codeStrList);
+int processElse(treeElement_t elseElement, symTable_t* symTable, strView_t context, irFunction_t* function);
 
 /**
  * Process assignment of variable
  * @param assignElement element with assign expression
  * @param symTable symbol table
  * @param context local scope function name
- * @param codeStrList list of dynamic strings where code is generated to
+ * @param function function unit where code is generated to
  * @return execution status
  */
-int processAssign(treeElement_t assignElement, symTable_t* symTable, dynStr_t* context, dynStrList_t* codeStrList);
+int processAssign(treeElement_t assignElement, symTable_t* symTable, strView_t context, irFunction_t* function);
 
 /**
  * Create temporary frame and process function call
  * @param callElement tree element containing function call
  * @param context local scope function name
- * @param codeStrList list of dynamic strings where code is generated to
+ * @param function function unit where code is generated to
  * @return execution status
  */
-int processFunctionCall(treeElement_t callElement, symTable_t* symTable, dynStr_t* context, dynStrList_t* codeStrList);
+int processFunctionCall(treeElement_t callElement, symTable_t* symTable, strView_t context, irFunction_t* function);
 
 /**
- * Process function params in temporary frame
+ * Create temporary frame and process function params in it
  * @param callParamsElement tree element containing called function parameters
+ * @param fname called function name
  * @param symTable symbol table
  * @param context local scope function name
- * @param codeStrList list of dynamic strings where code is generated to
+ * @param function function unit where code is generated to
  * @return execution status
  */
-int processFunctionCallParams(treeElement_t callParamsElement, symTable_t* symTable,
-        dynStr_t* context, dynStrList_t* codeStrList);
+int processFunctionCallParams(treeElement_t callParamsElement, strView_t fname, symTable_t* symTable,
+        strView_t context, irFunction_t* function);
 
 /**
  * Process while function
  * @param whileElement tree element containing while function
  * @param symTable symbol table
  * @param context local scope function name
- * @param codeStrList list of dynamic strings where code is generated to
+ * @param function function unit where code is generated to
  * @return Execution status
  */
-int processWhile(treeElement_t whileElement, symTable_t* symTable, dynStr_t* context, dynStrList_t* codeStrList);
+int processWhile(treeElement_t whileElement, symTable_t* symTable, strView_t context, irFunction_t* function);
 
 /**
- * Generates an embedded functions
- * @param codeStrList List of dynamic string where the code is generated to
+ * Generates the embedded functions called by the program, must be called after the program code is generated
+ * @param program Program where the code is generated to
  * @return Execution status
  */
-int generateEmbeddedFunctions(dynStrList_t *codeStrList);
+int generateEmbeddedFunctions(irProgram_t* program);
 
 /**
  * Generates len embedded function
- * @param codeStrList List of dynamic string where the code is generated to
+ * @param program Program where the code is generated to
  * @return Execution status
  */
-int generateLenFunction(dynStrList_t* codeStrList);
+int generateLenFunction(irProgram_t* program);
 
 /**
  * Generates inputi embedded function
- * @param codeStrList List of dynamic string where the code is generated to
+ * @param program Program where the code is generated to
  * @return Execution status
  */
-int generateInputiFunction(dynStrList_t* codeStrList);
+int generateInputiFunction(irProgram_t* program);
 
 /**
  * Generates inputf embedded function
- * @param codeStrList List of dynamic string where the code is generated to
+ * @param program Program where the code is generated to
  * @return Execution status
  */
-int generateInputfFunction(dynStrList_t* codeStrList);
+int generateInputfFunction(irProgram_t* program);
 
 /**
  * Generates inputs embedded function
- * @param codeStrList List of dynamic string where the code is generated to
+ * @param program Program where the code is generated to
  * @return Execution status
  */
-int generateInputsFunction(dynStrList_t* codeStrList);
+int generateInputsFunction(irProgram_t* program);
 
 /**
  * Generates print embedded function
- * @param codeStrList List of dynamic string where the code is generated to
+ * @param program Program where the code is generated to
  * @return Execution status
  */
-int generatePrintFunction(dynStrList_t* codeStrList);
+int generatePrintFunction(irProgram_t* program);
 
 
 /**
  * Generates chr embedded function
- * @param codeStrList List of dynamic string where the code is generated to
+ * @param program Program where the code is generated to
  * @return Execution status
  */
-int generateChrFunction(dynStrList_t* codeStrList);
+int generateChrFunction(irProgram_t* program);
 
 
 /**
  * Generates checkType function
- * @param codeStrList List of dynamic string where the code is generated to
+ * @param program Program where the code is generated to
  * @return Execution Status
  */
-int generateCheckVariableType(dynStrList_t* codeStrList);
+int generateCheckVariableType(irProgram_t* program);
 
 /**
  * Generates changeType function for automatic type cast
- * @param codeStrList List of dynamic string where the code is generated to
+ * @param program Program where the code is generated to
  * @return Execution status
  */
-int generateChangeVariableType(dynStrList_t* codeStrList);
+int generateChangeVariableType(irProgram_t* program);
 
 /**
  * Generates ord embedded function
- * @param codeStrList List of dynamic string where the code is generated to
+ * @param program Program where the code is generated to
  * @return Execution status
  */
-int generateOrdFunction(dynStrList_t* codeStrList);
+int generateOrdFunction(irProgram_t* program);
 
 /**
  * Generates substr embedded function
- * @param codeStrList List of dynamic string where the code is generated to
+ * @param program Program where the code is generated to
  * @return Execution status
  */
-int generateSubstrFunction(dynStrList_t* codeStrList);
+int generateSubstrFunction(irProgram_t* program);
@@ -0,0 +1,597 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "intermediate_code.h"
+
+/// Opcode names
+static const char *irOpcodeNames[IR_OPCODE_COUNT] = {
+	[IR_MOVE] = "MOVE",
+	[IR_CREATEFRAME] = "CREATEFRAME",
+	[IR_PUSHFRAME] = "PUSHFRAME",
+	[IR_POPFRAME] = "POPFRAME",
+	[IR_DEFVAR] = "DEFVAR",
+	[IR_CALL] = "CALL",
+	[IR_RETURN] = "RETURN",
+	[IR_PUSHS] = "PUSHS",
+	[IR_POPS] = "POPS",
+	[IR_CLEARS] = "CLEARS",
+	[IR_ADD] = "ADD",
+	[IR_SUB] = "SUB",
+	[IR_MUL] = "MUL",
+	[IR_DIV] = "DIV",
+	[IR_IDIV] = "IDIV",
+	[IR_ADDS] = "ADDS",
+	[IR_SUBS] = "SUBS",
+	[IR_MULS] = "MULS",
+	[IR_DIVS] = "DIVS",
+	[IR_IDIVS] = "IDIVS",
+	[IR_LT] = "LT",
+	[IR_GT] = "GT",
+	[IR_EQ] = "EQ",
+	[IR_LTS] = "LTS",
+	[IR_GTS] = "GTS",
+	[IR_EQS] = "EQS",
+	[IR_AND] = "AND",
+	[IR_OR] = "OR",
+	[IR_NOT] = "NOT",
+	[IR_ANDS] = "ANDS",
+	[IR_ORS] = "ORS",
+	[IR_NOTS] = "NOTS",
+	[IR_INT2FLOAT] = "INT2FLOAT",
+	[IR_FLOAT2INT] = "FLOAT2INT",
+	[IR_INT2CHAR] = "INT2CHAR",
+	[IR_STRI2INT] = "STRI2INT",
+	[IR_INT2FLOATS] = "INT2FLOATS",
+	[IR_FLOAT2INTS] = "FLOAT2INTS",
+	[IR_INT2CHARS] = "INT2CHARS",
+	[IR_STRI2INTS] = "STRI2INTS",
+	[IR_READ] = "READ",
+	[IR_WRITE] = "WRITE",
+	[IR_CONCAT] = "CONCAT",
+	[IR_STRLEN] = "STRLEN",
+	[IR_GETCHAR] = "GETCHAR",
+	[IR_SETCHAR] = "SETCHAR",
+	[IR_TYPE] = "TYPE",
+	[IR_LABEL] = "LABEL",
+	[IR_JUMP] = "JUMP",
+	[IR_JUMPIFEQ] = "JUMPIFEQ",
+	[IR_JUMPIFNEQ] = "JUMPIFNEQ",
+	[IR_JUMPIFEQS] = "JUMPIFEQS",
+	[IR_JUMPIFNEQS] = "JUMPIFNEQS",
+	[IR_EXIT] = "EXIT",
+	[IR_BREAK] = "BREAK",
+	[IR_DPRINT] = "DPRINT",
+};
+
+/// Number of the opcode operands
+static const unsigned char irOpcodeOperandCount[IR_OPCODE_COUNT] = {
+	[IR_MOVE] = 2,
+	[IR_DEFVAR] = 1,
+	[IR_CALL] = 1,
+	[IR_PUSHS] = 1,
+	[IR_POPS] = 1,
+	[IR_ADD] = 3,
+	[IR_SUB] = 3,
+	[IR_MUL] = 3,
+	[IR_DIV] = 3,
+	[IR_IDIV] = 3,
+	[IR_LT] = 3,
+	[IR_GT] = 3,
+	[IR_EQ] = 3,
+	[IR_AND] = 3,
+	[IR_OR] = 3,
+	[IR_NOT] = 2,
+	[IR_INT2FLOAT] = 2,
+	[IR_FLOAT2INT] = 2,
+	[IR_INT2CHAR] = 2,
+	[IR_STRI2INT] = 3,
+	[IR_READ] = 2,
+	[IR_WRITE] = 1,
+	[IR_CONCAT] = 3,
+	[IR_STRLEN] = 2,
+	[IR_GETCHAR] = 3,
+	[IR_SETCHAR] = 3,
+	[IR_TYPE] = 2,
+	[IR_LABEL] = 1,
+	[IR_JUMP] = 1,
+	[IR_JUMPIFEQ] = 3,
+	[IR_JUMPIFNEQ] = 3,
+	[IR_JUMPIFEQS] = 1,
+	[IR_JUMPIFNEQS] = 1,
+	[IR_EXIT] = 1,
+	[IR_DPRINT] = 1,
+};
+
+/// Frame prefixes of the variables
+static const char *irFramePrefix[] = {
+	[FRAME_GLOBAL] = "GF@",
+	[FRAME_LOCAL] = "LF@",
+	[FRAME_TEMP] = "TF@",
+	[FRAME_ERROR] = "",
+};
+
+const char* irOpcodeName(irOpcode_t opcode) {
+	return opcode < IR_OPCODE_COUNT ? irOpcodeNames[opcode] : NULL;
+}
+
+unsigned irOpcodeOperands(irOpcode_t opcode) {
+	return opcode < IR_OPCODE_COUNT ? irOpcodeOperandCount[opcode] : 0;
+}
+
+bool irOpcodeIsTerminator(irOpcode_t opcode) {
+	switch (opcode) {
+		case IR_JUMP:
+		case IR_JUMPIFEQ:
+		case IR_JUMPIFNEQ:
+		case IR_JUMPIFEQS:
+		case IR_JUMPIFNEQS:
+		case IR_RETURN:
+		case IR_EXIT:
+			return true;
+		default:
+			return false;
+	}
+}
+
+irOperand_t irVariable(symbolFrame_t frame, strView_t name) {
+	irOperand_t operand = {.type = IR_OPERAND_VARIABLE};
+	operand.data.variable.frame = frame;
+	operand.data.variable.name = name;
+	operand.data.variable.symbol = NULL;
+	return operand;
+}
+
+irOperand_t irSymbol(symbol_t *symbol) {
+	irOperand_t operand = irVariable(strViewIsNull(symbol->context) ? FRAME_GLOBAL : FRAME_LOCAL, symbol->name);
+	operand.data.variable.symbol = symbol;
+	return operand;
+}
+
+irOperand_t irInt(long value) {
+	irOperand_t operand = {.type = IR_OPERAND_INT};
+	operand.data.intval = value;
+	return operand;
+}
+
+irOperand_t irFloat(double value) {
+	irOperand_t operand = {.type = IR_OPERAND_FLOAT};
+	operand.data.floatval = value;
+	return operand;
+}
+
+irOperand_t irBool(bool value) {
+	irOperand_t operand = {.type = IR_OPERAND_BOOL};
+	operand.data.boolval = value;
+	return operand;
+}
+
+irOperand_t irNil() {
+	irOperand_t operand = {.type = IR_OPERAND_NIL};
+	return operand;
+}
+
+irOperand_t irString(strView_t value) {
+	irOperand_t operand = {.type = IR_OPERAND_STRING};
+	operand.data.string = value;
+	return operand;
+}
+
+irOperand_t irLabel(strView_t name, long index) {
+	irOperand_t operand = {.type = IR_OPERAND_LABEL};
+	operand.data.label.name = name;
+	operand.data.label.index = index;
+	return operand;
+}
+
+irOperand_t irType(strView_t type) {
+	irOperand_t operand = {.type = IR_OPERAND_TYPE};
+	operand.data.type = type;
+	return operand;
+}
+
+bool irOperandEqual(const irOperand_t *operand1, const irOperand_t *operand2) {
+	if (operand1->type != operand2->type) {
+		return false;
+	}
+	switch (operand1->type) {
+		case IR_OPERAND_VARIABLE:
+			return operand1->data.variable.frame == operand2->data.variable.frame
+				&& strViewEqual(operand1->data.variable.name, operand2->data.variable.name);
+		case IR_OPERAND_INT:
+			return operand1->data.intval == operand2->data.intval;
+		case IR_OPERAND_FLOAT:
+			// bit comparison, so that 0.0 and -0.0 differ
+			return memcmp(&operand1->data.floatval, &operand2->data.floatval, sizeof(double)) == 0;
+		case IR_OPERAND_BOOL:
+			return operand1->data.boolval == operand2->data.boolval;
+		case IR_OPERAND_NIL:
+			return true;
+		case IR_OPERAND_STRING:
+			return strViewEqual(operand1->data.string, operand2->data.string);
+		case IR_OPERAND_LABEL:
+			return operand1->data.label.index == operand2->data.label.index
+				&& strViewEqual(operand1->data.label.name, operand2->data.label.name);
+		case IR_OPERAND_TYPE:
+			return strViewEqual(operand1->data.type, operand2->data.type);
+	}
+	return false;
+}
+
+/**
+ * Frees the block and all the following blocks
+ * @param block First block to free
+ */
+static void irBlockFree(irBlock_t *block) {
+	while (block != NULL) {
+		irBlock_t *next = block->next;
+		free(block->instructions);
+		free(block);
+		block = next;
+	}
+}
+
+/**
+ * Appends a new empty block to the function
+ * @param function Function
+ * @return Execution status
+ */
+static bool irFunctionAddBlock(irFunction_t *function) {
+	irBlock_t *block = malloc(sizeof(irBlock_t));
+	if (block == NULL) {
+		return false;
+	}
+	block->instructions = NULL;
+	block->count = 0;
+	block->capacity = 0;
+	block->next = NULL;
+	if (function->last == NULL) {
+		function->first = block;
+	} else {
+		function->last->next = block;
+	}
+	function->last = block;
+	function->closed = false;
+	return true;
+}
+
+/**
+ * Allocates a function and appends it to the program
+ * @param program Program
+ * @param name Function name
+ * @return Function or NULL on allocation failure
+ */
+static irFunction_t* irProgramAppend(irProgram_t *program, strView_t name) {
+	if (program == NULL) {
+		return NULL;
+	}
+	irFunction_t *function = malloc(sizeof(irFunction_t));
+	if (function == NULL) {
+		return NULL;
+	}
+	function->name = name;
+	function->code = strViewNull();
+	function->first = NULL;
+	function->last = NULL;
+	function->closed = false;
+	function->next = NULL;
+	if (program->last == NULL) {
+		program->first = function;
+	} else {
+		program->last->next = function;
+	}
+	program->last = function;
+	return function;
+}
+
+irProgram_t* irProgramInit() {
+	irProgram_t *program = malloc(sizeof(irProgram_t));
+	if (program == NULL) {
+		return NULL;
+	}
+	program->first = NULL;
+	program->last = NULL;
+	program->main = NULL;
+	program->names = dynStrListInit();
+	if (program->names == NULL) {
+		free(program);
+		return NULL;
+	}
+	return program;
+}
+
+void irProgramFree(irProgram_t *program) {
+	if (program == NULL) {
+		return;
+	}
+	irFunction_t *function = program->first;
+	while (function != NULL) {
+		irFunction_t *next = function->next;
+		irBlockFree(function->first);
+		free(function);
+		function = next;
+	}
+	dynStrListFree(program->names);
+	free(program);
+}
+
+bool irProgramRemoveFunction(irProgram_t *program, irFunction_t *function) {
+	if (program == NULL || function == NULL || function == program->main) {
+		return false;
+	}
+	irFunction_t *previous = NULL;
+	irFunction_t *current = program->first;
+	while (current != NULL && current != function) {
+		previous = current;
+		current = current->next;
+	}
+	if (current == NULL) {
+		return false;
+	}
+	if (previous == NULL) {
+		program->first = function->next;
+	} else {
+		previous->next = function->next;
+	}
+	if (program->last == function) {
+		program->last = previous;
+	}
+	irBlockFree(function->first);
+	free(function);
+	return true;
+}
+
+strView_t irProgramAddName(irProgram_t *program, const char *name) {
+	if (program == NULL || name == NULL) {
+		return strViewNull();
+	}
+	dynStr_t *string = dynStrInitString(name);
+	if (string == NULL) {
+		return strViewNull();
+	}
+	if (!dynStrListPushBack(program->names, string)) {
+		dynStrFree(string);
+		return strViewNull();
+	}
+	return dynStrListElGetView(dynStrListBack(program->names));
+}
+
+irFunction_t* irProgramAddFunction(irProgram_t *program, strView_t name) {
+	return irProgramAppend(program, name);
+}
+
+irFunction_t* irProgramAddCode(irProgram_t *program, strView_t name, strView_t code) {
+	irFunction_t *function = irProgramAppend(program, name);
+	if (function != NULL) {
+		function->code = code;
+	}
+	return function;
+}
+
+bool irEmitInstruction(irFunction_t *function, const irInstruction_t *instruction) {
+	if (function == NULL || instruction == NULL || instruction->opcode >= IR_OPCODE_COUNT) {
+		return false;
+	}
+	irBlock_t *block = function->last;
+	// labels start a new block, unless the current one is empty
+	if (block == NULL || function->closed || (instruction->opcode == IR_LABEL && block->count != 0)) {
+		if (!irFunctionAddBlock(function)) {
+			return false;
+		}
+		block = function->last;
+	}
+	if (block->count == block->capacity) {
+		size_t capacity = block->capacity == 0 ? 16 : block->capacity * 2;
+		irInstruction_t *instructions = realloc(block->instructions, capacity * sizeof(irInstruction_t));
+		if (instructions == NULL) {
+			return false;
+		}
+		block->instructions = instructions;
+		block->capacity = capacity;
+	}
+	block->instructions[block->count++] = *instruction;
+	function->closed = irOpcodeIsTerminator(instruction->opcode);
+	return true;
+}
+
+bool irEmit(irFunction_t *function, irOpcode_t opcode, ...) {
+	irInstruction_t instruction = {.opcode = opcode};
+	va_list operands;
+	va_start(operands, opcode);
+	for (unsigned i = 0; i < irOpcodeOperands(opcode); ++i) {
+		instruction.operands[i] = va_arg(operands, irOperand_t);
+	}
+	va_end(operands);
+	return irEmitInstruction(function, &instruction);
+}
+
+bool irFunctionPrepend(irFunction_t *function, const irInstruction_t *instruction) {
+	if (function == NULL || instruction == NULL || instruction->opcode >= IR_OPCODE_COUNT) {
+		return false;
+	}
+	if (function->first == NULL) {
+		return irEmitInstruction(function, instruction);
+	}
+	irBlock_t *block = function->first;
+	if (block->count != 0 && block->instructions[0].opcode == IR_LABEL) {
+		// the label can be jumped to, so the instruction gets its own block in front of it
+		block = malloc(sizeof(irBlock_t));
+		if (block == NULL) {
+			return false;
+		}
+		block->instructions = NULL;
+		block->count = 0;
+		block->capacity = 0;
+		block->next = function->first;
+		function->first = block;
+	}
+	if (block->count == block->capacity) {
+		size_t capacity = block->capacity == 0 ? 16 : block->capacity * 2;
+		irInstruction_t *instructions = realloc(block->instructions, capacity * sizeof(irInstruction_t));
+		if (instructions == NULL) {
+			return false;
+		}
+		block->instructions = instructions;
+		block->capacity = capacity;
+	}
+	memmove(block->instructions + 1, block->instructions, block->count * sizeof(irInstruction_t));
+	block->instructions[0] = *instruction;
+	block->count++;
+	return true;
+}
+
+irPosition_t irFunctionPosition(irFunction_t *function) {
+	irPosition_t position = {.block = function->last, .index = function->last == NULL ? 0 : function->last->count};
+	return position;
+}
+
+bool irFunctionTruncate(irFunction_t *function, irPosition_t position) {
+	if (function == NULL) {
+		return false;
+	}
+	if (position.block == NULL) {
+		irBlockFree(function->first);
+		function->first = NULL;
+		function->last = NULL;
+		function->closed = false;
+		return true;
+	}
+	if (position.index > position.block->count) {
+		return false;
+	}
+	irBlockFree(position.block->next);
+	position.block->next = NULL;
+	position.block->count = position.index;
+	function->last = position.block;
+	function->closed = position.index != 0
+		&& irOpcodeIsTerminator(position.block->instructions[position.index - 1].opcode);
+	return true;
+}
+
+bool irFunctionReverse(irFunction_t *function, irPosition_t position) {
+	if (function == NULL) {
+		return false;
+	}
+	irBlock_t *block = position.block;
+	size_t begin = position.index;
+	if (block == NULL || (block != function->last && block->count == begin && block->next == function->last)) {
+		// instructions were emitted to the next block
+		block = function->last;
+		begin = 0;
+	}
+	if (block != function->last) {
+		return false;
+	}
+	if (block == NULL) {
+		return true;
+	}
+	for (size_t end = block->count; begin + 1 < end; ++begin, --end) {
+		irInstruction_t instruction = block->instructions[begin];
+		block->instructions[begin] = block->instructions[end - 1];
+		block->instructions[end - 1] = instruction;
+	}
+	return true;
+}
+
+bool irPrintOperand(codeEmitter_t *emitter, const irOperand_t *operand) {
+	switch (operand->type) {
+		case IR_OPERAND_VARIABLE:
+			// variable symbols have the whole operand ready
+			if (operand->data.variable.symbol != NULL && operand->data.variable.symbol->operand != NULL) {
+				return codeEmitterAppendView(emitter, strViewDynStr(operand->data.variable.symbol->operand));
+			}
+			return codeEmitterAppend(emitter, irFramePrefix[operand->data.variable.frame], 3)
+				&& codeEmitterAppendView(emitter, operand->data.variable.name);
+		case IR_OPERAND_INT:
+			return codeEmitterAppend(emitter, "int@", 4) && codeEmitterAppendNumber(emitter, operand->data.intval);
+		case IR_OPERAND_FLOAT:
+			return codeEmitterAppend(emitter, "float@", 6) && codeEmitterAppendFloat(emitter, operand->data.floatval);
+		case IR_OPERAND_BOOL:
+			return operand->data.boolval ? codeEmitterAppend(emitter, "bool@true", 9)
+				: codeEmitterAppend(emitter, "bool@false", 10);
+		case IR_OPERAND_NIL:
+			return codeEmitterAppend(emitter, "nil@nil", 7);
+		case IR_OPERAND_STRING:
+			return codeEmitterAppend(emitter, "string@", 7) && codeEmitterAppendView(emitter, operand->data.string);
+		case IR_OPERAND_LABEL:
+			if (!codeEmitterAppendView(emitter, operand->data.label.name)) {
+				return false;
+			}
+			return operand->data.label.index < 0 || codeEmitterAppendNumber(emitter, operand->data.label.index);
+		case IR_OPERAND_TYPE:
+			return codeEmitterAppendView(emitter, operand->data.type);
+	}
+	return false;
+}
+
+bool irPrintInstruction(codeEmitter_t *emitter, const irInstruction_t *instruction) {
+	if (!codeEmitterAppendString(emitter, irOpcodeName(instruction->opcode))) {
+		return false;
+	}
+	for (unsigned i = 0; i < irOpcodeOperands(instruction->opcode); ++i) {
+		if (!codeEmitterAppendChar(emitter, ' ') || !irPrintOperand(emitter, &instruction->operands[i])) {
+			return false;
+		}
+	}
+	return codeEmitterAppendChar(emitter, '\n');
+}
+
+bool irPrintFunction(codeEmitter_t *emitter, const irFunction_t *function) {
+	if (!strViewIsNull(function->code)) {
+		return codeEmitterAppendView(emitter, function->code);
+	}
+	if (!codeEmitterAppend(emitter, "LABEL ", 6)
+		|| !codeEmitterAppendView(emitter, function->name)
+		|| !codeEmitterAppendChar(emitter, '\n')) {
+		return false;
+	}
+	for (const irBlock_t *block = function->first; block != NULL; block = block->next) {
+		for (size_t i = 0; i < block->count; ++i) {
+			if (!irPrintInstruction(emitter, &block->instructions[i])) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool irPrint(codeEmitter_t *emitter, const irProgram_t *program) {
+	if (emitter == NULL || program == NULL || program->main == NULL) {
+		return false;
+	}
+	if (!codeEmitterAppendString(emitter, ".IFJcode19\n")) {
+		return false;
+	}
+	// jump over the other functions to the main function
+	if (program->first != program->main || program->main->next != NULL) {
+		if (!codeEmitterAppend(emitter, "JUMP ", 5)
+			|| !codeEmitterAppendView(emitter, program->main->name)
+			|| !codeEmitterAppendChar(emitter, '\n')) {
+			return false;
+		}
+	}
+	for (const irFunction_t *function = program->first; function != NULL; function = function->next) {
+		if (function != program->main && !irPrintFunction(emitter, function)) {
+			return false;
+		}
+	}
+	return irPrintFunction(emitter, program->main);
+}
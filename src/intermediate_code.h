@@ -0,0 +1,398 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "code_emitter.h"
+#include "string_view.h"
+#include "symtable.h"
+
+/**
+ * IFJcode19 instruction opcodes
+ */
+typedef enum ir_opcode {
+	IR_MOVE,
+	IR_CREATEFRAME,
+	IR_PUSHFRAME,
+	IR_POPFRAME,
+	IR_DEFVAR,
+	IR_CALL,
+	IR_RETURN,
+	IR_PUSHS,
+	IR_POPS,
+	IR_CLEARS,
+	IR_ADD,
+	IR_SUB,
+	IR_MUL,
+	IR_DIV,
+	IR_IDIV,
+	IR_ADDS,
+	IR_SUBS,
+	IR_MULS,
+	IR_DIVS,
+	IR_IDIVS,
+	IR_LT,
+	IR_GT,
+	IR_EQ,
+	IR_LTS,
+	IR_GTS,
+	IR_EQS,
+	IR_AND,
+	IR_OR,
+	IR_NOT,
+	IR_ANDS,
+	IR_ORS,
+	IR_NOTS,
+	IR_INT2FLOAT,
+	IR_FLOAT2INT,
+	IR_INT2CHAR,
+	IR_STRI2INT,
+	IR_INT2FLOATS,
+	IR_FLOAT2INTS,
+	IR_INT2CHARS,
+	IR_STRI2INTS,
+	IR_READ,
+	IR_WRITE,
+	IR_CONCAT,
+	IR_STRLEN,
+	IR_GETCHAR,
+	IR_SETCHAR,
+	IR_TYPE,
+	IR_LABEL,
+	IR_JUMP,
+	IR_JUMPIFEQ,
+	IR_JUMPIFNEQ,
+	IR_JUMPIFEQS,
+	IR_JUMPIFNEQS,
+	IR_EXIT,
+	IR_BREAK,
+	IR_DPRINT,
+	IR_OPCODE_COUNT
+} irOpcode_t;
+
+/// Maximal number of the instruction operands
+#define IR_MAX_OPERANDS 3
+
+/**
+ * Types of the instruction operands
+ */
+typedef enum ir_operand_type {
+	IR_OPERAND_VARIABLE,
+	IR_OPERAND_INT,
+	IR_OPERAND_FLOAT,
+	IR_OPERAND_BOOL,
+	IR_OPERAND_NIL,
+	IR_OPERAND_STRING,
+	IR_OPERAND_LABEL,
+	IR_OPERAND_TYPE
+} irOperandType_t;
+
+/**
+ * Instruction operand
+ */
+typedef struct ir_operand {
+	irOperandType_t type;
+	union {
+		struct {
+			symbolFrame_t frame;
+			strView_t name; // borrowed variable name
+			symbol_t *symbol; // variable symbol, NULL for the generated variables
+		} variable;
+		long intval;
+		double floatval;
+		bool boolval;
+		strView_t string; // borrowed escaped string, without the string@ prefix
+		struct {
+			strView_t name; // borrowed label name
+			long index; // number appended to the name, negative if the name is not numbered
+		} label;
+		strView_t type; // type name (int, float, string, bool)
+	} data;
+} irOperand_t;
+
+/**
+ * Instruction
+ */
+typedef struct ir_instruction {
+	irOpcode_t opcode;
+	irOperand_t operands[IR_MAX_OPERANDS];
+} irInstruction_t;
+
+/**
+ * Basic block, a sequence of instructions which can be entered only by its first instruction
+ * and left only after its last instruction
+ */
+typedef struct ir_block {
+	irInstruction_t *instructions;
+	size_t count;
+	size_t capacity;
+	struct ir_block *next;
+} irBlock_t;
+
+/**
+ * Function unit
+ */
+typedef struct ir_function {
+	strView_t name; // borrowed function name (label)
+	strView_t code; // borrowed preformatted code of the embedded functions, null view if the function has blocks
+	irBlock_t *first;
+	irBlock_t *last;
+	bool closed; // the last block ends with a jump, next instruction starts a new block
+	struct ir_function *next;
+} irFunction_t;
+
+/**
+ * Program, functions are printed in order, the main function is printed last
+ */
+typedef struct ir_program {
+	irFunction_t *first;
+	irFunction_t *last;
+	irFunction_t *main;
+	dynStrList_t *names; // owned names of the operands created by the optimizations
+} irProgram_t;
+
+/**
+ * Position of an instruction in a function
+ */
+typedef struct ir_position {
+	irBlock_t *block;
+	size_t index;
+} irPosition_t;
+
+/**
+ * Returns name of the opcode
+ * @param opcode Instruction opcode
+ * @return Opcode name
+ */
+const char* irOpcodeName(irOpcode_t opcode);
+
+/**
+ * Returns number of the opcode operands
+ * @param opcode Instruction opcode
+ * @return Number of operands
+ */
+unsigned irOpcodeOperands(irOpcode_t opcode);
+
+/**
+ * Checks if the instruction ends a basic block
+ * @param opcode Instruction opcode
+ * @return Is the opcode a jump, return or exit?
+ */
+bool irOpcodeIsTerminator(irOpcode_t opcode);
+
+/**
+ * Creates a variable operand
+ * @param frame Variable frame
+ * @param name Variable name
+ * @return Operand
+ */
+irOperand_t irVariable(symbolFrame_t frame, strView_t name);
+
+/**
+ * Creates a variable operand of the variable symbol
+ * @param symbol Variable symbol
+ * @return Operand
+ */
+irOperand_t irSymbol(symbol_t *symbol);
+
+/**
+ * Creates an integer constant operand
+ * @param value Integer value
+ * @return Operand
+ */
+irOperand_t irInt(long value);
+
+/**
+ * Creates a float constant operand
+ * @param value Float value
+ * @return Operand
+ */
+irOperand_t irFloat(double value);
+
+/**
+ * Creates a bool constant operand
+ * @param value Bool value
+ * @return Operand
+ */
+irOperand_t irBool(bool value);
+
+/**
+ * Creates a nil constant operand
+ * @return Operand
+ */
+irOperand_t irNil();
+
+/**
+ * Creates a string constant operand
+ * @param value Escaped string
+ * @return Operand
+ */
+irOperand_t irString(strView_t value);
+
+/**
+ * Creates a label operand
+ * @param name Label name
+ * @param index Number appended to the name, negative if the label is not numbered
+ * @return Operand
+ */
+irOperand_t irLabel(strView_t name, long index);
+
+/**
+ * Creates a type operand
+ * @param type Type name
+ * @return Operand
+ */
+irOperand_t irType(strView_t type);
+
+/**
+ * Determines whether two operands are the same
+ * @param operand1 First operand
+ * @param operand2 Second operand
+ * @return Operand equality
+ */
+bool irOperandEqual(const irOperand_t *operand1, const irOperand_t *operand2);
+
+/**
+ * Initializes an empty program
+ * @return Program or NULL on allocation failure
+ */
+irProgram_t* irProgramInit();
+
+/**
+ * Frees the program with all its functions
+ * @param program Program
+ */
+void irProgramFree(irProgram_t *program);
+
+/**
+ * Adds a new function built of blocks to the end of the program
+ * @param program Program
+ * @param name Function name
+ * @return Function or NULL on allocation failure
+ */
+irFunction_t* irProgramAddFunction(irProgram_t *program, strView_t name);
+
+/**
+ * Removes the function from the program and frees it
+ * @param program Program
+ * @param function Function to remove, must not be the main function
+ * @return Execution status, false if the function is not in the program
+ */
+bool irProgramRemoveFunction(irProgram_t *program, irFunction_t *function);
+
+/**
+ * Adds a name owned by the program, for the operands created after the code generation
+ * @param program Program
+ * @param name Name to copy
+ * @return Copied name, null view on allocation failure
+ */
+strView_t irProgramAddName(irProgram_t *program, const char *name);
+
+/**
+ * Adds a new function with preformatted code to the end of the program
+ * @param program Program
+ * @param name Function name
+ * @param code Function code including its label
+ * @return Function or NULL on allocation failure
+ */
+irFunction_t* irProgramAddCode(irProgram_t *program, strView_t name, strView_t code);
+
+/**
+ * Appends the instruction to the function, labels start a new block and jumps end the block
+ * @param function Function
+ * @param instruction Instruction
+ * @return Execution status
+ */
+bool irEmitInstruction(irFunction_t *function, const irInstruction_t *instruction);
+
+/**
+ * Appends the instruction to the function
+ * @param function Function
+ * @param opcode Instruction opcode
+ * @param ... Instruction operands (irOperand_t), the count is given by the opcode
+ * @return Execution status
+ */
+bool irEmit(irFunction_t *function, irOpcode_t opcode, ...);
+
+/**
+ * Inserts the instruction at the beginning of the function (prologue)
+ * @param function Function
+ * @param instruction Instruction
+ * @return Execution status
+ */
+bool irFunctionPrepend(irFunction_t *function, const irInstruction_t *instruction);
+
+/**
+ * Returns position after the last instruction of the function
+ * @param function Function
+ * @return Position
+ */
+irPosition_t irFunctionPosition(irFunction_t *function);
+
+/**
+ * Removes the instructions emitted after the position
+ * @param function Function
+ * @param position Position returned by irFunctionPosition
+ * @return Execution status
+ */
+bool irFunctionTruncate(irFunction_t *function, irPosition_t position);
+
+/**
+ * Reverses order of the instructions emitted after the position, they have to be in one block
+ * @param function Function
+ * @param position Position returned by irFunctionPosition
+ * @return Execution status
+ */
+bool irFunctionReverse(irFunction_t *function, irPosition_t position);
+
+/**
+ * Prints the operand in IFJcode19 format
+ * @param emitter Code emitter
+ * @param operand Operand
+ * @return Execution status
+ */
+bool irPrintOperand(codeEmitter_t *emitter, const irOperand_t *operand);
+
+/**
+ * Prints the instruction in IFJcode19 format
+ * @param emitter Code emitter
+ * @param instruction Instruction
+ * @return Execution status
+ */
+bool irPrintInstruction(codeEmitter_t *emitter, const irInstruction_t *instruction);
+
+/**
+ * Prints the function in IFJcode19 format
+ * @param emitter Code emitter
+ * @param function Function
+ * @return Execution status
+ */
+bool irPrintFunction(codeEmitter_t *emitter, const irFunction_t *function);
+
+/**
+ * Prints the program in IFJcode19 format
+ * @param emitter Code emitter
+ * @param program Program
+ * @return Execution status
+ */
+bool irPrint(codeEmitter_t *emitter, const irProgram_t *program);
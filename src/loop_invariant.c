@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "loop_invariant.h"
+#include "semantic_analysis.h"
+
+/**
+ * Statements hoisted before the loop, the loop itself is added after them
+ */
+typedef struct loop_hoisted {
+	treeElement_t* statements;
+	unsigned int size;
+	unsigned int capacity;
+} loopHoisted_t;
+
+/**
+ * Makes room for another statement
+ * @param hoisted hoisted statements
+ * @return execution status
+ */
+static bool loopReserve(loopHoisted_t* hoisted) {
+	if(hoisted->size < hoisted->capacity) {
+		return true;
+	}
+	unsigned int capacity = hoisted->capacity == 0 ? 4 : hoisted->capacity * 2;
+	treeElement_t* statements = realloc(hoisted->statements, capacity * sizeof(treeElement_t));
+	if(statements == NULL) {
+		return false;
+	}
+	hoisted->statements = statements;
+	hoisted->capacity = capacity;
+	return true;
+}
+
+/**
+ * Checks if the variable is assigned in the code
+ * @param element tree element
+ * @param symbol variable symbol
+ * @return is there an assignment of the variable?
+ */
+static bool loopAssigns(const treeElement_t* element, const symbol_t* symbol) {
+	if(element->type == E_TOKEN) {
+		return false;
+	}
+	if(element->type == E_ASSIGN && element->data.elements[0].symbol == symbol) {
+		return true;
+	}
+	for(unsigned int i = 0; i < element->nodeSize; i++) {
+		if(loopAssigns(&element->data.elements[i], symbol)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Checks if the operand is a non-zero number literal
+ * @param element operand element
+ * @return can't the division by the operand fail?
+ */
+static bool loopIsDivisor(treeElement_t* element) {
+	token_t* literal = getLiteral(element);
+	if(literal == NULL) {
+		return false;
+	}
+	return (literal->type == T_NUMBER && literal->data.intval != 0)
+			|| (literal->type == T_FLOAT && literal->data.floatval != 0);
+}
+
+/**
+ * Checks if the expression is invariant in the loop and its evaluation can't fail nor have a side effect,
+ * only arithmetic operations and len are considered, conditions are already lowered into jumps
+ * @param element expression element
+ * @param loop while statement
+ * @return can the expression be evaluated before the loop?
+ */
+static bool loopIsInvariant(treeElement_t* element, const treeElement_t* loop) {
+	if(element->type == E_TOKEN) {
+		if(element->data.token->type != T_ID) {
+			return getLiteral(element) != NULL;
+		}
+		// variable of the known type is assigned before it is read
+		unsigned int types = element->valueTypes;
+		return element->symbol != NULL && element->symbol->type == SYMBOL_VARIABLE
+				&& types != 0 && (types & (types - 1)) == 0 && !loopAssigns(loop, element->symbol);
+	}
+	if(element->type == E_S_EXPRESSION) {
+		return element->nodeSize == 1 && loopIsInvariant(&element->data.elements[0], loop);
+	}
+	if(element->type == E_S_FUNCTION_CALL) {
+		// len of a string is the only call without side effects which can't fail
+		if(element->nodeSize != 2 || element->data.elements[1].nodeSize != 1
+				|| !strViewEqualString(strViewDynStr(element->data.elements[0].data.token->data.strval), "len")) {
+			return false;
+		}
+		treeElement_t* argument = &element->data.elements[1].data.elements[0];
+		return argument->valueTypes == VALUE_STRING && loopIsInvariant(argument, loop);
+	}
+	if(element->nodeSize != 2 || !loopIsInvariant(&element->data.elements[0], loop)
+			|| !loopIsInvariant(&element->data.elements[1], loop)) {
+		return false;
+	}
+	unsigned int first = element->data.elements[0].valueTypes;
+	unsigned int second = element->data.elements[1].valueTypes;
+	bool numbers = (first == VALUE_INT || first == VALUE_FLOAT) && (second == VALUE_INT || second == VALUE_FLOAT);
+	switch(element->type) {
+		case E_ADD:
+			return numbers || (first == VALUE_STRING && second == VALUE_STRING);
+		case E_SUB:
+		case E_MUL:
+			return numbers;
+		case E_DIV:
+			return numbers && loopIsDivisor(&element->data.elements[1]);
+		case E_DIV_INT:
+			return first == VALUE_INT && second == VALUE_INT && loopIsDivisor(&element->data.elements[1]);
+		default:
+			return false;
+	}
+}
+
+/**
+ * Creates identifier of the temporary variable
+ * @param element element to initialize
+ * @param name variable name
+ * @param symbol variable symbol, NULL if the name is not inserted yet
+ * @param types set of possible value types
+ * @return execution status
+ */
+static bool loopTemporary(treeElement_t* element, const char* name, symbol_t* symbol, unsigned int types) {
+	token_t token = {.type = T_ID, .data.strval = dynStrInitString(name), .operand = NULL};
+	if(token.data.strval == NULL) {
+		return false;
+	}
+	initTokenTreeElement(element, token);
+	element->symbol = symbol;
+	element->valueTypes = types;
+	return true;
+}
+
+/**
+ * Moves the expression to the assignment of a new temporary variable and replaces it by the variable
+ * @param element invariant expression element
+ * @param context local scope function name, null view in the top-level code
+ * @param symTable symbol table
+ * @param hoisted hoisted statements, the assignment is added to them
+ * @return execution status
+ */
+static bool loopHoist(treeElement_t* element, strView_t context, symTable_t* symTable, loopHoisted_t* hoisted) {
+	// identifiers can't contain $, so the name is not used by the program
+	static unsigned int temporaryCounter = 0;
+	char name[32];
+	sprintf(name, "$invariant%u", temporaryCounter++);
+
+	treeElement_t variable;
+	treeElement_t replacement;
+	if(!loopReserve(hoisted) || !loopTemporary(&variable, name, NULL, element->valueTypes)) {
+		return false;
+	}
+	// the symbol name is borrowed from the assigned identifier
+	strView_t symbolName = strViewDynStr(variable.data.token->data.strval);
+	if(symTableInsertVariable(symTable, symbolName, context, false) != ERROR_SUCCESS
+			|| (variable.symbol = symTableFind(symTable, symbolName, context)) == NULL
+			|| !loopTemporary(&replacement, name, variable.symbol, element->valueTypes)) {
+		treeFree(variable);
+		return false;
+	}
+	treeElement_t* expression = malloc(sizeof(treeElement_t));
+	treeElement_t* parts = malloc(2 * sizeof(treeElement_t));
+	if(expression == NULL || parts == NULL) {
+		free(expression);
+		free(parts);
+		treeFree(variable);
+		treeFree(replacement);
+		return false;
+	}
+	// the expression is moved to the assignment, its place takes the variable
+	*expression = *element;
+	*element = replacement;
+	parts[0] = variable;
+	treeInit(&parts[1], E_S_EXPRESSION);
+	parts[1].data.elements = expression;
+	parts[1].nodeSize = 1;
+	parts[1].valueTypes = expression->valueTypes;
+	treeElement_t* assign = &hoisted->statements[hoisted->size++];
+	treeInit(assign, E_ASSIGN);
+	assign->data.elements = parts;
+	assign->nodeSize = 2;
+	return true;
+}
+
+/**
+ * Hoists the largest invariant expressions of the loop
+ * @param element element of the loop
+ * @param loop while statement
+ * @param context local scope function name, null view in the top-level code
+ * @param symTable symbol table
+ * @param hoisted hoisted statements
+ * @param errCode error code
+ */
+static void loopHoistExpressions(treeElement_t* element, const treeElement_t* loop, strView_t context,
+		symTable_t* symTable, loopHoisted_t* hoisted, int* errCode) {
+	switch(element->type) {
+		case E_TOKEN:
+			// variables and literals are used directly
+			return;
+		case E_ASSIGN:
+			loopHoistExpressions(&element->data.elements[1], loop, context, symTable, hoisted, errCode);
+			return;
+		case E_S_FUNCTION_CALL:
+		case E_ADD:
+		case E_SUB:
+		case E_MUL:
+		case E_DIV:
+		case E_DIV_INT:
+			if(loopIsInvariant(element, loop)) {
+				if(!loopHoist(element, context, symTable, hoisted)) {
+					*errCode = ERROR_INTERNAL;
+				}
+				return;
+			}
+			if(element->type == E_S_FUNCTION_CALL) {
+				// arguments of the call can be invariant, the name is not an expression
+				if(element->nodeSize > 1) {
+					loopHoistExpressions(&element->data.elements[1], loop, context, symTable, hoisted, errCode);
+				}
+				return;
+			}
+			break;
+		default:
+			break;
+	}
+	for(unsigned int i = 0; i < element->nodeSize && *errCode == ERROR_SUCCESS; i++) {
+		loopHoistExpressions(&element->data.elements[i], loop, context, symTable, hoisted, errCode);
+	}
+}
+
+/**
+ * Hoists invariant expressions of the loops in the code, outer loops first
+ * @param element tree element
+ * @param context local scope function name, null view in the top-level code
+ * @param symTable symbol table
+ * @param errCode error code
+ */
+static void loopHoistCode(treeElement_t* element, strView_t context, symTable_t* symTable, int* errCode) {
+	if(element->type == E_TOKEN) {
+		return;
+	}
+	for(unsigned int i = 0; i < element->nodeSize && *errCode == ERROR_SUCCESS; i++) {
+		treeElement_t* statement = &element->data.elements[i];
+		if(element->type == E_CODE_BLOCK && statement->type == E_S_WHILE) {
+			loopHoisted_t hoisted = {.statements = NULL, .size = 0, .capacity = 0};
+			loopHoistExpressions(statement, statement, context, symTable, &hoisted, errCode);
+			if(hoisted.size > 0 && *errCode == ERROR_SUCCESS) {
+				// the loop follows the hoisted assignments
+				if(!loopReserve(&hoisted)) {
+					*errCode = ERROR_INTERNAL;
+				} else {
+					hoisted.statements[hoisted.size++] = *statement;
+					statement->data.elements = NULL;
+					statement->nodeSize = 0;
+					if(treeReplaceElement(element, i, hoisted.statements, hoisted.size)) {
+						i += hoisted.size - 1;
+						hoisted.size = 0;
+					} else {
+						element->data.elements[i] = hoisted.statements[--hoisted.size];
+						*errCode = ERROR_INTERNAL;
+					}
+				}
+			}
+			for(unsigned int j = 0; j < hoisted.size; j++) {
+				treeFree(hoisted.statements[j]);
+			}
+			free(hoisted.statements);
+		}
+		loopHoistCode(&element->data.elements[i], context, symTable, errCode);
+	}
+}
+
+void loopHoistInvariants(treeElement_t* codeElement, symTable_t* symTable, int* errCode) {
+	if(codeElement->type != E_CODE) {
+		*errCode = ERROR_INTERNAL;
+		return;
+	}
+
+	for(unsigned int i = 0; i < codeElement->nodeSize && *errCode == ERROR_SUCCESS; i++) {
+		treeElement_t* element = &codeElement->data.elements[i];
+		if(element->type == E_CODE_BLOCK) {
+			loopHoistCode(element, strViewNull(), symTable, errCode);
+		} else if(element->type == E_S_FUNCTION_DEF) {
+			// temporary variables are local in the function body
+			strView_t context = strViewDynStr(element->data.elements[0].data.token->data.strval);
+			loopHoistCode(&element->data.elements[element->nodeSize - 1], context, symTable, errCode);
+		}
+	}
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#pragma once
+
+#include "parse_tree.h"
+#include "symtable.h"
+
+/**
+ * Moves loop-invariant expressions out of while loops. An expression is invariant if no variable it reads
+ * is assigned in the loop, it is hoisted only if it can't fail nor have a side effect (types of its operands
+ * are known and it calls no function except len), so it can be evaluated even if the loop doesn't run.
+ * The value is assigned to a new temporary variable before the loop. The tree must have inferred types.
+ * @param codeElement tree element containing the program code
+ * @param symTable symbol table, temporary variables are added to it
+ * @param errCode error code
+ */
+void loopHoistInvariants(treeElement_t* codeElement, symTable_t* symTable, int* errCode);
@@ -17,24 +17,39 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "constant_propagation.h"
 #include "error.h"
 #include "inter_code_generator.h"
+#include "loop_invariant.h"
 #include "parser.h"
 #include "semantic_analysis.h"
+#include "type_inference.h"
 
 /**
  * Main function
  * @param argc Argument count
- * @param argv Arguments
+ * @param argv Arguments: [-O<level>] [-v] [-fstack-calls] [file]
  * @return Execution status
  */
 int main(int argc, char *argv[]) {
 	FILE* file = stdin;
-	if (argc == 2) {
-		file = fopen(argv[1], "r");
-	}
-	if (file == NULL) {
-		file = stdin;
+	codeOptions_t options = {.optimization = 0, .verbose = false, .stackCalls = false};
+	for (int i = 1; i < argc; ++i) {
+		if (strncmp(argv[i], "-O", 2) == 0) {
+			// -O alone means the first level
+			options.optimization = argv[i][2] == '\0' ? 1 : (unsigned) strtoul(argv[i] + 2, NULL, 10);
+		} else if (strcmp(argv[i], "-v") == 0) {
+			options.verbose = true;
+		} else if (strcmp(argv[i], "-fstack-calls") == 0) {
+			options.stackCalls = true;
+		} else if (file == stdin) {
+			file = fopen(argv[i], "r");
+			if (file == NULL) {
+				file = stdin;
+			}
+		}
 	}
 	symTable_t* symTable = symTableInit();
 	symTableInsertEmbedFunctions(symTable);
@@ -48,6 +63,21 @@ int main(int argc, char *argv[]) {
     }
 
     semanticCheck(&tree, symTable, &errCode);
+	if(errCode == ERROR_SUCCESS && options.optimization > 0){
+		semanticFold(&tree, &errCode);
+		if(errCode == ERROR_SUCCESS){
+			constPropagate(&tree, &errCode);
+		}
+		if(errCode == ERROR_SUCCESS){
+			typeInfer(&tree, &errCode);
+		}
+		if(errCode == ERROR_SUCCESS){
+			loopHoistInvariants(&tree, symTable, &errCode);
+		}
+		if(errCode == ERROR_SUCCESS){
+			semanticMarkReachable(&tree, symTable);
+		}
+	}
 	if(errCode != ERROR_SUCCESS){
 		treeFree(tree);
 		symTableFree(symTable);
@@ -55,7 +85,7 @@ int main(int argc, char *argv[]) {
 		return errCode;
 	}
 
-	int retval = processCode(tree, symTable);
+	int retval = processCode(tree, symTable, &options);
 	symTableFree(symTable);
 	treeFree(tree);
     fclose(file);
@@ -22,6 +22,8 @@ void treeInit(treeElement_t* tree, treeElementType_t elementType) {
     tree->type = elementType;
     tree->data.elements = NULL;
     tree->nodeSize = 0;
+    tree->symbol = NULL;
+    tree->valueTypes = 0;
 }
 
 treeElement_t* treeAddElement(treeElement_t* treeNode, treeElementType_t type) {
@@ -66,11 +68,86 @@ bool treeAddToken(treeElement_t* tree, token_t token) {
     return tree;
 }
 
+bool treeCopy(treeElement_t* destination, const treeElement_t* source) {
+	if(destination == NULL || source == NULL)
+		return false;
+
+	if(source->type == E_TOKEN) {
+		token_t token = *source->data.token;
+		switch(token.type) {
+			case T_STRING:
+			case T_STRING_ML:
+				token.operand = dynStrClone(source->data.token->operand);
+				if(token.operand == NULL)
+					return false;
+				// fall through
+			case T_ID:
+				token.data.strval = dynStrClone(source->data.token->data.strval);
+				if(token.data.strval == NULL) {
+					dynStrFree(token.operand);
+					return false;
+				}
+				break;
+			default:
+				break;
+		}
+		initTokenTreeElement(destination, token);
+		destination->symbol = source->symbol;
+		destination->valueTypes = source->valueTypes;
+		return true;
+	}
+
+	treeInit(destination, source->type);
+	destination->symbol = source->symbol;
+	destination->valueTypes = source->valueTypes;
+	for(unsigned int i = 0; i < source->nodeSize; i++) {
+		treeElement_t element;
+		if(!treeCopy(&element, &source->data.elements[i]))
+			break;
+		if(treeInsertElement(destination, element) == NULL) {
+			treeFree(element);
+			break;
+		}
+	}
+	if(destination->nodeSize != source->nodeSize) {
+		treeFree(*destination);
+		return false;
+	}
+	return true;
+}
+
+bool treeReplaceElement(treeElement_t* treeNode, unsigned int index, treeElement_t* elements, unsigned int count) {
+	if(treeNode == NULL || treeNode->type == E_TOKEN || index >= treeNode->nodeSize)
+		return false;
+
+	unsigned int size = treeNode->nodeSize - 1 + count;
+	treeElement_t* array = NULL;
+	if(size > 0) {
+		array = malloc(sizeof(treeElement_t) * size);
+		if(array == NULL)
+			return false;
+		memcpy(array, treeNode->data.elements, sizeof(treeElement_t) * index);
+		if(count > 0)
+			memcpy(array + index, elements, sizeof(treeElement_t) * count);
+		memcpy(array + index + count, treeNode->data.elements + index + 1,
+				sizeof(treeElement_t) * (treeNode->nodeSize - index - 1));
+	}
+
+	treeFree(treeNode->data.elements[index]);
+	free(treeNode->data.elements);
+	treeNode->data.elements = array;
+	treeNode->nodeSize = size;
+	return true;
+}
+
 void treeFree(treeElement_t tree) {
     if (tree.type == E_TOKEN) {
         switch(tree.data.token->type){
             case T_STRING:
             case T_STRING_ML:
+                dynStrFree(tree.data.token->operand);
+                dynStrFree(tree.data.token->data.strval);
+                break;
             case T_ID:
                 dynStrFree(tree.data.token->data.strval);
                 break;
@@ -92,6 +169,8 @@ void treeFree(treeElement_t tree) {
 void initTokenTreeElement(treeElement_t* element, token_t token) {
 	element->type = E_TOKEN;
 	element->nodeSize = 0;
+	element->symbol = NULL;
+	element->valueTypes = 0;
 	element->data.token = malloc(sizeof(token));
 	memcpy(element->data.token, &token, sizeof(token));
 }
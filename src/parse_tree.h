@@ -19,6 +19,7 @@
 #pragma once
 
 #include "scanner.h"
+#include "symtable.h"
 
 enum treeElementType {
 	E_ADD = T_OP_ADD,
@@ -55,6 +56,18 @@ enum treeElementType {
 
 typedef enum treeElementType treeElementType_t;
 
+// Value types inferred by the type inference, combined into a set of possible types
+enum valueType {
+	VALUE_INT = 1,
+	VALUE_FLOAT = 2,
+	VALUE_STRING = 4,
+	VALUE_BOOL = 8,
+	VALUE_NONE = 16,
+	VALUE_UNKNOWN = 31 // value can be of any type
+};
+
+typedef enum valueType valueType_t;
+
 typedef struct treeElement treeElement_t;
 
 union treeElementData {
@@ -67,6 +80,8 @@ struct treeElement {
     treeElementType_t type;
     union treeElementData data;
     unsigned int nodeSize;
+    symbol_t* symbol; // identifier symbol resolved by the semantic analysis
+    unsigned int valueTypes; // set of possible types of the expression value, 0 if not inferred
 };
 
 /**
@@ -94,6 +109,24 @@ treeElement_t* treeAddElement(treeElement_t* treeNode, treeElementType_t treeEle
  */
 treeElement_t* treeInsertElement(treeElement_t* treeNode, treeElement_t element);
 
+/**
+ * Creates deep copy of the tree
+ * @param destination tree element to copy to
+ * @param source tree to copy
+ * @return copy successful
+ */
+bool treeCopy(treeElement_t* destination, const treeElement_t* source);
+
+/**
+ * Replaces sub-node by the elements, the replaced sub-node is freed
+ * @param treeNode node in which replace
+ * @param index index of the replaced sub-node
+ * @param elements elements moved to the node (the array itself is not taken)
+ * @param count number of the elements, sub-node is removed if zero
+ * @return replacement successful
+ */
+bool treeReplaceElement(treeElement_t* treeNode, unsigned int index, treeElement_t* elements, unsigned int count);
+
 /**
  * Recursively frees the tree
  * @param tree tree to free
@@ -220,8 +220,8 @@ int parseFunctionDefParams(tokenStack_t* stack, treeElement_t* tree, symTable_t*
 	                return ERROR_INTERNAL;
                 }
 
-                dynStrListPushBack(params, dynStrClone(token.data.strval));
-                errCode = symTableInsertVariable(symTable, token.data.strval, funcName, false);
+                dynStrListPushBackView(params, strViewDynStr(token.data.strval));
+                errCode = symTableInsertVariable(symTable, strViewDynStr(token.data.strval), strViewDynStr(funcName), false);
             	if(errCode != ERROR_SUCCESS) { //Insert parameter as local variable
 		            dynStrListFree(params);
 		            return errCode;
@@ -252,7 +252,7 @@ int parseFunctionDefParams(tokenStack_t* stack, treeElement_t* tree, symTable_t*
         }
     }
 
-    errCode = symTableInsertFunctionDefinition(symTable, funcName, paramCount, params);
+    errCode = symTableInsertFunctionDefinition(symTable, strViewDynStr(funcName), paramCount, params);
 	if (errCode != ERROR_SUCCESS) { //Symtable insert function definition
 		return errCode;
 	}
@@ -524,7 +524,8 @@ int parseExpression(tokenStack_t* stack, treeElement_t* tree, symTable_t* symTab
 					treeStackFree(precedenceStack);
 					return ERROR_SUCCESS;
 				}
-				treeStackPop(precedenceStack); // Pop ( operator from stack
+				treeFree(treeStackPop(precedenceStack)); // Pop ( operator from stack
+				treeFree(element); // ) operator is not needed either
 			} else {
 				treeStackPush(precedenceStack, element); //Push operator to stack after popping
 			}
@@ -815,7 +816,7 @@ int parseFunctionCallParams(tokenStack_t* stack, treeElement_t* tree, symTable_t
 		}
     }
 
-    errCode = symTableInsertFunction(symTable, functionName, paramCount);
+    errCode = symTableInsertFunction(symTable, strViewDynStr(functionName), paramCount);
     if(errCode != ERROR_SUCCESS)
 		return errCode;
 
@@ -860,7 +861,7 @@ int parseAssignment(tokenStack_t* stack, treeElement_t* tree, symTable_t* symTab
 	if(errCode != ERROR_SUCCESS)
 		return errCode;
 
-	errCode = symTableInsertVariable(symTable, token.data.strval, context, false);
+	errCode = symTableInsertVariable(symTable, strViewDynStr(token.data.strval), strViewDynStr(context), false);
 	if(errCode != ERROR_SUCCESS)
 		return errCode;
 
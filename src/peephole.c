@@ -0,0 +1,391 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "peephole.h"
+
+/**
+ * Peephole rule, matches a window at the end of the instruction stream
+ */
+typedef struct peephole_rule {
+	const char *name;
+	size_t window; // number of the matched instructions
+	/**
+	 * Rewrites the window in place
+	 * @param window Matched instructions
+	 * @param count Number of instructions after the rewrite
+	 * @return True if the rule was applied
+	 */
+	bool (*apply)(irInstruction_t *window, size_t *count);
+} peepholeRule_t;
+
+/**
+ * Checks if the operand is a constant
+ * @param operand Operand
+ * @return Is the operand constant?
+ */
+static bool peepholeIsConstant(const irOperand_t *operand) {
+	return operand->type != IR_OPERAND_VARIABLE && operand->type != IR_OPERAND_LABEL
+		&& operand->type != IR_OPERAND_TYPE;
+}
+
+/**
+ * Returns the non-stack version of the stack instruction
+ * @param opcode Stack instruction opcode
+ * @return Instruction opcode, IR_OPCODE_COUNT if the instruction has no such version
+ */
+static irOpcode_t peepholeStackOpcode(irOpcode_t opcode) {
+	switch (opcode) {
+		case IR_ADDS:
+			return IR_ADD;
+		case IR_SUBS:
+			return IR_SUB;
+		case IR_MULS:
+			return IR_MUL;
+		case IR_DIVS:
+			return IR_DIV;
+		case IR_IDIVS:
+			return IR_IDIV;
+		case IR_LTS:
+			return IR_LT;
+		case IR_GTS:
+			return IR_GT;
+		case IR_EQS:
+			return IR_EQ;
+		case IR_ANDS:
+			return IR_AND;
+		case IR_ORS:
+			return IR_OR;
+		case IR_NOTS:
+			return IR_NOT;
+		case IR_INT2FLOATS:
+			return IR_INT2FLOAT;
+		case IR_FLOAT2INTS:
+			return IR_FLOAT2INT;
+		case IR_INT2CHARS:
+			return IR_INT2CHAR;
+		case IR_STRI2INTS:
+			return IR_STRI2INT;
+		case IR_JUMPIFEQS:
+			return IR_JUMPIFEQ;
+		case IR_JUMPIFNEQS:
+			return IR_JUMPIFNEQ;
+		default:
+			return IR_OPCODE_COUNT;
+	}
+}
+
+/**
+ * Evaluates equality of two constants
+ * @param operand1 First operand
+ * @param operand2 Second operand
+ * @param equal Result of the comparison
+ * @return False if the result is not known at compile time
+ */
+static bool peepholeConstantEqual(const irOperand_t *operand1, const irOperand_t *operand2, bool *equal) {
+	if (!peepholeIsConstant(operand1) || !peepholeIsConstant(operand2)) {
+		return false;
+	}
+	// nil can be compared with anything
+	if (operand1->type == IR_OPERAND_NIL || operand2->type == IR_OPERAND_NIL) {
+		*equal = operand1->type == operand2->type;
+		return true;
+	}
+	// comparison of different types is a runtime error
+	if (operand1->type != operand2->type) {
+		return false;
+	}
+	if (operand1->type == IR_OPERAND_FLOAT) {
+		if (isnan(operand1->data.floatval) || isnan(operand2->data.floatval)) {
+			return false;
+		}
+		*equal = operand1->data.floatval == operand2->data.floatval;
+		return true;
+	}
+	// strings are escaped canonically, so equal strings have equal operands
+	*equal = irOperandEqual(operand1, operand2);
+	return true;
+}
+
+/**
+ * Moves definition before the stack instruction, so that the stack instructions can be fused
+ */
+static bool peepholeDefvarHoist(irInstruction_t *window, size_t *count) {
+	if (window[1].opcode != IR_DEFVAR) {
+		return false;
+	}
+	if (window[0].opcode == IR_PUSHS) {
+		if (irOperandEqual(&window[0].operands[0], &window[1].operands[0])) {
+			return false;
+		}
+	} else if (irOpcodeOperands(window[0].opcode) != 0 || peepholeStackOpcode(window[0].opcode) == IR_OPCODE_COUNT) {
+		return false;
+	}
+	irInstruction_t instruction = window[0];
+	window[0] = window[1];
+	window[1] = instruction;
+	*count = 2;
+	return true;
+}
+
+/**
+ * Replaces push and pop by move
+ */
+static bool peepholePushPop(irInstruction_t *window, size_t *count) {
+	if (window[0].opcode != IR_PUSHS || window[1].opcode != IR_POPS) {
+		return false;
+	}
+	irInstruction_t move = {.opcode = IR_MOVE, .operands = {window[1].operands[0], window[0].operands[0]}};
+	window[0] = move;
+	*count = 1;
+	return true;
+}
+
+/**
+ * Replaces unary stack operation by the three address one
+ */
+static bool peepholeStackUnary(irInstruction_t *window, size_t *count) {
+	if (window[0].opcode != IR_PUSHS || window[2].opcode != IR_POPS) {
+		return false;
+	}
+	irOpcode_t opcode = peepholeStackOpcode(window[1].opcode);
+	if (opcode == IR_OPCODE_COUNT || irOpcodeOperands(opcode) != 2) {
+		return false;
+	}
+	irInstruction_t instruction = {.opcode = opcode, .operands = {window[2].operands[0], window[0].operands[0]}};
+	window[0] = instruction;
+	*count = 1;
+	return true;
+}
+
+/**
+ * Replaces binary stack operation by the three address one
+ */
+static bool peepholeStackBinary(irInstruction_t *window, size_t *count) {
+	if (window[0].opcode != IR_PUSHS || window[1].opcode != IR_PUSHS || window[3].opcode != IR_POPS) {
+		return false;
+	}
+	irOpcode_t opcode = peepholeStackOpcode(window[2].opcode);
+	if (opcode == IR_OPCODE_COUNT || opcode == IR_JUMPIFEQ || opcode == IR_JUMPIFNEQ
+		|| irOpcodeOperands(opcode) != 3) {
+		return false;
+	}
+	irInstruction_t instruction = {.opcode = opcode,
+		.operands = {window[3].operands[0], window[0].operands[0], window[1].operands[0]}};
+	window[0] = instruction;
+	*count = 1;
+	return true;
+}
+
+/**
+ * Replaces stack conditional jump by the jump comparing operands
+ */
+static bool peepholeStackBranch(irInstruction_t *window, size_t *count) {
+	if (window[0].opcode != IR_PUSHS || window[1].opcode != IR_PUSHS
+		|| (window[2].opcode != IR_JUMPIFEQS && window[2].opcode != IR_JUMPIFNEQS)) {
+		return false;
+	}
+	irInstruction_t jump = {.opcode = peepholeStackOpcode(window[2].opcode),
+		.operands = {window[2].operands[0], window[0].operands[0], window[1].operands[0]}};
+	window[0] = jump;
+	*count = 1;
+	return true;
+}
+
+/**
+ * Replaces conditional jump comparing constants by a jump or removes it
+ */
+static bool peepholeConstantBranch(irInstruction_t *window, size_t *count) {
+	if (window[0].opcode != IR_JUMPIFEQ && window[0].opcode != IR_JUMPIFNEQ) {
+		return false;
+	}
+	bool equal;
+	if (!peepholeConstantEqual(&window[0].operands[1], &window[0].operands[2], &equal)) {
+		return false;
+	}
+	if (equal != (window[0].opcode == IR_JUMPIFEQ)) {
+		*count = 0;
+		return true;
+	}
+	window[0].opcode = IR_JUMP;
+	*count = 1;
+	return true;
+}
+
+/**
+ * Removes jump to the immediately following label
+ */
+static bool peepholeJumpNext(irInstruction_t *window, size_t *count) {
+	if (window[0].opcode != IR_JUMP || window[1].opcode != IR_LABEL
+		|| !irOperandEqual(&window[0].operands[0], &window[1].operands[0])) {
+		return false;
+	}
+	window[0] = window[1];
+	*count = 1;
+	return true;
+}
+
+/**
+ * Removes instructions after the unconditional jump, which are not labeled
+ */
+static bool peepholeUnreachable(irInstruction_t *window, size_t *count) {
+	if (window[0].opcode != IR_JUMP && window[0].opcode != IR_RETURN && window[0].opcode != IR_EXIT) {
+		return false;
+	}
+	if (window[1].opcode == IR_LABEL) {
+		return false;
+	}
+	*count = 1;
+	return true;
+}
+
+/**
+ * Removes move of a constant which is overwritten by the next move
+ */
+static bool peepholeDeadMove(irInstruction_t *window, size_t *count) {
+	if (window[0].opcode != IR_MOVE || window[1].opcode != IR_MOVE
+		|| !peepholeIsConstant(&window[0].operands[1])
+		|| !irOperandEqual(&window[0].operands[0], &window[1].operands[0])
+		|| irOperandEqual(&window[1].operands[0], &window[1].operands[1])) {
+		return false;
+	}
+	window[0] = window[1];
+	*count = 1;
+	return true;
+}
+
+/// Peephole rules
+static const peepholeRule_t peepholeRules[PEEPHOLE_RULE_COUNT] = {
+	[PEEPHOLE_DEFVAR_HOIST] = {"defvar-hoist", 2, peepholeDefvarHoist},
+	[PEEPHOLE_PUSH_POP] = {"push-pop", 2, peepholePushPop},
+	[PEEPHOLE_STACK_UNARY] = {"stack-unary", 3, peepholeStackUnary},
+	[PEEPHOLE_STACK_BINARY] = {"stack-binary", 4, peepholeStackBinary},
+	[PEEPHOLE_STACK_BRANCH] = {"stack-branch", 3, peepholeStackBranch},
+	[PEEPHOLE_CONSTANT_BRANCH] = {"constant-branch", 1, peepholeConstantBranch},
+	[PEEPHOLE_JUMP_NEXT] = {"jump-next", 2, peepholeJumpNext},
+	[PEEPHOLE_UNREACHABLE] = {"unreachable", 2, peepholeUnreachable},
+	[PEEPHOLE_DEAD_MOVE] = {"dead-move", 2, peepholeDeadMove},
+};
+
+const char* peepholeRuleName(peepholeRuleId_t rule) {
+	return rule < PEEPHOLE_RULE_COUNT ? peepholeRules[rule].name : NULL;
+}
+
+/**
+ * Applies the rules to the windows ending at the given position until none of them matches
+ * @param stream Instruction stream
+ * @param size Number of instructions in the stream
+ * @param end Position after the last instruction of the windows
+ * @param stats Statistics to update, can be NULL
+ */
+static void peepholeReduce(irInstruction_t *stream, size_t *size, size_t end, peepholeStats_t *stats) {
+	bool applied = true;
+	while (applied) {
+		applied = false;
+		for (unsigned rule = 0; rule < PEEPHOLE_RULE_COUNT; ++rule) {
+			size_t window = peepholeRules[rule].window;
+			if (end < window) {
+				continue;
+			}
+			irInstruction_t *begin = stream + end - window;
+			size_t count = window;
+			if (!peepholeRules[rule].apply(begin, &count)) {
+				continue;
+			}
+			// close the gap after the rewritten window
+			memmove(begin + count, stream + end, (*size - end) * sizeof(irInstruction_t));
+			*size -= window - count;
+			end -= window - count;
+			if (stats != NULL) {
+				stats->applied[rule]++;
+				stats->removed[rule] += window - count;
+			}
+			if (count == window && end > 1) {
+				// reordered instruction can match the rules before the end of the window
+				size_t previous = *size;
+				peepholeReduce(stream, size, end - 1, stats);
+				end -= previous - *size;
+			}
+			applied = true;
+			break;
+		}
+	}
+}
+
+bool peepholeOptimizeFunction(irFunction_t *function, peepholeStats_t *stats) {
+	if (function == NULL) {
+		return false;
+	}
+	// preformatted code is not optimized
+	if (!strViewIsNull(function->code)) {
+		return true;
+	}
+	size_t count = 0;
+	for (const irBlock_t *block = function->first; block != NULL; block = block->next) {
+		count += block->count;
+	}
+	if (count == 0) {
+		return true;
+	}
+	irInstruction_t *stream = malloc(count * sizeof(irInstruction_t));
+	if (stream == NULL) {
+		return false;
+	}
+	// rules never make the stream longer
+	size_t size = 0;
+	for (const irBlock_t *block = function->first; block != NULL; block = block->next) {
+		for (size_t i = 0; i < block->count; ++i) {
+			stream[size++] = block->instructions[i];
+			peepholeReduce(stream, &size, size, stats);
+		}
+	}
+	// rebuild the basic blocks
+	irPosition_t begin = {.block = NULL, .index = 0};
+	bool success = irFunctionTruncate(function, begin);
+	for (size_t i = 0; success && i < size; ++i) {
+		success = irEmitInstruction(function, &stream[i]);
+	}
+	free(stream);
+	return success;
+}
+
+bool peepholeOptimize(irProgram_t *program, peepholeStats_t *stats) {
+	if (program == NULL) {
+		return false;
+	}
+	for (irFunction_t *function = program->first; function != NULL; function = function->next) {
+		if (!peepholeOptimizeFunction(function, stats)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void peepholePrintStats(FILE *file, const peepholeStats_t *stats) {
+	size_t total = 0;
+	for (unsigned rule = 0; rule < PEEPHOLE_RULE_COUNT; ++rule) {
+		fprintf(file, "peephole: %-16s applied %zu, removed %zu\n", peepholeRules[rule].name,
+			stats->applied[rule], stats->removed[rule]);
+		total += stats->removed[rule];
+	}
+	fprintf(file, "peephole: %zu instructions removed\n", total);
+}
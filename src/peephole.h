@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include "intermediate_code.h"
+
+/**
+ * Peephole optimization rules
+ */
+typedef enum peephole_rule_id {
+	PEEPHOLE_DEFVAR_HOIST, // PUSHS x; DEFVAR y -> DEFVAR y; PUSHS x
+	PEEPHOLE_PUSH_POP, // PUSHS x; POPS y -> MOVE y x
+	PEEPHOLE_STACK_UNARY, // PUSHS x; NOTS; POPS y -> NOT y x
+	PEEPHOLE_STACK_BINARY, // PUSHS x; PUSHS z; ADDS; POPS y -> ADD y x z
+	PEEPHOLE_STACK_BRANCH, // PUSHS x; PUSHS y; JUMPIFEQS L -> JUMPIFEQ L x y
+	PEEPHOLE_CONSTANT_BRANCH, // JUMPIFEQ L c1 c2 -> JUMP L or nothing
+	PEEPHOLE_JUMP_NEXT, // JUMP L; LABEL L -> LABEL L
+	PEEPHOLE_UNREACHABLE, // JUMP L; x -> JUMP L
+	PEEPHOLE_DEAD_MOVE, // MOVE y c; MOVE y x -> MOVE y x
+	PEEPHOLE_RULE_COUNT
+} peepholeRuleId_t;
+
+/**
+ * Peephole optimization statistics
+ */
+typedef struct peephole_stats {
+	size_t applied[PEEPHOLE_RULE_COUNT]; // number of rule applications
+	size_t removed[PEEPHOLE_RULE_COUNT]; // number of instructions removed by the rule
+} peepholeStats_t;
+
+/**
+ * Returns name of the peephole rule
+ * @param rule Rule
+ * @return Rule name
+ */
+const char* peepholeRuleName(peepholeRuleId_t rule);
+
+/**
+ * Optimizes instructions of the function
+ * @param function Function to optimize
+ * @param stats Statistics to update, can be NULL
+ * @return Execution status
+ */
+bool peepholeOptimizeFunction(irFunction_t *function, peepholeStats_t *stats);
+
+/**
+ * Optimizes instructions of all the program functions
+ * @param program Program to optimize
+ * @param stats Statistics to update, can be NULL
+ * @return Execution status
+ */
+bool peepholeOptimize(irProgram_t *program, peepholeStats_t *stats);
+
+/**
+ * Prints the statistics report
+ * @param file Output file
+ * @param stats Statistics
+ */
+void peepholePrintStats(FILE *file, const peepholeStats_t *stats);
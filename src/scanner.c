@@ -46,6 +46,7 @@ token_t scan(FILE* file, intStack_t* stack) {
     // create output token and set it to no value
     token_t output_token;
     output_token.data.strval = NULL;
+    output_token.operand = NULL;
     output_token.type = T_ERROR;
 
     // return error if no file is no file is supplied or
@@ -184,6 +185,9 @@ token_t scan(FILE* file, intStack_t* stack) {
             case '\'':
             case '\"':
                 return_status = process_string(file, &output_token, tmp);
+                if (return_status == SUCCESS) {
+                    return_status = process_string_operand(&output_token);
+                }
                 if (return_status == ANALYSIS_FAILED) {
                     output_token.type = T_UNKNOWN;
                 } else if (return_status) {
@@ -629,6 +633,23 @@ int process_string(FILE* file, token_t* token, int qmark) {
 
 }
 
+int process_string_operand(token_t* token) {
+    if (!token || !token->data.strval || token->operand) {
+        return EXECUTION_ERROR;
+    }
+    token->operand = dynStrInit();
+    // the prefix does not contain any character to escape, so the whole operand can be escaped at once
+    if (!dynStrReserve(token->operand, 7 + token->data.strval->size) ||
+        !dynStrAppendBuffer(token->operand, "string@", 7) ||
+        !dynStrAppendBuffer(token->operand, token->data.strval->string, token->data.strval->size) ||
+        !dynStrEscape(token->operand)) {
+        dynStrFree(token->operand);
+        token->operand = NULL;
+        return EXECUTION_ERROR;
+    }
+    return SUCCESS;
+}
+
 int process_escape_seq(FILE* file, token_t *token, int c) {
 	char charCode[4] = "";
 	switch (c) {
@@ -86,6 +86,7 @@ typedef union tokenValue {
 typedef struct token {
     enum token_type type;
     tokenValue_t data;
+    dynStr_t* operand; // escaped IFJcode19 operand (string@...) of string literals, NULL otherwise
 } token_t;
 
 /**
@@ -148,6 +149,14 @@ enum token_type getKeywordType(char* string);
  */
 int process_string(FILE* file, token_t* token, int qmark);
 
+/**
+ * Creates the escaped IFJcode19 operand (string@...) of the scanned string
+ * @param token         pointer to a string token
+ * @returns status: SUCCESS or EXECUTION_ERROR
+ * @pre token.data.strval must contain the string value
+ */
+int process_string_operand(token_t* token);
+
 /**
  * Scans line comment to a token (everything to the end of the line)
  * @param file          source file
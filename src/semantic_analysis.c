@@ -16,9 +16,14 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "semantic_analysis.h"
 
-void semanticCheckTree(treeElement_t* element, symTable_t* symtable, int* errCode, dynStr_t* context) {
+void semanticCheckTree(treeElement_t* element, symTable_t* symtable, int* errCode, strView_t context) {
 	switch (element->type) {
 		case E_S_EXPRESSION:
 			checkExpression(&element->data.elements[0], symtable, errCode, context);
@@ -28,11 +33,11 @@ void semanticCheckTree(treeElement_t* element, symTable_t* symtable, int* errCod
 			break;
 
 		case E_S_FUNCTION_DEF:
-			context = element->data.elements[0].data.token->data.strval;
+			context = strViewDynStr(element->data.elements[0].data.token->data.strval);
 			break;
 
 		case E_ASSIGN:
-			*errCode = symTableInsertVariable(symtable, element->data.elements[0].data.token->data.strval, context, true);
+			*errCode = symTableInsertVariable(symtable, strViewDynStr(element->data.elements[0].data.token->data.strval), context, true);
 			if(*errCode != ERROR_SUCCESS) {
 				return;
 			}
@@ -40,10 +45,18 @@ void semanticCheckTree(treeElement_t* element, symTable_t* symtable, int* errCod
 
 		case E_S_FUNCTION_DEF_PARAMS:
 			for(unsigned int i = 0; i < element->nodeSize; i++){
-				*errCode = symTableInsertVariable(symtable, element->data.elements[i].data.token->data.strval, context, true);
+				*errCode = symTableInsertVariable(symtable, strViewDynStr(element->data.elements[i].data.token->data.strval), context, true);
 				if(*errCode != ERROR_SUCCESS) {
 					return;
 				}
+				element->data.elements[i].symbol = symTableResolve(symtable, strViewDynStr(element->data.elements[i].data.token->data.strval), context);
+			}
+			return;
+
+		case E_TOKEN:
+			// resolve identifier to its symbol once, so code generation doesn't have to look it up
+			if(element->data.token->type == T_ID) {
+				element->symbol = symTableResolve(symtable, strViewDynStr(element->data.token->data.strval), context);
 			}
 			return;
 
@@ -61,7 +74,43 @@ void semanticCheckTree(treeElement_t* element, symTable_t* symtable, int* errCod
 }
 
 void semanticCheck(treeElement_t* parseTree, symTable_t* symTable, int* errCode) {
-	semanticCheckTree(parseTree, symTable, errCode, NULL);
+	semanticCheckTree(parseTree, symTable, errCode, strViewNull());
+}
+
+/**
+ * Marks the functions called in the element as used, bodies of the newly marked functions are walked too
+ * @param element tree element
+ * @param code program code containing the function definitions
+ */
+static void markCalls(treeElement_t* element, treeElement_t* code) {
+	if(element->type == E_TOKEN) {
+		return;
+	}
+	if(element->type == E_S_FUNCTION_CALL) {
+		symbol_t* symbol = element->data.elements[0].symbol;
+		if(symbol != NULL && symbol->type == SYMBOL_FUNCTION && !symbol->used) {
+			symbol->used = true;
+			for(unsigned int i = 0; i < code->nodeSize; i++) {
+				treeElement_t* definition = &code->data.elements[i];
+				if(definition->type == E_S_FUNCTION_DEF && definition->data.elements[0].symbol == symbol) {
+					markCalls(definition, code);
+				}
+			}
+		}
+	}
+	for(unsigned int i = 0; i < element->nodeSize; i++) {
+		markCalls(&element->data.elements[i], code);
+	}
+}
+
+void semanticMarkReachable(treeElement_t* parseTree, symTable_t* symTable) {
+	symTableClearFunctionUsage(symTable);
+	// function definitions are walked only when they are called
+	for(unsigned int i = 0; i < parseTree->nodeSize; i++) {
+		if(parseTree->data.elements[i].type == E_CODE_BLOCK) {
+			markCalls(&parseTree->data.elements[i], parseTree);
+		}
+	}
 }
 
 
@@ -112,7 +161,7 @@ semanticType_t getOperatorType(treeElement_t operatorTree, int* errCode) {
 	}
 }
 
-semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTable, int* errCode, dynStr_t* context){
+semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTable, int* errCode, strView_t context){
 	switch(expressionTree->type) {
 
 		case E_ADD:
@@ -166,7 +215,7 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 						case SEMANTIC_UNKNOWN:
 							return SEMANTIC_UNKNOWN;
 						case SEMANTIC_VARIABLE:
-							if (!symTableIsVariableAssigned(symTable, operator2.data.token->data.strval, context))
+							if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator2.data.token->data.strval), context))
 								*errCode = ERROR_SEMANTIC_FUNCTION;
 							return SEMANTIC_UNKNOWN;
 
@@ -201,7 +250,7 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 
 						case SEMANTIC_UNKNOWN:
 						case SEMANTIC_VARIABLE:
-							if (!symTableIsVariableAssigned(symTable, operator2.data.token->data.strval, context))
+							if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator2.data.token->data.strval), context))
 								*errCode = ERROR_SEMANTIC_FUNCTION;
 							return SEMANTIC_UNKNOWN;
 
@@ -217,7 +266,7 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 
 						case SEMANTIC_UNKNOWN:
 						case SEMANTIC_VARIABLE:
-							if (!symTableIsVariableAssigned(symTable, operator2.data.token->data.strval, context))
+							if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator2.data.token->data.strval), context))
 								*errCode = ERROR_SEMANTIC_FUNCTION;
 							return SEMANTIC_UNKNOWN;
 
@@ -241,13 +290,13 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 					}
 
 				case SEMANTIC_VARIABLE:
-					if (!symTableIsVariableAssigned(symTable, operator1.data.token->data.strval, context)) {
+					if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator1.data.token->data.strval), context)) {
 						*errCode = ERROR_SEMANTIC_FUNCTION;
 						return SEMANTIC_UNKNOWN;
 					}
 
 					if(op2Type == SEMANTIC_VARIABLE) {
-						if (!symTableIsVariableAssigned(symTable, operator2.data.token->data.strval, context)) {
+						if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator2.data.token->data.strval), context)) {
 							*errCode = ERROR_SEMANTIC_FUNCTION;
 							return SEMANTIC_UNKNOWN;
 						}
@@ -258,7 +307,7 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 
 				case SEMANTIC_UNKNOWN:
 					if(op2Type == SEMANTIC_VARIABLE) {
-						if (!symTableIsVariableAssigned(symTable, operator2.data.token->data.strval, context)) {
+						if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator2.data.token->data.strval), context)) {
 							*errCode = ERROR_SEMANTIC_FUNCTION;
 							return SEMANTIC_UNKNOWN;
 						}
@@ -335,7 +384,7 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 						case SEMANTIC_UNKNOWN:
 							return SEMANTIC_UNKNOWN;
 						case SEMANTIC_VARIABLE:
-							if (!symTableIsVariableAssigned(symTable, operator2.data.token->data.strval, context))
+							if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator2.data.token->data.strval), context))
 								*errCode = ERROR_SEMANTIC_FUNCTION;
 							return SEMANTIC_UNKNOWN;
 
@@ -370,7 +419,7 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 
 						case SEMANTIC_UNKNOWN:
 						case SEMANTIC_VARIABLE:
-							if (!symTableIsVariableAssigned(symTable, operator2.data.token->data.strval, context))
+							if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator2.data.token->data.strval), context))
 								*errCode = ERROR_SEMANTIC_FUNCTION;
 							return (expressionTree->type == E_DIV)? SEMANTIC_FLOAT : SEMANTIC_INT;
 
@@ -386,7 +435,7 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 
 						case SEMANTIC_UNKNOWN:
 						case SEMANTIC_VARIABLE:
-							if (!symTableIsVariableAssigned(symTable, operator2.data.token->data.strval, context))
+							if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator2.data.token->data.strval), context))
 								*errCode = ERROR_SEMANTIC_FUNCTION;
 							return SEMANTIC_UNKNOWN;
 
@@ -409,13 +458,13 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 					}
 
 				case SEMANTIC_VARIABLE:
-					if (!symTableIsVariableAssigned(symTable, operator1.data.token->data.strval, context)) {
+					if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator1.data.token->data.strval), context)) {
 						*errCode = ERROR_SEMANTIC_FUNCTION;
 						return SEMANTIC_UNKNOWN;
 					}
 
 					if(op2Type == SEMANTIC_VARIABLE) {
-						if (!symTableIsVariableAssigned(symTable, operator2.data.token->data.strval, context)) {
+						if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator2.data.token->data.strval), context)) {
 							*errCode = ERROR_SEMANTIC_FUNCTION;
 							return SEMANTIC_UNKNOWN;
 						}
@@ -426,7 +475,7 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 
 				case SEMANTIC_UNKNOWN:
 					if(op2Type == SEMANTIC_VARIABLE) {
-						if (!symTableIsVariableAssigned(symTable, operator2.data.token->data.strval, context)) {
+						if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator2.data.token->data.strval), context)) {
 							*errCode = ERROR_SEMANTIC_FUNCTION;
 							return SEMANTIC_UNKNOWN;
 						}
@@ -452,7 +501,7 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 				return SEMANTIC_UNKNOWN;
 
 			if(op1Type == SEMANTIC_VARIABLE) {
-				if (!symTableIsVariableAssigned(symTable, operator1.data.token->data.strval, context))
+				if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator1.data.token->data.strval), context))
 					*errCode = ERROR_SEMANTIC_FUNCTION;
 				return SEMANTIC_UNKNOWN;
 			} else if(op1Type == SEMANTIC_UNKNOWN) {
@@ -509,7 +558,7 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 						case SEMANTIC_UNKNOWN:
 							return SEMANTIC_UNKNOWN;
 						case SEMANTIC_VARIABLE:
-							if (!symTableIsVariableAssigned(symTable, operator2.data.token->data.strval, context))
+							if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator2.data.token->data.strval), context))
 								*errCode = ERROR_SEMANTIC_FUNCTION;
 							return SEMANTIC_UNKNOWN;
 
@@ -550,7 +599,7 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 
 						case SEMANTIC_UNKNOWN:
 						case SEMANTIC_VARIABLE:
-							if (!symTableIsVariableAssigned(symTable, operator2.data.token->data.strval, context))
+							if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator2.data.token->data.strval), context))
 								*errCode = ERROR_SEMANTIC_FUNCTION;
 							return SEMANTIC_UNKNOWN;
 
@@ -574,7 +623,7 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 
 						case SEMANTIC_UNKNOWN:
 						case SEMANTIC_VARIABLE:
-							if (!symTableIsVariableAssigned(symTable, operator2.data.token->data.strval, context))
+							if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator2.data.token->data.strval), context))
 								*errCode = ERROR_SEMANTIC_FUNCTION;
 							return SEMANTIC_UNKNOWN;
 
@@ -591,13 +640,13 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 					}
 
 				case SEMANTIC_VARIABLE:
-					if (!symTableIsVariableAssigned(symTable, operator1.data.token->data.strval, context)) {
+					if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator1.data.token->data.strval), context)) {
 						*errCode = ERROR_SEMANTIC_FUNCTION;
 						return SEMANTIC_UNKNOWN;
 					}
 
 					if (op2Type == SEMANTIC_VARIABLE){
-						if (!symTableIsVariableAssigned(symTable, operator2.data.token->data.strval, context)) {
+						if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator2.data.token->data.strval), context)) {
 							*errCode = ERROR_SEMANTIC_FUNCTION;
 							return SEMANTIC_UNKNOWN;
 						}
@@ -641,7 +690,7 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 			}
 
 			if(op1Type == SEMANTIC_VARIABLE) {
-				if (!symTableIsVariableAssigned(symTable, operator1.data.token->data.strval, context))
+				if (!symTableIsVariableAssigned(symTable, strViewDynStr(operator1.data.token->data.strval), context))
 					*errCode = ERROR_SEMANTIC_FUNCTION;
 				return SEMANTIC_UNKNOWN;
 			} else if(op1Type == SEMANTIC_UNKNOWN) {
@@ -666,7 +715,7 @@ semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTab
 				case T_STRING:
 					return SEMANTIC_STRING;
 				case T_ID:
-					if (!symTableIsVariableAssigned(symTable, expressionTree->data.token->data.strval, context)) {
+					if (!symTableIsVariableAssigned(symTable, strViewDynStr(expressionTree->data.token->data.strval), context)) {
 						*errCode = ERROR_SEMANTIC_FUNCTION;
 						return SEMANTIC_UNKNOWN;
 					}
@@ -733,3 +782,366 @@ void convertBoolToInt(treeElement_t* element, int* errCode) {
 		}
 	}
 }
+
+token_t* getLiteral(treeElement_t* element) {
+	while(element->type == E_S_EXPRESSION && element->nodeSize == 1) {
+		element = &element->data.elements[0];
+	}
+	if(element->type != E_TOKEN) {
+		return NULL;
+	}
+	switch(element->data.token->type) {
+		case T_NUMBER:
+		case T_FLOAT:
+		case T_STRING:
+		case T_STRING_ML:
+		case T_BOOL_TRUE:
+		case T_BOOL_FALSE:
+		case T_KW_NONE:
+			return element->data.token;
+		default:
+			return NULL;
+	}
+}
+
+/**
+ * Returns numeric value of the literal, booleans are numbers in arithmetic
+ * @param token literal token
+ * @param isFloat tells if the number is float
+ * @param intval integer value
+ * @param floatval float value (integer value converted to float for integers)
+ * @return true if the literal is a number
+ */
+static bool foldGetNumber(token_t* token, bool* isFloat, long* intval, double* floatval) {
+	switch(token->type) {
+		case T_NUMBER:
+			*intval = token->data.intval;
+			break;
+		case T_BOOL_TRUE:
+		case T_BOOL_FALSE:
+			*intval = (token->type == T_BOOL_TRUE)? 1 : 0;
+			break;
+		case T_FLOAT:
+			*isFloat = true;
+			*floatval = token->data.floatval;
+			return true;
+		default:
+			return false;
+	}
+	*isFloat = false;
+	*floatval = (double) *intval;
+	return true;
+}
+
+/**
+ * Checks if the literal is numeric zero
+ * @param token literal token
+ * @return is the literal zero?
+ */
+static bool foldIsZero(token_t* token) {
+	bool isFloat;
+	long intval;
+	double floatval;
+	if(!foldGetNumber(token, &isFloat, &intval, &floatval)) {
+		return false;
+	}
+	return isFloat? floatval == 0.0 : intval == 0;
+}
+
+/**
+ * Checks if the literal is string
+ * @param token literal token
+ * @return is the literal string?
+ */
+static bool foldIsString(token_t* token) {
+	return token->type == T_STRING || token->type == T_STRING_ML;
+}
+
+/**
+ * Compares string literals
+ * @param left left operand
+ * @param right right operand
+ * @return negative, zero or positive number as strcmp
+ */
+static int foldCompareStrings(token_t* left, token_t* right) {
+	size_t leftSize = left->data.strval->size;
+	size_t rightSize = right->data.strval->size;
+	int result = memcmp(left->data.strval->string, right->data.strval->string,
+			(leftSize < rightSize)? leftSize : rightSize);
+	if(result != 0) {
+		return result;
+	}
+	return (leftSize > rightSize) - (leftSize < rightSize);
+}
+
+/**
+ * Computes integer arithmetic, overflows are left to the run time
+ * @param type operation
+ * @param left left operand
+ * @param right right operand
+ * @param result result
+ * @return true if the result was computed
+ */
+static bool foldIntArithmetic(treeElementType_t type, long left, long right, long* result) {
+	switch(type) {
+		case E_ADD:
+			if((right > 0 && left > LONG_MAX - right) || (right < 0 && left < LONG_MIN - right)) {
+				return false;
+			}
+			*result = left + right;
+			return true;
+		case E_SUB:
+			if((right < 0 && left > LONG_MAX + right) || (right > 0 && left < LONG_MIN + right)) {
+				return false;
+			}
+			*result = left - right;
+			return true;
+		case E_MUL:
+			if((left > 0)? ((right > 0)? left > LONG_MAX / right : right < LONG_MIN / left)
+					: ((right > 0)? left < LONG_MIN / right : (left != 0 && right < LONG_MAX / left))) {
+				return false;
+			}
+			*result = left * right;
+			return true;
+		case E_DIV_INT:
+			if(right == 0 || (left == LONG_MIN && right == -1)) {
+				return false;
+			}
+			// rounds towards negative infinity
+			*result = left / right;
+			if((left % right != 0) && ((left < 0) != (right < 0))) {
+				(*result)--;
+			}
+			return true;
+		default:
+			return false;
+	}
+}
+
+/**
+ * Concatenates string literals
+ * @param left left operand
+ * @param right right operand
+ * @param result result token
+ * @param errCode error code
+ * @return true if the result was computed
+ */
+static bool foldConcatenate(token_t* left, token_t* right, token_t* result, int* errCode) {
+	// escaped operands are concatenated without the second string@ prefix
+	const size_t prefix = strlen("string@");
+	result->type = T_STRING;
+	result->data.strval = dynStrClone(left->data.strval);
+	result->operand = dynStrClone(left->operand);
+	if(result->data.strval == NULL || result->operand == NULL || right->operand->size < prefix
+			|| !dynStrAppendBuffer(result->data.strval, right->data.strval->string, right->data.strval->size)
+			|| !dynStrAppendBuffer(result->operand, right->operand->string + prefix, right->operand->size - prefix)) {
+		dynStrFree(result->data.strval);
+		dynStrFree(result->operand);
+		*errCode = ERROR_INTERNAL;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Computes binary operation with literal operands using IFJ19 semantics
+ * @param type operation
+ * @param left left operand
+ * @param right right operand
+ * @param result result token
+ * @param errCode error code
+ * @return true if the result was computed, false if it has to be computed at run time
+ */
+static bool foldCompute(treeElementType_t type, token_t* left, token_t* right, token_t* result, int* errCode) {
+	bool leftFloat, rightFloat;
+	long leftInt, rightInt;
+	double leftValue, rightValue;
+	bool numbers = foldGetNumber(left, &leftFloat, &leftInt, &leftValue)
+			&& foldGetNumber(right, &rightFloat, &rightInt, &rightValue);
+	bool strings = foldIsString(left) && foldIsString(right);
+	bool isFloat = numbers && (leftFloat || rightFloat);
+	int comparison = 0;
+
+	result->operand = NULL;
+	switch(type) {
+		case E_ADD:
+			if(strings) {
+				return foldConcatenate(left, right, result, errCode);
+			}
+			// fall through
+		case E_SUB:
+		case E_MUL:
+		case E_DIV:
+		case E_DIV_INT:
+			if(!numbers) {
+				return false;
+			}
+			if(type == E_DIV_INT && isFloat) {
+				return false;
+			}
+			if(type == E_DIV || isFloat) {
+				double value;
+				switch(type) {
+					case E_ADD:
+						value = leftValue + rightValue;
+						break;
+					case E_SUB:
+						value = leftValue - rightValue;
+						break;
+					case E_MUL:
+						value = leftValue * rightValue;
+						break;
+					default:
+						value = leftValue / rightValue;
+						break;
+				}
+				if(!isfinite(value)) {
+					return false;
+				}
+				result->type = T_FLOAT;
+				result->data.floatval = value;
+				return true;
+			}
+			result->type = T_NUMBER;
+			return foldIntArithmetic(type, leftInt, rightInt, &result->data.intval);
+
+		case E_LT:
+		case E_GT:
+		case E_LTE:
+		case E_GTE:
+			if(numbers) {
+				if(isFloat) {
+					comparison = (leftValue > rightValue) - (leftValue < rightValue);
+				} else {
+					comparison = (leftInt > rightInt) - (leftInt < rightInt);
+				}
+			} else if(strings) {
+				comparison = foldCompareStrings(left, right);
+			} else {
+				return false;
+			}
+			switch(type) {
+				case E_LT:
+					result->type = (comparison < 0)? T_BOOL_TRUE : T_BOOL_FALSE;
+					break;
+				case E_GT:
+					result->type = (comparison > 0)? T_BOOL_TRUE : T_BOOL_FALSE;
+					break;
+				case E_LTE:
+					result->type = (comparison <= 0)? T_BOOL_TRUE : T_BOOL_FALSE;
+					break;
+				default:
+					result->type = (comparison >= 0)? T_BOOL_TRUE : T_BOOL_FALSE;
+					break;
+			}
+			return true;
+
+		case E_EQ:
+		case E_NEQ: {
+			bool equal;
+			if(left->type == T_KW_NONE || right->type == T_KW_NONE) {
+				equal = left->type == right->type;
+			} else if(numbers) {
+				equal = isFloat? leftValue == rightValue : leftInt == rightInt;
+			} else if(strings) {
+				equal = foldCompareStrings(left, right) == 0;
+			} else {
+				return false;
+			}
+			result->type = (equal == (type == E_EQ))? T_BOOL_TRUE : T_BOOL_FALSE;
+			return true;
+		}
+
+		case E_AND:
+		case E_OR: {
+			if((left->type != T_BOOL_TRUE && left->type != T_BOOL_FALSE)
+					|| (right->type != T_BOOL_TRUE && right->type != T_BOOL_FALSE)) {
+				return false;
+			}
+			bool leftBool = left->type == T_BOOL_TRUE;
+			bool rightBool = right->type == T_BOOL_TRUE;
+			bool value = (type == E_AND)? leftBool && rightBool : leftBool || rightBool;
+			result->type = value? T_BOOL_TRUE : T_BOOL_FALSE;
+			return true;
+		}
+
+		default:
+			return false;
+	}
+}
+
+/**
+ * Replaces the operation element by the literal
+ * @param element operation element
+ * @param token literal token
+ */
+static void foldReplace(treeElement_t* element, token_t token) {
+	for(unsigned int i = 0; i < element->nodeSize; i++) {
+		treeFree(element->data.elements[i]);
+	}
+	free(element->data.elements);
+	initTokenTreeElement(element, token);
+}
+
+void semanticFold(treeElement_t* element, int* errCode) {
+	if(element->type == E_TOKEN) {
+		return;
+	}
+
+	// fold operands first
+	for(unsigned int i = 0; i < element->nodeSize; i++) {
+		semanticFold(&element->data.elements[i], errCode);
+		if(*errCode != ERROR_SUCCESS) {
+			return;
+		}
+	}
+
+	token_t result;
+	switch(element->type) {
+		case E_ADD:
+		case E_SUB:
+		case E_MUL:
+		case E_DIV:
+		case E_DIV_INT:
+		case E_LT:
+		case E_GT:
+		case E_LTE:
+		case E_GTE:
+		case E_EQ:
+		case E_NEQ:
+		case E_AND:
+		case E_OR: {
+			if(element->nodeSize != 2) {
+				return;
+			}
+			token_t* left = getLiteral(&element->data.elements[0]);
+			token_t* right = getLiteral(&element->data.elements[1]);
+			// division by zero fails at run time, literal zero divisors are rejected by the semantic check
+			if((element->type == E_DIV || element->type == E_DIV_INT) && right != NULL && foldIsZero(right)) {
+				return;
+			}
+			if(left == NULL || right == NULL || !foldCompute(element->type, left, right, &result, errCode)) {
+				return;
+			}
+			break;
+		}
+
+		case E_NOT: {
+			if(element->nodeSize != 1) {
+				return;
+			}
+			token_t* operand = getLiteral(&element->data.elements[0]);
+			if(operand == NULL || (operand->type != T_BOOL_TRUE && operand->type != T_BOOL_FALSE)) {
+				return;
+			}
+			result.type = (operand->type == T_BOOL_TRUE)? T_BOOL_FALSE : T_BOOL_TRUE;
+			result.operand = NULL;
+			break;
+		}
+
+		default:
+			return;
+	}
+
+	foldReplace(element, result);
+}
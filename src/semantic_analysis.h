@@ -44,6 +44,28 @@ typedef enum semanticType semanticType_t;
  */
 void semanticCheck(treeElement_t* parseTree, symTable_t* symTable, int* errCode);
 
+/**
+ * Marks the functions reachable from the top-level code as used, the call graph is walked
+ * from the top-level calls through the bodies of the called functions
+ * @param parseTree semantically checked parse tree
+ * @param symTable symbol table
+ */
+void semanticMarkReachable(treeElement_t* parseTree, symTable_t* symTable);
+
+/**
+ * Replaces operations with literal operands by their results, the tree must be semantically checked
+ * @param parseTree parse tree to fold
+ * @param errCode error code
+ */
+void semanticFold(treeElement_t* parseTree, int* errCode);
+
+/**
+ * Returns literal token of the element, literals in parentheses included
+ * @param element tree element
+ * @return literal token, NULL if the element is not a literal
+ */
+token_t* getLiteral(treeElement_t* element);
+
 /**
  * Returns semantic type for expression operators
  * @param operatorTree operator tree element
@@ -60,7 +82,7 @@ semanticType_t getOperatorType(treeElement_t operatorTree, int* errCode);
  * @param context expression context
  * @return expression result type
  */
-semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTable, int* errCode, dynStr_t* context);
+semanticType_t checkExpression(treeElement_t* expressionTree, symTable_t* symTable, int* errCode, strView_t context);
 
 /**
  * Converts tree boolean values to integer
@@ -84,4 +106,4 @@ void convertIntToFloat(treeElement_t* expressionTree, int* errCode);
  * @param errCode error code
  * @param context context
  */
-void semanticCheckTree(treeElement_t* element, symTable_t* symtable, int* errCode, dynStr_t* context);
+void semanticCheckTree(treeElement_t* element, symTable_t* symtable, int* errCode, strView_t context);
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "string_view.h"
+
+strView_t strViewInit(const char *string, size_t length) {
+	strView_t view = {.string = string, .length = string == NULL ? 0 : length, .hash = 0, .hashed = false};
+	return view;
+}
+
+strView_t strViewNull() {
+	return strViewInit(NULL, 0);
+}
+
+strView_t strViewString(const char *string) {
+	return strViewInit(string, string == NULL ? 0 : strlen(string));
+}
+
+strView_t strViewDynStr(const dynStr_t *string) {
+	if (string == NULL) {
+		return strViewNull();
+	}
+	return strViewInit(string->string, string->size);
+}
+
+bool strViewIsNull(strView_t view) {
+	return view.string == NULL;
+}
+
+bool strViewEqual(strView_t view1, strView_t view2) {
+	if (view1.string == NULL || view2.string == NULL) {
+		return view1.string == view2.string;
+	}
+	if (view1.length != view2.length) {
+		return false;
+	}
+	if (view1.hashed && view2.hashed && view1.hash != view2.hash) {
+		return false;
+	}
+	return view1.string == view2.string || memcmp(view1.string, view2.string, view1.length) == 0;
+}
+
+bool strViewEqualString(strView_t view, const char *str) {
+	if (view.string == NULL || str == NULL) {
+		return false;
+	}
+	return strncmp(view.string, str, view.length) == 0 && str[view.length] == 0;
+}
+
+uint32_t strViewHash(strView_t *view) {
+	if (view == NULL) {
+		return 0;
+	}
+	if (view->hashed) {
+		return view->hash;
+	}
+	uint32_t hash = 0;
+	for (size_t i = 0; i < view->length; ++i) {
+		uint32_t high;
+		hash = (hash << 4) + view->string[i];
+		high = hash & 0xF0000000;
+		if (high) {
+			hash ^= high >> 24;
+		}
+		hash &= ~high;
+	}
+	view->hash = hash;
+	view->hashed = true;
+	return hash;
+}
+
+bool strViewAppendTo(dynStr_t *string, strView_t view) {
+	if (view.string == NULL) {
+		return false;
+	}
+	return dynStrAppendBuffer(string, view.string, view.length);
+}
+
+bool strViewPrint(strView_t view, FILE *file) {
+	if (view.string == NULL || file == NULL) {
+		return false;
+	}
+	return fwrite(view.string, 1, view.length, file) == view.length;
+}
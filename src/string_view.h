@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "dynamic_string.h"
+
+/**
+ * Non-owning view of a string, the viewed characters have to outlive the view
+ */
+typedef struct string_view {
+	const char *string; // NULL for the null view
+	size_t length;
+	uint32_t hash; // cached hash, valid only if hashed is set
+	bool hashed;
+} strView_t;
+
+/**
+ * Creates a view of the buffer
+ * @param string Viewed buffer
+ * @param length Buffer length
+ * @return String view
+ */
+strView_t strViewInit(const char *string, size_t length);
+
+/**
+ * Creates a null view (it does not view any string, not even an empty one)
+ * @return Null string view
+ */
+strView_t strViewNull();
+
+/**
+ * Creates a view of the null-terminated string
+ * @param string Viewed string (NULL creates the null view)
+ * @return String view
+ */
+strView_t strViewString(const char *string);
+
+/**
+ * Creates a view of the dynamic string content
+ * @param string Viewed dynamic string (NULL creates the null view)
+ * @return String view
+ */
+strView_t strViewDynStr(const dynStr_t *string);
+
+/**
+ * Checks if the view is the null view
+ * @param view String view
+ * @return Is the view null?
+ */
+bool strViewIsNull(strView_t view);
+
+/**
+ * Determines whether two views have the same value, lengths and cached hashes are compared first
+ * @param view1 First string view to compare
+ * @param view2 Second string view to compare
+ * @return String equality (two null views are equal)
+ */
+bool strViewEqual(strView_t view1, strView_t view2);
+
+/**
+ * Determines whether the view and the string have the same value
+ * @param view String view
+ * @param str String to compare
+ * @return String equality
+ */
+bool strViewEqualString(strView_t view, const char *str);
+
+/**
+ * Returns the UNIX ELF hash of the view, the hash is computed once and cached in the view
+ * @param view String view
+ * @return UNIX ELF hash
+ */
+uint32_t strViewHash(strView_t *view);
+
+/**
+ * Appends the viewed string to a dynamic string
+ * @param string Dynamic string
+ * @param view String view to append
+ * @return Execution status
+ */
+bool strViewAppendTo(dynStr_t *string, strView_t view);
+
+/**
+ * Writes the viewed string to the file
+ * @param view String view
+ * @param file Output file
+ * @return Execution status
+ */
+bool strViewPrint(strView_t view, FILE *file);
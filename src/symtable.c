@@ -18,19 +18,8 @@
 
 #include "symtable.h"
 
-uint32_t symTableHash(dynStr_t *string) {
-	uint32_t hash = 0;
-	unsigned long i = 0;
-	while (dynStrGetChar(string, i)) {
-		uint32_t high;
-		hash = (hash << 4) + dynStrGetChar(string, i++);
-		high = hash & 0xF0000000;
-		if (high) {
-			hash ^= high >> 24;
-		}
-		hash &= ~high;
-	}
-	return hash % TABLE_SIZE;
+uint32_t symTableHash(strView_t *string) {
+	return strViewHash(string) % TABLE_SIZE;
 }
 
 symTable_t *symTableInit() {
@@ -70,17 +59,17 @@ void symTableFree(symTable_t *table) {
 	free(table);
 }
 
-void symTableRemove(symTable_t *table, dynStr_t *name, dynStr_t *context) {
-	if (table == NULL || name == NULL) {
+void symTableRemove(symTable_t *table, strView_t name, strView_t context) {
+	if (table == NULL || strViewIsNull(name)) {
 		return;
 	}
 
-	size_t index = symTableHash(name);
+	size_t index = symTableHash(&name);
 	symbol_t *current = table->array[index], *previous = NULL;
 
 	while (current != NULL) {
-		if (dynStrEqual(current->name, name) &&
-			dynStrEqual(current->context, context)) {
+		if (strViewEqual(current->name, name) &&
+			strViewEqual(current->context, context)) {
 			if (previous != NULL) {
 				previous->next = current->next;
 			} else {
@@ -102,17 +91,17 @@ size_t symTableSize(symTable_t *table) {
 	return table->size;
 }
 
-symbol_t *symTableFind(symTable_t *table, dynStr_t *name, dynStr_t *context) {
-	if (table == NULL || name == NULL) {
+symbol_t *symTableFind(symTable_t *table, strView_t name, strView_t context) {
+	if (table == NULL || strViewIsNull(name)) {
 		return NULL;
 	}
 
-	size_t index = symTableHash(name);
+	size_t index = symTableHash(&name);
 	symbol_t *current = table->array[index];
 
 	while (current != NULL) {
-		if (dynStrEqual(current->name, name) &&
-		    dynStrEqual(current->context, context)) {
+		if (strViewEqual(current->name, name) &&
+		    strViewEqual(current->context, context)) {
 			return current;
 		}
 		current = current->next;
@@ -120,11 +109,11 @@ symbol_t *symTableFind(symTable_t *table, dynStr_t *name, dynStr_t *context) {
 	return NULL;
 }
 
-bool symTableIsVariableAssigned(symTable_t *table, dynStr_t *name, dynStr_t *context) {
-	if (table == NULL || name == NULL) {
+bool symTableIsVariableAssigned(symTable_t *table, strView_t name, strView_t context) {
+	if (table == NULL || strViewIsNull(name)) {
 		return false;
 	}
-	symbol_t *global = symTableFind(table, name, NULL);
+	symbol_t *global = symTableFind(table, name, strViewNull());
 	symbol_t *local = symTableFind(table, name, context);
 	if (global == NULL && local == NULL) {
 		return false;
@@ -158,15 +147,38 @@ void symTableClearAssigment(symTable_t *table) {
 	}
 }
 
-symbolFrame_t symTableGetFrame(symTable_t *table, dynStr_t *name, dynStr_t *context) {
-	if (table == NULL || name == NULL) {
+void symTableClearFunctionUsage(symTable_t *table) {
+	if (table == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < table->allocated; ++i) {
+		symbol_t *current = table->array[i];
+		while (current != NULL) {
+			if (current->type == SYMBOL_FUNCTION) {
+				current->used = false;
+			}
+			current = current->next;
+		}
+	}
+}
+
+symbolFrame_t symTableGetFrame(symTable_t *table, strView_t name, strView_t context) {
+	if (table == NULL || strViewIsNull(name)) {
 		return FRAME_ERROR;
 	}
 	symbol_t *symbol = symTableFind(table, name, context);
 	if (symbol == NULL) {
 		return FRAME_ERROR;
 	}
-	return symbol->context == NULL ? FRAME_GLOBAL : FRAME_LOCAL;
+	return strViewIsNull(symbol->context) ? FRAME_GLOBAL : FRAME_LOCAL;
+}
+
+symbol_t *symTableResolve(symTable_t *table, strView_t name, strView_t context) {
+	symbol_t *symbol = symTableFind(table, name, context);
+	if (symbol == NULL && !strViewIsNull(context)) {
+		symbol = symTableFind(table, name, strViewNull());
+	}
+	return symbol;
 }
 
 errorCode_t symTableInsertEmbedFunctions(symTable_t *table) {
@@ -194,15 +206,9 @@ errorCode_t symTableInsertEmbedFunctions(symTable_t *table) {
 		1,
 	};
 	for (size_t i = 0; i < EMBEDDED_FUNCTIONS; ++i) {
-		dynStr_t *name = dynStrInit();
-		if (name == NULL) {
-			return ERROR_INTERNAL;
-		}
-		dynStrAppendString(name, names[i]);
 		symbolInfo_t info = {.function = {.argc = argc[i], .defined = true}};
-		symbol_t *symbol = symbolInit(name, SYMBOL_FUNCTION, info, NULL);
+		symbol_t *symbol = symbolInit(strViewString(names[i]), SYMBOL_FUNCTION, info, strViewNull());
 		if (symbol == NULL) {
-			dynStrFree(name);
 			return ERROR_INTERNAL;
 		}
 		if (symTableInsert(table, symbol, true) != ERROR_SUCCESS) {
@@ -213,12 +219,12 @@ errorCode_t symTableInsertEmbedFunctions(symTable_t *table) {
 	return ERROR_SUCCESS;
 }
 
-errorCode_t symTableInsertFunction(symTable_t *table, dynStr_t *name, int argc) {
-	if (table == NULL || name == NULL) {
+errorCode_t symTableInsertFunction(symTable_t *table, strView_t name, int argc) {
+	if (table == NULL || strViewIsNull(name)) {
 		return ERROR_INTERNAL;
 	}
 	symbolInfo_t info = {.function = {.argc = argc, .argv = NULL, .defined = false}};
-	symbol_t *symbol = symbolInit(dynStrClone(name), SYMBOL_FUNCTION, info, NULL);
+	symbol_t *symbol = symbolInit(name, SYMBOL_FUNCTION, info, strViewNull());
 	if (symbol == NULL) {
 		return ERROR_INTERNAL;
 	}
@@ -229,12 +235,12 @@ errorCode_t symTableInsertFunction(symTable_t *table, dynStr_t *name, int argc)
 	return retVal;
 }
 
-errorCode_t symTableInsertFunctionDefinition(symTable_t *table, dynStr_t *name, int argc, dynStrList_t *argv) {
-	if (table == NULL || name == NULL || argv == NULL) {
+errorCode_t symTableInsertFunctionDefinition(symTable_t *table, strView_t name, int argc, dynStrList_t *argv) {
+	if (table == NULL || strViewIsNull(name) || argv == NULL) {
 		return ERROR_INTERNAL;
 	}
 	symbolInfo_t info = {.function = {.argc = argc, .argv = argv, .defined = true}};
-	symbol_t *symbol = symbolInit(dynStrClone(name), SYMBOL_FUNCTION, info, NULL);
+	symbol_t *symbol = symbolInit(name, SYMBOL_FUNCTION, info, strViewNull());
 	if (symbol == NULL) {
 		dynStrListFree(argv);
 		return ERROR_INTERNAL;
@@ -246,14 +252,13 @@ errorCode_t symTableInsertFunctionDefinition(symTable_t *table, dynStr_t *name,
 	return retVal;
 }
 
-errorCode_t symTableInsertVariable(symTable_t *table, dynStr_t *name, dynStr_t *context, bool assignment) {
-	if (table == NULL || name == NULL) {
+errorCode_t symTableInsertVariable(symTable_t *table, strView_t name, strView_t context, bool assignment) {
+	if (table == NULL || strViewIsNull(name)) {
 		return ERROR_INTERNAL;
 	}
 	symbolInfo_t info = {.variable = {.assigned = assignment}};
-	symbol_t *symbol = symbolInit(dynStrClone(name), SYMBOL_VARIABLE, info, dynStrClone(context));
+	symbol_t *symbol = symbolInit(name, SYMBOL_VARIABLE, info, context);
 	if (symbol == NULL) {
-		symbolFree(symbol);
 		return ERROR_INTERNAL;
 	}
 	errorCode_t retVal = symTableInsert(table, symbol, false);
@@ -268,12 +273,12 @@ errorCode_t symTableInsert(symTable_t *table, symbol_t *symbol, bool unique) {
 		return ERROR_INTERNAL;
 	}
 
-	size_t index = symTableHash(symbol->name);
+	size_t index = symTableHash(&symbol->name);
 	symbol_t *current = table->array[index], *previous = NULL;
 
 	while (current != NULL) {
-		if (dynStrEqual(current->name, symbol->name) &&
-			dynStrEqual(current->context, symbol->context)) {
+		if (strViewEqual(current->name, symbol->name) &&
+			strViewEqual(current->context, symbol->context)) {
 			if (unique && current->type == SYMBOL_FUNCTION &&
 				current->info.function.defined) {
 				return ERROR_SEMANTIC_FUNCTION;
@@ -290,6 +295,13 @@ errorCode_t symTableInsert(symTable_t *table, symbol_t *symbol, bool unique) {
 					current->info.function.argc != -1) {
 					return ERROR_SEMANTIC_ARGC;
 				}
+				if (symbol->info.function.defined) {
+					// definition after the call, the symbol takes over the argument names
+					current->info.function.argc = symbol->info.function.argc;
+					current->info.function.argv = symbol->info.function.argv;
+					current->info.function.defined = true;
+					symbol->info.function.argv = NULL;
+				}
 				current->used = true;
 			}
 			symbolFree(symbol);
@@ -308,24 +320,24 @@ errorCode_t symTableInsert(symTable_t *table, symbol_t *symbol, bool unique) {
 	return ERROR_SUCCESS;
 }
 
-dynStr_t *symTableGetArgumentName(symTable_t *table, dynStr_t *function, unsigned long index) {
-	if (table == NULL || function == NULL) {
-		return NULL;
+strView_t symTableGetArgumentName(symTable_t *table, strView_t function, unsigned long index) {
+	if (table == NULL || strViewIsNull(function)) {
+		return strViewNull();
 	}
-	symbol_t *symbol = symTableFind(table, function, NULL);
+	symbol_t *symbol = symTableFind(table, function, strViewNull());
 	if (symbol == NULL || symbol->type != SYMBOL_FUNCTION) {
-		return NULL;
+		return strViewNull();
 	}
 	functionSymbol_t info = symbol->info.function;
 	if (info.argc == -1 || info.argc == 0 ||
 		(unsigned long) info.argc <= index || info.argv == NULL) {
-		return NULL;
+		return strViewNull();
 	}
 	dynStrListEl_t *element = dynStrListFront(info.argv);
 	for (unsigned long i = 0; i < index; ++i) {
 		element = dynStrListElNext(element);
 	}
-	return element->string;
+	return dynStrListElGetView(element);
 }
 
 symIterator_t symIteratorBegin(const symTable_t *table) {
@@ -379,8 +391,8 @@ bool symIteratorValidate(symIterator_t iterator) {
 	return (iterator.table != NULL) && (iterator.symbol != NULL);
 }
 
-symbol_t *symbolInit(dynStr_t *name, symbolType_t type, symbolInfo_t info, dynStr_t *context) {
-	if (name == NULL) {
+symbol_t *symbolInit(strView_t name, symbolType_t type, symbolInfo_t info, strView_t context) {
+	if (strViewIsNull(name)) {
 		return NULL;
 	}
 	symbol_t *symbol = malloc(sizeof(symbol_t));
@@ -388,11 +400,22 @@ symbol_t *symbolInit(dynStr_t *name, symbolType_t type, symbolInfo_t info, dynSt
 		return NULL;
 	}
 	symbol->name = name;
+	strViewHash(&symbol->name);
+	symbol->ownedName = NULL;
 	symbol->info = info;
 	symbol->next = NULL;
 	symbol->type = type;
 	symbol->used = false;
 	symbol->context = context;
+	symbol->operand = NULL;
+	if (type == SYMBOL_VARIABLE) {
+		symbol->operand = dynStrInitString(strViewIsNull(context) ? "GF@" : "LF@");
+		if (symbol->operand == NULL || !strViewAppendTo(symbol->operand, name)) {
+			dynStrFree(symbol->operand);
+			free(symbol);
+			return NULL;
+		}
+	}
 	return symbol;
 }
 
@@ -403,13 +426,15 @@ void symbolFree(symbol_t *symbol) {
 	if (symbol->type == SYMBOL_FUNCTION) {
 		dynStrListFree(symbol->info.function.argv);
 	}
-	if (symbol->context != NULL) {
-		dynStrFree(symbol->context);
-		symbol->context = NULL;
-	}
-	if (symbol->name != NULL) {
-		dynStrFree(symbol->name);
-		symbol->name = NULL;
-	}
+	dynStrFree(symbol->operand);
+	dynStrFree(symbol->ownedName);
 	free(symbol);
 }
+
+bool symbolTakeName(symbol_t *symbol, dynStr_t *name) {
+	if (symbol->ownedName != NULL || symbol->name.string != name->string) {
+		return false;
+	}
+	symbol->ownedName = name;
+	return true;
+}
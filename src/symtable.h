@@ -24,6 +24,7 @@
 #include "dynamic_string.h"
 #include "dynamic_string_list.h"
 #include "error.h"
+#include "string_view.h"
 
 #define EMBEDDED_FUNCTIONS 8
 #define TABLE_SIZE 8191 // 2^13 - 1
@@ -59,10 +60,12 @@ typedef enum symbolType {
 } symbolType_t;
 
 struct symbol {
-	dynStr_t *name;
+	strView_t name; // borrowed unless owned by ownedName, the viewed name has to outlive the symbol table
+	dynStr_t *ownedName; // name taken from the freed token, NULL if the name is borrowed
 	symbolType_t type;
 	symbolInfo_t info;
-	dynStr_t *context;
+	strView_t context; // borrowed, null view for global symbols
+	dynStr_t *operand; // ready-to-emit variable operand (FRAME@name), NULL for functions
 	bool used;
 	symbol_t *next;
 };
@@ -81,10 +84,10 @@ typedef struct symIterator {
 
 /**
  * UNIX ELF hash function
- * @param string String to hash
+ * @param string String to hash (the hash is cached in the view)
  * @return UNIX ELF hash
  */
-uint32_t symTableHash(dynStr_t *string);
+uint32_t symTableHash(strView_t *string);
 
 /**
  * Creates a new symbol table
@@ -108,9 +111,9 @@ void symTableFree(symTable_t *table);
  * Removes a symbol from the symbol table
  * @param table Symbol table
  * @param name Symbol name
- * @param context Symbol context (NULL = global, others = function name)
+ * @param context Symbol context (null view = global, others = function name)
  */
-void symTableRemove(symTable_t *table, dynStr_t *name, dynStr_t *context);
+void symTableRemove(symTable_t *table, strView_t name, strView_t context);
 
 /**
  * Inserts the embedded functions
@@ -126,7 +129,7 @@ errorCode_t symTableInsertEmbedFunctions(symTable_t *table);
  * @param argc Argument count
  * @return Execution status
  */
-errorCode_t symTableInsertFunction(symTable_t *table, dynStr_t *name, int argc);
+errorCode_t symTableInsertFunction(symTable_t *table, strView_t name, int argc);
 
 /**
  * Inserts a function definition
@@ -136,17 +139,17 @@ errorCode_t symTableInsertFunction(symTable_t *table, dynStr_t *name, int argc);
  * @param argv Argument list
  * @return Execution status
  */
-errorCode_t symTableInsertFunctionDefinition(symTable_t *table, dynStr_t *name, int argc, dynStrList_t *argv);
+errorCode_t symTableInsertFunctionDefinition(symTable_t *table, strView_t name, int argc, dynStrList_t *argv);
 
 /**
  * Inserts a variable
  * @param table Symbol table
  * @param name Variable name
- * @param context Symbol context (NULL = global, others = function name)
+ * @param context Symbol context (null view = global, others = function name)
  * @param assigment Is assigment?
  * @return Execution status
  */
-errorCode_t symTableInsertVariable(symTable_t *table, dynStr_t *name, dynStr_t *context, bool assigment);
+errorCode_t symTableInsertVariable(symTable_t *table, strView_t name, strView_t context, bool assigment);
 
 /**
  * Inserts a symbol into the table
@@ -171,7 +174,7 @@ size_t symTableSize(symTable_t *table);
  * @param context Symbol context
  * @return Symbol
  */
-symbol_t *symTableFind(symTable_t *table, dynStr_t *name, dynStr_t *context);
+symbol_t *symTableFind(symTable_t *table, strView_t name, strView_t context);
 
 /**
  * Checks if the variable is assigned
@@ -180,16 +183,16 @@ symbol_t *symTableFind(symTable_t *table, dynStr_t *name, dynStr_t *context);
  * @param context Symbol context
  * @return Is the variable assigned?
  */
-bool symTableIsVariableAssigned(symTable_t *table, dynStr_t *name, dynStr_t *context);
+bool symTableIsVariableAssigned(symTable_t *table, strView_t name, strView_t context);
 
 /**
  * Returns the argument name of the function
  * @param table Symbol table
  * @param function Function name
  * @param index Argument index
- * @return Function's argument name
+ * @return Function's argument name, null view if it does not exist
  */
-dynStr_t *symTableGetArgumentName(symTable_t *table, dynStr_t *function, unsigned long index);
+strView_t symTableGetArgumentName(symTable_t *table, strView_t function, unsigned long index);
 
 /**
  * Clears all variable assigment
@@ -197,14 +200,29 @@ dynStr_t *symTableGetArgumentName(symTable_t *table, dynStr_t *function, unsigne
  */
 void symTableClearAssigment(symTable_t *table);
 
+/**
+ * Clears usage of all functions
+ * @param table Symbol table
+ */
+void symTableClearFunctionUsage(symTable_t *table);
+
 /**
  * Returns the symbol frame type
  * @param table Symbol table
  * @param name Symbol name
- * @param context Symbol context (NULL = global, others = function name)
+ * @param context Symbol context (null view = global, others = function name)
  * @return Symbol frame type
  */
-symbolFrame_t symTableGetFrame(symTable_t *table, dynStr_t *name, dynStr_t *context);
+symbolFrame_t symTableGetFrame(symTable_t *table, strView_t name, strView_t context);
+
+/**
+ * Resolves the symbol visible from the context
+ * @param table Symbol table
+ * @param name Symbol name
+ * @param context Symbol context (null view = global, others = function name)
+ * @return Local symbol if exists, global symbol otherwise
+ */
+symbol_t *symTableResolve(symTable_t *table, strView_t name, strView_t context);
 
 /**
  * Returns an iterator to the beginning
@@ -242,7 +260,15 @@ bool symIteratorValidate(symIterator_t iterator);
  * @param context Symbol context
  * @return Initialized symbol
  */
-symbol_t *symbolInit(dynStr_t *name, symbolType_t type, symbolInfo_t info, dynStr_t *context);
+symbol_t *symbolInit(strView_t name, symbolType_t type, symbolInfo_t info, strView_t context);
+
+/**
+ * Takes ownership of the dynamic string viewed by the symbol name
+ * @param symbol Symbol
+ * @param name Dynamic string to take
+ * @return True if the symbol name views the string and the symbol took it
+ */
+bool symbolTakeName(symbol_t *symbol, dynStr_t *name);
 
 /**
  * Frees the symbol
@@ -0,0 +1,374 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "error.h"
+#include "type_inference.h"
+
+void typeEnvironmentInit(typeEnvironment_t* environment) {
+	environment->symbols = NULL;
+	environment->types = NULL;
+	environment->size = 0;
+	environment->capacity = 0;
+}
+
+void typeEnvironmentFree(typeEnvironment_t* environment) {
+	free(environment->symbols);
+	free(environment->types);
+	typeEnvironmentInit(environment);
+}
+
+/**
+ * Copies the environment
+ * @param destination initialized environment to copy to
+ * @param source environment to copy
+ * @return execution status
+ */
+static bool typeEnvironmentCopy(typeEnvironment_t* destination, const typeEnvironment_t* source) {
+	for(size_t i = 0; i < source->size; i++) {
+		if(!typeEnvironmentSet(destination, source->symbols[i], source->types[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+unsigned int typeEnvironmentGet(const typeEnvironment_t* environment, const symbol_t* symbol) {
+	for(size_t i = 0; i < environment->size; i++) {
+		if(environment->symbols[i] == symbol) {
+			return environment->types[i];
+		}
+	}
+	return VALUE_UNKNOWN;
+}
+
+bool typeEnvironmentSet(typeEnvironment_t* environment, symbol_t* symbol, unsigned int types) {
+	for(size_t i = 0; i < environment->size; i++) {
+		if(environment->symbols[i] == symbol) {
+			environment->types[i] = types;
+			return true;
+		}
+	}
+	// unknown is the default type
+	if(types == VALUE_UNKNOWN) {
+		return true;
+	}
+	if(environment->size == environment->capacity) {
+		size_t capacity = (environment->capacity == 0)? 16 : environment->capacity * 2;
+		symbol_t** symbols = realloc(environment->symbols, capacity * sizeof(symbol_t*));
+		if(symbols == NULL) {
+			return false;
+		}
+		environment->symbols = symbols;
+		unsigned int* typeSets = realloc(environment->types, capacity * sizeof(unsigned int));
+		if(typeSets == NULL) {
+			return false;
+		}
+		environment->types = typeSets;
+		environment->capacity = capacity;
+	}
+	environment->symbols[environment->size] = symbol;
+	environment->types[environment->size] = types;
+	environment->size++;
+	return true;
+}
+
+/**
+ * Adds the types of the other path to the environment (join of the control flow)
+ * @param environment environment to update
+ * @param other environment of the other path
+ * @return has the environment changed?
+ */
+static bool typeEnvironmentJoin(typeEnvironment_t* environment, const typeEnvironment_t* other) {
+	bool changed = false;
+	for(size_t i = 0; i < environment->size; i++) {
+		unsigned int types = environment->types[i] | typeEnvironmentGet(other, environment->symbols[i]);
+		if(types != environment->types[i]) {
+			environment->types[i] = types;
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+/**
+ * Returns type of the literal or variable token
+ * @param element token element
+ * @param environment types of variables
+ * @return set of possible value types
+ */
+static unsigned int typeOfToken(const treeElement_t* element, const typeEnvironment_t* environment) {
+	switch(element->data.token->type) {
+		case T_NUMBER:
+			return VALUE_INT;
+		case T_FLOAT:
+			return VALUE_FLOAT;
+		case T_STRING:
+		case T_STRING_ML:
+			return VALUE_STRING;
+		case T_BOOL_TRUE:
+		case T_BOOL_FALSE:
+			return VALUE_BOOL;
+		case T_KW_NONE:
+			return VALUE_NONE;
+		case T_ID:
+			if(element->symbol != NULL && element->symbol->type == SYMBOL_VARIABLE) {
+				return typeEnvironmentGet(environment, element->symbol);
+			}
+			return VALUE_UNKNOWN;
+		default:
+			return VALUE_UNKNOWN;
+	}
+}
+
+/**
+ * Returns type of the value returned by the function
+ * @param callElement function call element
+ * @return set of possible value types
+ */
+static unsigned int typeOfCall(const treeElement_t* callElement) {
+	const char* name = callElement->data.elements[0].data.token->data.strval->string;
+	if(strcmp(name, "inputi") == 0) {
+		return VALUE_INT | VALUE_NONE;
+	}
+	if(strcmp(name, "inputf") == 0) {
+		return VALUE_FLOAT | VALUE_NONE;
+	}
+	if(strcmp(name, "len") == 0) {
+		return VALUE_INT;
+	}
+	if(strcmp(name, "ord") == 0) {
+		return VALUE_INT | VALUE_NONE;
+	}
+	if(strcmp(name, "chr") == 0) {
+		return VALUE_STRING;
+	}
+	return VALUE_UNKNOWN;
+}
+
+/**
+ * Returns type of the arithmetic operation, the instructions require operands of the same type
+ * @param first types of the first operand
+ * @param second types of the second operand
+ * @param allowed types accepted by the instruction
+ * @return set of possible value types
+ */
+static unsigned int typeOfArithmetic(unsigned int first, unsigned int second, unsigned int allowed) {
+	unsigned int types = first & second & allowed;
+	// the operation always fails at runtime, nothing is known about the (never used) result
+	return (types == 0)? VALUE_UNKNOWN : types;
+}
+
+bool typeIsConverted(treeElementType_t operation, unsigned int operand, unsigned int other) {
+	switch(operation) {
+		case E_ADD:
+		case E_SUB:
+		case E_MUL:
+		case E_EQ:
+		case E_NEQ:
+		case E_GT:
+		case E_GTE:
+		case E_LT:
+		case E_LTE:
+			return operand == VALUE_INT && other == VALUE_FLOAT;
+		case E_DIV:
+			// division result is always float
+			return operand == VALUE_INT && (other == VALUE_FLOAT || other == VALUE_INT);
+		default:
+			return false;
+	}
+}
+
+unsigned int typeInferExpression(treeElement_t* element, typeEnvironment_t* environment) {
+	unsigned int types = VALUE_UNKNOWN;
+	switch(element->type) {
+		case E_TOKEN:
+			types = typeOfToken(element, environment);
+			break;
+
+		case E_S_EXPRESSION:
+			for(unsigned int i = 0; i < element->nodeSize; i++) {
+				types = typeInferExpression(&element->data.elements[i], environment);
+			}
+			break;
+
+		case E_ADD:
+		case E_SUB:
+		case E_MUL:
+		case E_DIV:
+		case E_DIV_INT: {
+			unsigned int first = typeInferExpression(&element->data.elements[0], environment);
+			unsigned int second = typeInferExpression(&element->data.elements[1], environment);
+			unsigned int allowed = VALUE_INT | VALUE_FLOAT;
+			if(element->type == E_DIV) {
+				allowed = VALUE_FLOAT;
+			} else if(element->type == E_DIV_INT) {
+				allowed = VALUE_INT;
+			}
+			if(typeIsConverted(element->type, first, second) || typeIsConverted(element->type, second, first)) {
+				types = VALUE_FLOAT;
+			} else {
+				types = typeOfArithmetic(first, second, allowed);
+			}
+			break;
+		}
+
+		case E_EQ:
+		case E_NEQ:
+		case E_GT:
+		case E_GTE:
+		case E_LT:
+		case E_LTE:
+		case E_NOT:
+			for(unsigned int i = 0; i < element->nodeSize; i++) {
+				typeInferExpression(&element->data.elements[i], environment);
+			}
+			types = VALUE_BOOL;
+			break;
+
+		case E_AND:
+		case E_OR:
+			// result is the deciding bool left operand or the right operand (short-circuit evaluation)
+			typeInferExpression(&element->data.elements[0], environment);
+			types = VALUE_BOOL | typeInferExpression(&element->data.elements[1], environment);
+			break;
+
+		case E_ASSIGN: {
+			// assignment inside of expression
+			treeElement_t* variable = &element->data.elements[0];
+			variable->valueTypes = typeInferExpression(&element->data.elements[1], environment);
+			typeEnvironmentSet(environment, variable->symbol, variable->valueTypes);
+			break;
+		}
+
+		case E_S_FUNCTION_CALL:
+			if(element->nodeSize > 1) {
+				typeInferExpression(&element->data.elements[1], environment);
+			}
+			types = typeOfCall(element);
+			break;
+
+		case E_S_FUNCTION_CALL_PARAMS:
+			for(unsigned int i = 0; i < element->nodeSize; i++) {
+				typeInferExpression(&element->data.elements[i], environment);
+			}
+			break;
+
+		default:
+			break;
+	}
+	element->valueTypes = types;
+	return types;
+}
+
+/**
+ * Infers types in the block of code
+ * @param block tree element with block of code
+ * @param environment types at the beginning of the block, updated to the types at its end
+ * @param errCode error code
+ */
+static void typeInferBlock(treeElement_t* block, typeEnvironment_t* environment, int* errCode) {
+	for(unsigned int i = 0; i < block->nodeSize && *errCode == ERROR_SUCCESS; i++) {
+		treeElement_t* statement = &block->data.elements[i];
+		switch(statement->type) {
+			case E_ASSIGN: {
+				treeElement_t* variable = &statement->data.elements[0];
+				variable->valueTypes = typeInferExpression(&statement->data.elements[1], environment);
+				if(!typeEnvironmentSet(environment, variable->symbol, variable->valueTypes)) {
+					*errCode = ERROR_INTERNAL;
+				}
+				break;
+			}
+
+			case E_S_EXPRESSION:
+			case E_S_RETURN:
+				for(unsigned int j = 0; j < statement->nodeSize; j++) {
+					typeInferExpression(&statement->data.elements[j], environment);
+				}
+				break;
+
+			case E_S_IF: {
+				typeInferExpression(&statement->data.elements[0], environment);
+				typeEnvironment_t elseEnvironment;
+				typeEnvironmentInit(&elseEnvironment);
+				if(!typeEnvironmentCopy(&elseEnvironment, environment)) {
+					*errCode = ERROR_INTERNAL;
+				}
+				typeInferBlock(&statement->data.elements[1], environment, errCode);
+				if(statement->nodeSize > 2) {
+					typeInferBlock(&statement->data.elements[2].data.elements[0], &elseEnvironment, errCode);
+				}
+				typeEnvironmentJoin(environment, &elseEnvironment);
+				typeEnvironmentFree(&elseEnvironment);
+				break;
+			}
+
+			case E_S_WHILE: {
+				// types at the beginning of the loop grow until the body doesn't add any
+				bool changed = true;
+				while(changed && *errCode == ERROR_SUCCESS) {
+					typeInferExpression(&statement->data.elements[0], environment);
+					typeEnvironment_t bodyEnvironment;
+					typeEnvironmentInit(&bodyEnvironment);
+					if(!typeEnvironmentCopy(&bodyEnvironment, environment)) {
+						*errCode = ERROR_INTERNAL;
+					}
+					typeInferBlock(&statement->data.elements[1], &bodyEnvironment, errCode);
+					changed = typeEnvironmentJoin(environment, &bodyEnvironment);
+					typeEnvironmentFree(&bodyEnvironment);
+				}
+				break;
+			}
+
+			default:
+				break;
+		}
+	}
+}
+
+void typeInfer(treeElement_t* codeElement, int* errCode) {
+	if(codeElement->type != E_CODE) {
+		*errCode = ERROR_INTERNAL;
+		return;
+	}
+
+	// top-level code is executed in order, functions can't assign global variables
+	typeEnvironment_t environment;
+	typeEnvironmentInit(&environment);
+
+	for(unsigned int i = 0; i < codeElement->nodeSize && *errCode == ERROR_SUCCESS; i++) {
+		treeElement_t* element = &codeElement->data.elements[i];
+		if(element->type == E_CODE_BLOCK) {
+			typeInferBlock(element, &environment, errCode);
+		} else if(element->type == E_S_FUNCTION_DEF) {
+			// parameters and global variables can be of any type in the function body
+			for(unsigned int j = 0; j < element->nodeSize; j++) {
+				if(element->data.elements[j].type == E_CODE_BLOCK) {
+					typeEnvironment_t functionEnvironment;
+					typeEnvironmentInit(&functionEnvironment);
+					typeInferBlock(&element->data.elements[j], &functionEnvironment, errCode);
+					typeEnvironmentFree(&functionEnvironment);
+				}
+			}
+		}
+	}
+
+	typeEnvironmentFree(&environment);
+}
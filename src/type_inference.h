@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#pragma once
+
+#include "parse_tree.h"
+#include "symtable.h"
+
+/**
+ * Possible types of variables at a point of the program
+ */
+typedef struct type_environment {
+	symbol_t **symbols; // variable symbols
+	unsigned int *types; // sets of possible value types
+	size_t size;
+	size_t capacity;
+} typeEnvironment_t;
+
+/**
+ * Initializes an empty environment
+ * @param environment environment to initialize
+ */
+void typeEnvironmentInit(typeEnvironment_t* environment);
+
+/**
+ * Frees the environment
+ * @param environment environment to free
+ */
+void typeEnvironmentFree(typeEnvironment_t* environment);
+
+/**
+ * Returns possible types of the variable
+ * @param environment environment
+ * @param symbol variable symbol
+ * @return set of possible value types, VALUE_UNKNOWN if nothing is known about the variable
+ */
+unsigned int typeEnvironmentGet(const typeEnvironment_t* environment, const symbol_t* symbol);
+
+/**
+ * Sets possible types of the variable
+ * @param environment environment
+ * @param symbol variable symbol
+ * @param types set of possible value types
+ * @return execution status
+ */
+bool typeEnvironmentSet(typeEnvironment_t* environment, symbol_t* symbol, unsigned int types);
+
+/**
+ * Checks if the generated code converts the operand of the arithmetic operation or comparison to float,
+ * the conversion is done only if types of both operands are known
+ * @param operation operation element type
+ * @param operand types of the operand
+ * @param other types of the other operand
+ * @return is the operand converted?
+ */
+bool typeIsConverted(treeElementType_t operation, unsigned int operand, unsigned int other);
+
+/**
+ * Infers possible types of the expression from the types of variables and stores them in its elements,
+ * the types are the ones which the generated code can produce
+ * @param element expression element
+ * @param environment types of variables, updated by assignments in the expression
+ * @return set of possible value types
+ */
+unsigned int typeInferExpression(treeElement_t* element, typeEnvironment_t* environment);
+
+/**
+ * Infers possible types of all expressions in the top-level code and function bodies,
+ * the types are flow-sensitive and stored in valueTypes of the expression elements.
+ * The tree must be semantically checked.
+ * @param codeElement tree element containing the program code
+ * @param errCode error code
+ */
+void typeInfer(treeElement_t* codeElement, int* errCode);
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdarg>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include "ir_program_test.h"
+
+extern "C" {
+#include "code_emitter.h"
+}
+
+namespace Tests {
+
+	class CodeEmitterTest : public EmitterTest {};
+
+	TEST_F(CodeEmitterTest, Init) {
+		ASSERT_EQ(codeEmitterSize(emitter), 0);
+		ASSERT_EQ(emitter->chunkCount, 0);
+	}
+
+	TEST_F(CodeEmitterTest, Append) {
+		ASSERT_TRUE(codeEmitterAppendString(emitter, "MOVE"));
+		ASSERT_TRUE(codeEmitterAppendChar(emitter, ' '));
+		ASSERT_TRUE(codeEmitterAppendView(emitter, strViewString("GF@a")));
+		ASSERT_TRUE(codeEmitterAppend(emitter, " int@42\nxyz", 8));
+		ASSERT_EQ(content(), "MOVE GF@a int@42\n");
+		ASSERT_FALSE(codeEmitterAppendView(emitter, strViewNull()));
+		ASSERT_FALSE(codeEmitterAppendString(emitter, nullptr));
+	}
+
+	TEST_F(CodeEmitterTest, AppendNumber) {
+		ASSERT_TRUE(codeEmitterAppendNumber(emitter, 0));
+		ASSERT_TRUE(codeEmitterAppendChar(emitter, ' '));
+		ASSERT_TRUE(codeEmitterAppendNumber(emitter, -1234567890123L));
+		ASSERT_EQ(content(), "0 -1234567890123");
+	}
+
+	TEST_F(CodeEmitterTest, AppendAcrossChunks) {
+		std::string expected;
+		for (int i = 0; expected.size() < 3 * CODE_EMITTER_CHUNK_SIZE; ++i) {
+			std::string line = "PUSHS int@" + std::to_string(i) + "\n";
+			ASSERT_TRUE(codeEmitterAppend(emitter, line.c_str(), line.size()));
+			expected += line;
+		}
+		ASSERT_EQ(emitter->chunkCount, 4);
+		ASSERT_EQ(content(), expected);
+	}
+
+	TEST_F(CodeEmitterTest, InstructionsWithoutAllocation) {
+		for (int i = 0; i < 1000; ++i) {
+			ASSERT_TRUE(codeEmitterAppendString(emitter, "ADD GF@a GF@a int@"));
+			ASSERT_TRUE(codeEmitterAppendNumber(emitter, i));
+			ASSERT_TRUE(codeEmitterAppendChar(emitter, '\n'));
+		}
+		ASSERT_EQ(emitter->chunkCount, 1);
+	}
+
+	TEST_F(CodeEmitterTest, ClearRetainsChunks) {
+		std::string data(CODE_EMITTER_CHUNK_SIZE + 1, 'x');
+		ASSERT_TRUE(codeEmitterAppend(emitter, data.c_str(), data.size()));
+		ASSERT_EQ(emitter->chunkCount, 2);
+		codeEmitterClear(emitter);
+		ASSERT_EQ(codeEmitterSize(emitter), 0);
+		ASSERT_TRUE(codeEmitterAppend(emitter, data.c_str(), data.size()));
+		ASSERT_EQ(emitter->chunkCount, 2);
+		ASSERT_EQ(content(), data);
+	}
+
+	TEST_F(CodeEmitterTest, Truncate) {
+		ASSERT_TRUE(codeEmitterAppendString(emitter, "CREATEFRAME\n"));
+		size_t position = codeEmitterSize(emitter);
+		ASSERT_TRUE(codeEmitterAppendString(emitter, "PUSHS int@1\n"));
+		ASSERT_TRUE(codeEmitterTruncate(emitter, position));
+		ASSERT_EQ(content(), "CREATEFRAME\n");
+		ASSERT_FALSE(codeEmitterTruncate(emitter, position + 1));
+	}
+
+	TEST_F(CodeEmitterTest, ReverseLines) {
+		ASSERT_TRUE(codeEmitterAppendString(emitter, "CREATEFRAME\n"));
+		size_t position = codeEmitterSize(emitter);
+		ASSERT_TRUE(codeEmitterReverseLines(emitter, position));
+		ASSERT_TRUE(codeEmitterAppendString(emitter, "PUSHS int@1\nPUSHS string@ab\n\nADDS\n"));
+		ASSERT_TRUE(codeEmitterReverseLines(emitter, position));
+		ASSERT_EQ(content(), "CREATEFRAME\nADDS\n\nPUSHS string@ab\nPUSHS int@1\n");
+		ASSERT_TRUE(codeEmitterAppendString(emitter, "PUSHS"));
+		ASSERT_FALSE(codeEmitterReverseLines(emitter, position));
+	}
+
+	TEST_F(CodeEmitterTest, ReverseLinesAcrossChunks) {
+		std::string line(1000, 'a');
+		std::string expected;
+		ASSERT_TRUE(codeEmitterAppendString(emitter, "x"));
+		for (int i = 0; i < 200; ++i) {
+			std::string numbered = line + std::to_string(i) + "\n";
+			ASSERT_TRUE(codeEmitterAppend(emitter, numbered.c_str(), numbered.size()));
+			expected = numbered + expected;
+		}
+		ASSERT_TRUE(codeEmitterReverseLines(emitter, 1));
+		ASSERT_EQ(content(), "x" + expected);
+	}
+
+	TEST_F(CodeEmitterTest, Write) {
+		std::string expected;
+		for (int i = 0; expected.size() < 2 * CODE_EMITTER_CHUNK_SIZE + 100; ++i) {
+			std::string line = "WRITE int@" + std::to_string(i) + "\n";
+			ASSERT_TRUE(codeEmitterAppend(emitter, line.c_str(), line.size()));
+			expected += line;
+		}
+		FILE *file = tmpfile();
+		ASSERT_NE(file, nullptr);
+		ASSERT_TRUE(codeEmitterWrite(emitter, fileno(file)));
+		rewind(file);
+		std::string written(expected.size() + 1, 0);
+		ASSERT_EQ(fread(&written[0], 1, written.size(), file), expected.size());
+		written.resize(expected.size());
+		ASSERT_EQ(written, expected);
+		fclose(file);
+	}
+
+	static std::string formatNumber(long number) {
+		char buffer[CODE_EMITTER_NUMBER_LENGTH];
+		return std::string(buffer, codeEmitterFormatNumber(buffer, number));
+	}
+
+	static std::string formatFloat(double number) {
+		char buffer[CODE_EMITTER_FLOAT_LENGTH];
+		return std::string(buffer, codeEmitterFormatFloat(buffer, number));
+	}
+
+	static std::string printfString(const char *format, ...) {
+		char buffer[64];
+		va_list args;
+		va_start(args, format);
+		vsnprintf(buffer, sizeof(buffer), format, args);
+		va_end(args);
+		return buffer;
+	}
+
+	TEST(CodeEmitterFormatTest, Number) {
+		long numbers[] = {0, 1, 9, 10, 99, 100, 101, 999, 1000, -1, -10, -99, -100, 1234567890, LONG_MAX, LONG_MIN};
+		for (long number : numbers) {
+			ASSERT_EQ(formatNumber(number), printfString("%ld", number));
+		}
+	}
+
+	TEST(CodeEmitterFormatTest, NumberRandom) {
+		std::mt19937_64 generator(42);
+		for (int i = 0; i < 100000; ++i) {
+			// random magnitudes, so that short numbers are tested too
+			long number = (long) (generator() >> (generator() % 64));
+			ASSERT_EQ(formatNumber(number), printfString("%ld", number));
+			ASSERT_EQ(formatNumber(-number), printfString("%ld", -number));
+		}
+	}
+
+	TEST(CodeEmitterFormatTest, Float) {
+		double numbers[] = {0.0, -0.0, 1.0, -1.0, 0.5, 2.0, 0.1, 3.14, 1e300, -1e-300, DBL_MAX, DBL_MIN,
+		                    DBL_MIN / 4503599627370496.0, DBL_MIN / 3, DBL_EPSILON, INFINITY, -INFINITY, NAN, -NAN};
+		for (double number : numbers) {
+			ASSERT_EQ(formatFloat(number), printfString("%a", number));
+		}
+	}
+
+	TEST(CodeEmitterFormatTest, FloatRandom) {
+		std::mt19937_64 generator(42);
+		for (int i = 0; i < 100000; ++i) {
+			// random bit patterns, including subnormal numbers, infinities and NaNs
+			uint64_t bits = generator();
+			double number;
+			memcpy(&number, &bits, sizeof(number));
+			ASSERT_EQ(formatFloat(number), printfString("%a", number));
+		}
+	}
+
+	TEST_F(CodeEmitterTest, AppendFloat) {
+		ASSERT_TRUE(codeEmitterAppendString(emitter, "float@"));
+		ASSERT_TRUE(codeEmitterAppendFloat(emitter, 0.1));
+		ASSERT_EQ(content(), "float@0x1.999999999999ap-4");
+	}
+
+	TEST_F(CodeEmitterTest, AppendNumberChunkBoundary) {
+		std::string data(CODE_EMITTER_CHUNK_SIZE - 3, 'x');
+		ASSERT_TRUE(codeEmitterAppend(emitter, data.c_str(), data.size()));
+		ASSERT_TRUE(codeEmitterAppendNumber(emitter, -123456789));
+		ASSERT_TRUE(codeEmitterAppendFloat(emitter, -2.5));
+		ASSERT_EQ(content(), data + "-123456789-0x1.4p+1");
+	}
+
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "ir_program_test.h"
+
+extern "C" {
+#include "common_subexpression.h"
+}
+
+namespace Tests {
+
+	class CommonSubexpressionTest : public IrProgramTest {
+	protected:
+		std::string optimize() {
+			EXPECT_TRUE(cseEliminate(program, &stats));
+			return print();
+		}
+
+		void product(const char *a, const char *b) {
+			ASSERT_TRUE(irEmit(main, IR_PUSHS, variable(a)));
+			ASSERT_TRUE(irEmit(main, IR_PUSHS, variable(b)));
+			ASSERT_TRUE(irEmit(main, IR_MULS));
+		}
+
+		cseStats_t stats = {};
+	};
+
+	TEST_F(CommonSubexpressionTest, ReuseTemporary) {
+		product("a", "b");
+		product("b", "a");
+		ASSERT_TRUE(irEmit(main, IR_ADDS));
+		ASSERT_TRUE(irEmit(main, IR_POPS, variable("c")));
+		ASSERT_EQ(optimize(), ".IFJcode19\nLABEL $$main\nDEFVAR GF@$$cse0\nMUL GF@$$cse0 GF@a GF@b\n"
+							  "PUSHS GF@$$cse0\nPUSHS GF@$$cse0\nADDS\nPOPS GF@c\n");
+		ASSERT_EQ(stats.reused, 1);
+		ASSERT_EQ(stats.removed, 3);
+		ASSERT_EQ(stats.temporaries, 1);
+	}
+
+	TEST_F(CommonSubexpressionTest, ReuseVariable) {
+		product("a", "b");
+		ASSERT_TRUE(irEmit(main, IR_POPS, variable("c")));
+		product("a", "b");
+		ASSERT_TRUE(irEmit(main, IR_PUSHS, irInt(1)));
+		ASSERT_TRUE(irEmit(main, IR_ADDS));
+		ASSERT_TRUE(irEmit(main, IR_POPS, variable("d")));
+		ASSERT_EQ(optimize(), ".IFJcode19\nLABEL $$main\nPUSHS GF@a\nPUSHS GF@b\nMULS\nPOPS GF@c\n"
+							  "PUSHS GF@c\nPUSHS int@1\nADDS\nPOPS GF@d\n");
+		ASSERT_EQ(stats.reused, 1);
+		ASSERT_EQ(stats.temporaries, 0);
+	}
+
+	TEST_F(CommonSubexpressionTest, AssignmentChangesValue) {
+		ASSERT_TRUE(irEmit(main, IR_MUL, variable("c"), variable("a"), variable("b")));
+		ASSERT_TRUE(irEmit(main, IR_MUL, variable("c"), variable("b"), variable("a")));
+		ASSERT_TRUE(irEmit(main, IR_ADD, variable("a"), variable("a"), irInt(1)));
+		ASSERT_TRUE(irEmit(main, IR_MUL, variable("c"), variable("a"), variable("b")));
+		ASSERT_EQ(optimize(), ".IFJcode19\nLABEL $$main\nMUL GF@c GF@a GF@b\nADD GF@a GF@a int@1\n"
+							  "MUL GF@c GF@a GF@b\n");
+		ASSERT_EQ(stats.redundant, 1);
+	}
+
+	TEST_F(CommonSubexpressionTest, CallEndsBlock) {
+		ASSERT_TRUE(irEmit(main, IR_STRLEN, variable("n"), variable("s")));
+		ASSERT_TRUE(irEmit(main, IR_CALL, label("f")));
+		ASSERT_TRUE(irEmit(main, IR_STRLEN, variable("n"), variable("s")));
+		ASSERT_TRUE(irEmit(main, IR_LABEL, label("$loop")));
+		ASSERT_TRUE(irEmit(main, IR_STRLEN, variable("n"), variable("s")));
+		ASSERT_EQ(optimize(), ".IFJcode19\nLABEL $$main\nSTRLEN GF@n GF@s\nCALL f\nSTRLEN GF@n GF@s\n"
+							  "LABEL $loop\nSTRLEN GF@n GF@s\n");
+		ASSERT_EQ(stats.removed, 0);
+	}
+
+	TEST_F(CommonSubexpressionTest, PassedGuard) {
+		for (int i = 0; i < 2; i++) {
+			const char *checked = i == 0 ? "$checked0" : "$checked1";
+			ASSERT_TRUE(irEmit(main, IR_TYPE, variable("t"), variable("s")));
+			ASSERT_TRUE(irEmit(main, IR_JUMPIFEQ, label(checked), variable("t"), irString(strViewString("string"))));
+			ASSERT_TRUE(irEmit(main, IR_EXIT, irInt(4)));
+			ASSERT_TRUE(irEmit(main, IR_LABEL, label(checked)));
+			ASSERT_TRUE(irEmit(main, IR_STRLEN, variable("n"), variable("s")));
+		}
+		ASSERT_EQ(optimize(), ".IFJcode19\nLABEL $$main\nTYPE GF@t GF@s\nJUMPIFEQ $checked0 GF@t string@string\n"
+							  "EXIT int@4\nLABEL $checked0\nSTRLEN GF@n GF@s\n");
+		ASSERT_EQ(stats.redundant, 5);
+	}
+
+}
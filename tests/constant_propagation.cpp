@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "parse_tree_test.h"
+
+extern "C" {
+#include "constant_propagation.h"
+}
+
+namespace Tests {
+
+	class ConstantPropagationTest : public ParseTreeTest {
+	protected:
+		int propagate(const std::string &source) {
+			int errCode = parse(source);
+			if (errCode == ERROR_SUCCESS) {
+				constPropagate(&tree, &errCode);
+			}
+			return errCode;
+		}
+
+		// name of the assigned variable
+		static std::string target(const treeElement_t *assign) {
+			EXPECT_EQ(assign->type, E_ASSIGN);
+			return assign->data.elements[0].data.token->data.strval->string;
+		}
+
+		// literal assigned to the variable, nullptr if not known
+		static token_t *value(treeElement_t *assign) {
+			EXPECT_EQ(assign->type, E_ASSIGN);
+			return getLiteral(&assign->data.elements[1]);
+		}
+	};
+
+	TEST_F(ConstantPropagationTest, Assignments) {
+		ASSERT_EQ(propagate("a = 10\nb = a * 2\nc = b - a\n"), ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_EQ(list.size(), 3);
+		ASSERT_NE(value(list[2]), nullptr);
+		ASSERT_EQ(value(list[2])->type, T_NUMBER);
+		ASSERT_EQ(value(list[2])->data.intval, 10);
+	}
+
+	TEST_F(ConstantPropagationTest, Strings) {
+		ASSERT_EQ(propagate("a = 'x y'\nb = a + a\n"), ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_NE(value(list[1]), nullptr);
+		ASSERT_STREQ(value(list[1])->data.strval->string, "x yx y");
+		ASSERT_STREQ(value(list[1])->operand->string, "string@x\\032yx\\032y");
+	}
+
+	TEST_F(ConstantPropagationTest, UnknownValue) {
+		ASSERT_EQ(propagate("a = inputi()\nb = a + 1\n"), ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_EQ(value(list[1]), nullptr);
+	}
+
+	TEST_F(ConstantPropagationTest, PruneIf) {
+		ASSERT_EQ(propagate("a = 1\nif a > 0:\n    b = 1\nelse:\n    b = 2\nc = b\n"), ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_EQ(list.size(), 3);
+		ASSERT_EQ(target(list[1]), "b");
+		ASSERT_EQ(value(list[1])->data.intval, 1);
+		ASSERT_EQ(value(list[2])->data.intval, 1);
+	}
+
+	TEST_F(ConstantPropagationTest, PruneElse) {
+		ASSERT_EQ(propagate("a = ''\nif a:\n    b = 1\nelse:\n    b = 2\n    c = 3\n"), ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_EQ(list.size(), 3);
+		ASSERT_EQ(target(list[1]), "b");
+		ASSERT_EQ(value(list[1])->data.intval, 2);
+		ASSERT_EQ(target(list[2]), "c");
+	}
+
+	TEST_F(ConstantPropagationTest, PruneIfWithoutElse) {
+		ASSERT_EQ(propagate("if None:\n    b = 1\nc = 2\n"), ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_EQ(list.size(), 1);
+		ASSERT_EQ(target(list[0]), "c");
+	}
+
+	TEST_F(ConstantPropagationTest, MergeBranches) {
+		ASSERT_EQ(propagate("a = 1\nb = inputi()\nif b:\n    a = 2\n    c = 1\nelse:\n    a = 2\n    c = 2\nd = a\ne = c\n"),
+				  ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_EQ(list.size(), 5);
+		ASSERT_EQ(list[2]->type, E_S_IF);
+		ASSERT_NE(value(list[3]), nullptr);
+		ASSERT_EQ(value(list[3])->data.intval, 2);
+		ASSERT_EQ(value(list[4]), nullptr);
+	}
+
+	TEST_F(ConstantPropagationTest, WhileKillsAssignedVariables) {
+		ASSERT_EQ(propagate("a = 10\nb = 1\nwhile a > 0:\n    a = a - b\nc = a\nd = b\n"), ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_EQ(list.size(), 5);
+		treeElement_t *loop = list[2];
+		ASSERT_EQ(loop->type, E_S_WHILE);
+		ASSERT_EQ(getLiteral(&loop->data.elements[0]), nullptr);
+		treeElement_t *decrement = &loop->data.elements[1].data.elements[0];
+		ASSERT_EQ(value(decrement), nullptr);
+		ASSERT_EQ(value(list[3]), nullptr);
+		ASSERT_NE(value(list[4]), nullptr);
+	}
+
+	TEST_F(ConstantPropagationTest, PruneWhile) {
+		ASSERT_EQ(propagate("a = 0\nwhile a:\n    a = a - 1\nb = a\n"), ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_EQ(list.size(), 2);
+		ASSERT_NE(value(list[1]), nullptr);
+		ASSERT_EQ(value(list[1])->data.intval, 0);
+	}
+
+	TEST_F(ConstantPropagationTest, FunctionBody) {
+		ASSERT_EQ(propagate("a = 1\ndef f(x):\n    y = 2\n    return x + y + a\nb = a\n"), ERROR_SUCCESS);
+		treeElement_t &body = tree.data.elements[1].data.elements[2];
+		ASSERT_EQ(body.data.elements[1].type, E_S_RETURN);
+		treeElement_t &sum = body.data.elements[1].data.elements[0].data.elements[0];
+		ASSERT_EQ(sum.type, E_ADD);
+		ASSERT_EQ(sum.data.elements[1].data.token->type, T_ID);
+		ASSERT_EQ(sum.data.elements[0].data.elements[1].data.token->type, T_NUMBER);
+	}
+
+	TEST_F(ConstantPropagationTest, PrunedFirstOccurrence) {
+		// symbol name is viewed from the pruned assignment
+		ASSERT_EQ(propagate("if 0:\n    a = 1\nelse:\n    pass\na = 2\ndef f(a):\n    return a\n"), ERROR_SUCCESS);
+		symbol_t* global = symTableFind(table, strViewString("a"), strViewNull());
+		ASSERT_NE(global, nullptr);
+		ASSERT_NE(global->ownedName, nullptr);
+		symbol_t* parameter = symTableFind(table, strViewString("a"), strViewString("f"));
+		ASSERT_NE(parameter, nullptr);
+		ASSERT_NE(parameter, global);
+		ASSERT_TRUE(strViewEqualString(parameter->name, "a"));
+	}
+
+	TEST_F(ConstantPropagationTest, DivisionByZero) {
+		// fails at run time as without propagation
+		ASSERT_EQ(propagate("a = 0\nb = 1 / a\n"), ERROR_SUCCESS);
+		ASSERT_EQ(value(statements()[1]), nullptr);
+	}
+
+}
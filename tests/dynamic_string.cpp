@@ -16,6 +16,12 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
 #include "gtest/gtest.h"
 
 extern "C" {
@@ -56,7 +62,28 @@ namespace Tests {
 		}
 		ASSERT_STREQ(string->string, "A0123456789");
 		ASSERT_EQ(string->size, 11);
+		ASSERT_EQ(string->alloc_size, DYN_STR_LENGTH);
+		ASSERT_EQ(string->string, string->buffer);
+	}
+
+	TEST_F(DynamicStringTest, AppendCharGrowth) {
+		for (unsigned i = 0; i < DYN_STR_LENGTH; ++i) {
+			ASSERT_TRUE(dynStrAppendChar(string, 'A'));
+		}
+		ASSERT_EQ(string->size, DYN_STR_LENGTH);
 		ASSERT_EQ(string->alloc_size, 2 * DYN_STR_LENGTH);
+		ASSERT_NE(string->string, string->buffer);
+		unsigned reallocations = 0;
+		for (unsigned i = 0; i < 1u << 16u; ++i) {
+			unsigned long allocSize = string->alloc_size;
+			ASSERT_TRUE(dynStrAppendChar(string, 'B'));
+			if (allocSize != string->alloc_size) {
+				++reallocations;
+			}
+		}
+		ASSERT_LE(reallocations, 16u);
+		ASSERT_EQ(string->size, DYN_STR_LENGTH + (1u << 16u));
+		ASSERT_EQ(strlen(string->string), string->size);
 	}
 
 	TEST_F(DynamicStringTest, AppendString) {
@@ -65,7 +92,41 @@ namespace Tests {
 		ASSERT_TRUE(retVal);
 		ASSERT_STREQ(string->string, "ABCD0123456789");
 		ASSERT_EQ(string->size, size);
-		ASSERT_EQ(string->alloc_size, 2 * DYN_STR_LENGTH + size);
+		ASSERT_EQ(string->alloc_size, DYN_STR_LENGTH);
+		retVal = dynStrAppendString(string, "ABCD0123456789");
+		ASSERT_TRUE(retVal);
+		ASSERT_STREQ(string->string, "ABCD0123456789ABCD0123456789");
+		ASSERT_EQ(string->size, 2 * size);
+		ASSERT_EQ(string->alloc_size, 2 * DYN_STR_LENGTH);
+	}
+
+	TEST_F(DynamicStringTest, AppendBuffer) {
+		ASSERT_TRUE(dynStrAppendBuffer(string, "ABCDEF", 3));
+		ASSERT_STREQ(string->string, "ABC");
+		ASSERT_EQ(string->size, 3);
+		ASSERT_FALSE(dynStrAppendBuffer(string, nullptr, 0));
+	}
+
+	TEST_F(DynamicStringTest, ClearRetainsCapacity) {
+		for (unsigned i = 0; i < 4 * DYN_STR_LENGTH; ++i) {
+			dynStrAppendChar(string, 'A');
+		}
+		unsigned long allocSize = string->alloc_size;
+		dynStrClear(string);
+		ASSERT_STREQ(string->string, "");
+		ASSERT_EQ(string->size, 0);
+		ASSERT_EQ(string->alloc_size, allocSize);
+		ASSERT_TRUE(dynStrAppendString(string, "ABCD"));
+		ASSERT_STREQ(string->string, "ABCD");
+	}
+
+	TEST_F(DynamicStringTest, Reserve) {
+		ASSERT_TRUE(dynStrAppendString(string, "ABCD"));
+		ASSERT_TRUE(dynStrReserve(string, 100));
+		ASSERT_GT(string->alloc_size, 100);
+		ASSERT_NE(string->string, string->buffer);
+		ASSERT_STREQ(string->string, "ABCD");
+		ASSERT_FALSE(dynStrReserve(nullptr, 1));
 	}
 
 	TEST_F(DynamicStringTest, Equal) {
@@ -118,6 +179,21 @@ namespace Tests {
 		dynStrFree(tmp);
 	}
 
+	TEST_F(DynamicStringTest, CopyLong) {
+		for (unsigned i = 0; i < 3 * DYN_STR_LENGTH; ++i) {
+			dynStrAppendChar(string, 'a' + i % 26);
+		}
+		dynStr_t *tmp = dynStrClone(string);
+		ASSERT_NE(tmp, nullptr);
+		ASSERT_NE(tmp->string, string->string);
+		ASSERT_EQ(tmp->size, string->size);
+		ASSERT_STREQ(tmp->string, string->string);
+		ASSERT_TRUE(dynStrEqual(tmp, string));
+		ASSERT_TRUE(dynStrCopy(string, string));
+		ASSERT_STREQ(tmp->string, string->string);
+		dynStrFree(tmp);
+	}
+
 	TEST_F(DynamicStringTest, Escape) {
 		dynStrAppendString(string, "retezec s lomitkem \\ a\nnovym#radkem");
 		ASSERT_TRUE(dynStrEscape(string));
@@ -125,6 +201,51 @@ namespace Tests {
 		ASSERT_STREQ(string->string, expected);
 	}
 
+	TEST_F(DynamicStringTest, EscapeWithoutEscapes) {
+		ASSERT_TRUE(dynStrEscape(string));
+		ASSERT_STREQ(string->string, "");
+		dynStrAppendString(string, "retezec_bez_mezer");
+		ASSERT_TRUE(dynStrEscape(string));
+		ASSERT_STREQ(string->string, "retezec_bez_mezer");
+		ASSERT_EQ(string->size, 17);
+	}
+
+	TEST_F(DynamicStringTest, EscapeNonAscii) {
+		dynStrAppendString(string, "\x01\x7f\xc5\xbe");
+		ASSERT_TRUE(dynStrEscape(string));
+		ASSERT_STREQ(string->string, "\\001\\127\xc5\xbe");
+	}
+
+	TEST_F(DynamicStringTest, EscapeRandom) {
+		std::srand(2019);
+		for (unsigned round = 0; round < 200; ++round) {
+			std::string input;
+			std::string expected;
+			unsigned length = std::rand() % 200;
+			for (unsigned i = 0; i < length; ++i) {
+				// mostly printable characters to exercise long unescaped runs
+				unsigned char c = std::rand() % 4 == 0 ? std::rand() % 255 + 1 : 'a' + std::rand() % 26;
+				input.push_back(c);
+				if (c <= 32 || c == '#' || c == '\\' || c == 127) {
+					char esc[8];
+					snprintf(esc, sizeof(esc), "\\%03d", c);
+					expected.append(esc);
+				} else {
+					expected.push_back(c);
+				}
+			}
+			dynStrClear(string);
+			ASSERT_TRUE(dynStrAppendString(string, input.c_str()));
+			ASSERT_TRUE(dynStrEscape(string));
+			ASSERT_EQ(string->size, expected.size());
+			ASSERT_STREQ(string->string, expected.c_str());
+		}
+	}
+
+	TEST_F(DynamicStringTest, EscapeNull) {
+		ASSERT_FALSE(dynStrEscape(nullptr));
+	}
+
 	TEST_F(DynamicStringTest, GetChar) {
 		dynStrAppendChar(string, 'A');
 		ASSERT_EQ(dynStrGetChar(string, 0), 'A');
@@ -135,4 +256,106 @@ namespace Tests {
 		dynStrAppendChar(string, 'A');
 		ASSERT_STREQ(dynStrGetString(string), "A");
 	}
+
+	/**
+	 * Dynamic string with the original fixed-step growth, used as the benchmark baseline
+	 */
+	struct LegacyString {
+		char *string;
+		unsigned long size;
+		unsigned long alloc_size;
+
+		LegacyString() : string((char *) calloc(8, 1)), size(0), alloc_size(8) {}
+
+		~LegacyString() {
+			free(string);
+		}
+
+		void appendChar(char c) {
+			if (size + 1 >= alloc_size) {
+				alloc_size += 8;
+				string = (char *) realloc(string, alloc_size);
+			}
+			string[size++] = c;
+			string[size] = 0;
+		}
+
+		void appendString(const char *str) {
+			size_t strLen = strlen(str);
+			if (size + strLen + 1 >= alloc_size) {
+				alloc_size += strLen + 8;
+				string = (char *) realloc(string, alloc_size);
+			}
+			strcat(string, str);
+			size += strLen;
+		}
+	};
+
+	template<typename Function>
+	static double benchmark(Function function) {
+		auto start = std::chrono::steady_clock::now();
+		function();
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		return elapsed.count();
+	}
+
+	TEST(DynamicStringBenchmark, AppendChar) {
+		const unsigned count = 1u << 20u;
+		double before = benchmark([count]() {
+			LegacyString string;
+			for (unsigned i = 0; i < count; ++i) {
+				string.appendChar('A');
+			}
+			ASSERT_EQ(string.size, count);
+		});
+		double after = benchmark([count]() {
+			dynStr_t *string = dynStrInit();
+			for (unsigned i = 0; i < count; ++i) {
+				dynStrAppendChar(string, 'A');
+			}
+			ASSERT_EQ(string->size, count);
+			dynStrFree(string);
+		});
+		std::cout << "[ BENCH    ] dynStrAppendChar x" << count << ": before " << before << " ms, after " << after << " ms" << std::endl;
+	}
+
+	TEST(DynamicStringBenchmark, AppendString) {
+		const unsigned count = 1u << 14u;
+		double before = benchmark([count]() {
+			LegacyString string;
+			for (unsigned i = 0; i < count; ++i) {
+				string.appendString("PUSHS LF@a\n");
+			}
+			ASSERT_EQ(string.size, 11 * count);
+		});
+		double after = benchmark([count]() {
+			dynStr_t *string = dynStrInit();
+			for (unsigned i = 0; i < count; ++i) {
+				dynStrAppendString(string, "PUSHS LF@a\n");
+			}
+			ASSERT_EQ(string->size, 11 * count);
+			dynStrFree(string);
+		});
+		std::cout << "[ BENCH    ] dynStrAppendString x" << count << ": before " << before << " ms, after " << after << " ms" << std::endl;
+	}
+
+	TEST(DynamicStringBenchmark, ShortIdentifiers) {
+		const unsigned count = 1u << 16u;
+		double before = benchmark([count]() {
+			for (unsigned i = 0; i < count; ++i) {
+				LegacyString string;
+				string.appendString("identifier");
+				string.appendChar('_');
+			}
+		});
+		double after = benchmark([count]() {
+			for (unsigned i = 0; i < count; ++i) {
+				dynStr_t *string = dynStrInit();
+				dynStrAppendString(string, "identifier");
+				dynStrAppendChar(string, '_');
+				dynStrFree(string);
+			}
+		});
+		std::cout << "[ BENCH    ] short identifier x" << count << ": before " << before << " ms, after " << after << " ms" << std::endl;
+	}
 }
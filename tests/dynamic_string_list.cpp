@@ -276,4 +276,33 @@ namespace Tests {
 		dynStrListElFree(element);
 	}
 
+	TEST_F(DynamicStringListTest, PushBackViewNull) {
+		ASSERT_FALSE(dynStrListPushBackView(list, strViewNull()));
+		ASSERT_FALSE(dynStrListPushBackView(nullptr, strViewString("A")));
+		ASSERT_TRUE(dynStrListIsEmpty(list));
+	}
+
+	TEST_F(DynamicStringListTest, PushBackView) {
+		const char *name = "abc";
+		ASSERT_TRUE(dynStrListPushBack(list, createDynStr("A")));
+		ASSERT_TRUE(dynStrListPushBackView(list, strViewString(name)));
+		ASSERT_EQ(dynStrListSize(list), 2);
+		dynStrListEl_t *element = dynStrListBack(list);
+		ASSERT_EQ(dynStrListElGet(element), nullptr);
+		strView_t view = dynStrListElGetView(element);
+		ASSERT_EQ(view.string, name);
+		ASSERT_EQ(view.length, 3);
+		view = dynStrListElGetView(dynStrListFront(list));
+		ASSERT_TRUE(strViewEqualString(view, "A"));
+		ASSERT_TRUE(strViewIsNull(dynStrListElGetView(nullptr)));
+	}
+
+	TEST_F(DynamicStringListTest, InitElementView) {
+		ASSERT_EQ(dynStrListElInitView(strViewNull()), nullptr);
+		dynStrListEl_t *element = dynStrListElInitView(strViewString("A"));
+		ASSERT_NE(element, nullptr);
+		ASSERT_EQ(element->string, nullptr);
+		ASSERT_TRUE(strViewEqualString(dynStrListElGetView(element), "A"));
+		dynStrListElFree(element);
+	}
 }
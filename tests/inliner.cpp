@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "ir_program_test.h"
+
+extern "C" {
+#include "inliner.h"
+}
+
+namespace Tests {
+
+	class InlinerTest : public IrProgramTest {
+	protected:
+		std::string optimize() {
+			EXPECT_TRUE(inlineFunctions(program, &stats));
+			return print();
+		}
+
+		irFunction_t *function(const char *name) {
+			irFunction_t *function = irProgramAddFunction(program, strViewString(name));
+			EXPECT_NE(function, nullptr);
+			return function;
+		}
+
+		void call(irFunction_t *caller, const char *name) {
+			EXPECT_TRUE(irEmit(caller, IR_CREATEFRAME));
+			EXPECT_TRUE(irEmit(caller, IR_PUSHFRAME));
+			EXPECT_TRUE(irEmit(caller, IR_CALL, irLabel(strViewString(name), -1)));
+			EXPECT_TRUE(irEmit(caller, IR_POPFRAME));
+		}
+
+		irOperand_t local(const char *name) {
+			return irVariable(FRAME_LOCAL, strViewString(name));
+		}
+
+		inlinerStats_t stats = {};
+	};
+
+	TEST_F(InlinerTest, Leaf) {
+		irFunction_t *leaf = function("leaf");
+		ASSERT_TRUE(irEmit(leaf, IR_WRITE, irInt(1)));
+		ASSERT_TRUE(irEmit(leaf, IR_RETURN));
+		irFunction_t *caller = function("caller");
+		call(caller, "leaf");
+		ASSERT_TRUE(irEmit(caller, IR_RETURN));
+		size_t size = 0;
+		ASSERT_TRUE(inlinerIsLeaf(leaf, &size));
+		ASSERT_EQ(size, 2);
+		ASSERT_FALSE(inlinerIsLeaf(caller, nullptr));
+		ASSERT_TRUE(irEmit(leaf, IR_MOVE, irVariable(FRAME_TEMP, strViewString("a")), irInt(1)));
+		// the temporary frame of the call belongs to the inlined body
+		ASSERT_FALSE(inlinerIsLeaf(leaf, nullptr));
+	}
+
+	TEST_F(InlinerTest, ReturnsAndLocals) {
+		irFunction_t *max = function("max");
+		ASSERT_TRUE(irEmit(max, IR_DEFVAR, local("%retval")));
+		ASSERT_TRUE(irEmit(max, IR_MOVE, local("%retval"), local("b")));
+		ASSERT_TRUE(irEmit(max, IR_JUMPIFEQ, irLabel(strViewString("$if"), 0), local("a"), local("b")));
+		ASSERT_TRUE(irEmit(max, IR_RETURN));
+		ASSERT_TRUE(irEmit(max, IR_LABEL, irLabel(strViewString("$if"), 0)));
+		ASSERT_TRUE(irEmit(max, IR_MOVE, local("%retval"), local("a")));
+		ASSERT_TRUE(irEmit(max, IR_RETURN));
+		ASSERT_TRUE(irEmit(max, IR_RETURN));
+		call(main, "max");
+		call(main, "max");
+		ASSERT_EQ(optimize(), ".IFJcode19\nLABEL $$main\n"
+							  "CREATEFRAME\nDEFVAR TF@%retval\nMOVE TF@%retval TF@b\nJUMPIFEQ $if0$0 TF@a TF@b\n"
+							  "JUMP $inlineEnd0\nLABEL $if0$0\nMOVE TF@%retval TF@a\nLABEL $inlineEnd0\n"
+							  "CREATEFRAME\nDEFVAR TF@%retval\nMOVE TF@%retval TF@b\nJUMPIFEQ $if0$1 TF@a TF@b\n"
+							  "JUMP $inlineEnd1\nLABEL $if0$1\nMOVE TF@%retval TF@a\nLABEL $inlineEnd1\n");
+		ASSERT_EQ(stats.calls, 2);
+		ASSERT_EQ(stats.removed, 1);
+		ASSERT_EQ(stats.before, 16);
+		ASSERT_EQ(stats.after, 16);
+	}
+
+	TEST_F(InlinerTest, CostModel) {
+		irFunction_t *big = function("big");
+		for (int i = 0; i <= INLINER_MAX_SIZE; ++i) {
+			ASSERT_TRUE(irEmit(big, IR_WRITE, irInt(i)));
+		}
+		irFunction_t *once = function("once");
+		for (int i = 0; i <= INLINER_MAX_SIZE; ++i) {
+			ASSERT_TRUE(irEmit(once, IR_WRITE, irInt(i)));
+		}
+		call(main, "big");
+		call(main, "big");
+		call(main, "once");
+		optimize();
+		// the large function called once is inlined and removed
+		ASSERT_EQ(stats.calls, 1);
+		ASSERT_EQ(stats.removed, 1);
+		ASSERT_EQ(program->first->next, big);
+		ASSERT_EQ(big->next, nullptr);
+	}
+
+	TEST_F(InlinerTest, StackCallingConvention) {
+		irFunction_t *inc = function("inc");
+		ASSERT_TRUE(irEmit(inc, IR_CREATEFRAME));
+		ASSERT_TRUE(irEmit(inc, IR_PUSHFRAME));
+		ASSERT_TRUE(irEmit(inc, IR_DEFVAR, local("x")));
+		ASSERT_TRUE(irEmit(inc, IR_POPS, local("x")));
+		ASSERT_TRUE(irEmit(inc, IR_ADD, local("x"), local("x"), irInt(1)));
+		ASSERT_TRUE(irEmit(inc, IR_PUSHS, local("x")));
+		ASSERT_TRUE(irEmit(inc, IR_POPFRAME));
+		ASSERT_TRUE(irEmit(inc, IR_RETURN));
+		irFunction_t *two = function("two");
+		ASSERT_TRUE(irEmit(two, IR_PUSHS, irInt(2)));
+		ASSERT_TRUE(irEmit(two, IR_RETURN));
+		ASSERT_FALSE(inlinerIsLeaf(inc, nullptr));
+		size_t size = 0;
+		ASSERT_TRUE(inlinerIsStackLeaf(inc, &size));
+		ASSERT_EQ(size, 8);
+		ASSERT_TRUE(inlinerIsStackLeaf(two, nullptr));
+		ASSERT_TRUE(irEmit(main, IR_CALL, irLabel(strViewString("two"), -1)));
+		ASSERT_TRUE(irEmit(main, IR_CALL, irLabel(strViewString("inc"), -1)));
+		ASSERT_TRUE(irEmit(main, IR_POPS, irVariable(FRAME_GLOBAL, strViewString("a"))));
+		ASSERT_EQ(optimize(), ".IFJcode19\nLABEL $$main\nPUSHS int@2\n"
+							  "CREATEFRAME\nDEFVAR TF@x\nPOPS TF@x\nADD TF@x TF@x int@1\nPUSHS TF@x\n"
+							  "POPS GF@a\n");
+		ASSERT_EQ(stats.calls, 2);
+		ASSERT_EQ(stats.removed, 2);
+	}
+
+	TEST_F(InlinerTest, StackFrameNotPopped) {
+		irFunction_t *leak = function("leak");
+		ASSERT_TRUE(irEmit(leak, IR_CREATEFRAME));
+		ASSERT_TRUE(irEmit(leak, IR_PUSHFRAME));
+		ASSERT_TRUE(irEmit(leak, IR_POPFRAME));
+		ASSERT_TRUE(irEmit(leak, IR_PUSHS, irInt(1)));
+		ASSERT_TRUE(irEmit(leak, IR_RETURN));
+		ASSERT_FALSE(inlinerIsStackLeaf(leak, nullptr));
+	}
+
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "ir_program_test.h"
+
+extern "C" {
+#include "intermediate_code.h"
+}
+
+namespace Tests {
+
+	class IntermediateCodeTest : public EmitterTest {
+	protected:
+		void SetUp() override {
+			EmitterTest::SetUp();
+			program = irProgramInit();
+			ASSERT_NE(program, nullptr);
+		}
+
+		void TearDown() override {
+			irProgramFree(program);
+			EmitterTest::TearDown();
+		}
+
+		std::string print(const irInstruction_t &instruction) {
+			codeEmitterClear(emitter);
+			EXPECT_TRUE(irPrintInstruction(emitter, &instruction));
+			return content();
+		}
+
+		size_t blocks(const irFunction_t *function) {
+			size_t count = 0;
+			for (const irBlock_t *block = function->first; block != nullptr; block = block->next) {
+				++count;
+			}
+			return count;
+		}
+
+		irProgram_t *program = nullptr;
+	};
+
+	TEST_F(IntermediateCodeTest, Opcodes) {
+		ASSERT_STREQ(irOpcodeName(IR_MOVE), "MOVE");
+		ASSERT_STREQ(irOpcodeName(IR_JUMPIFNEQS), "JUMPIFNEQS");
+		ASSERT_EQ(irOpcodeOperands(IR_ADD), 3);
+		ASSERT_EQ(irOpcodeOperands(IR_ADDS), 0);
+		ASSERT_EQ(irOpcodeOperands(IR_PUSHS), 1);
+		ASSERT_TRUE(irOpcodeIsTerminator(IR_JUMP));
+		ASSERT_TRUE(irOpcodeIsTerminator(IR_RETURN));
+		ASSERT_FALSE(irOpcodeIsTerminator(IR_CALL));
+	}
+
+	TEST_F(IntermediateCodeTest, PrintOperands) {
+		irInstruction_t instruction = {IR_JUMPIFEQ, {irLabel(strViewString("$if"), 7),
+			irVariable(FRAME_LOCAL, strViewString("a")), irString(strViewString("a\\032b"))}};
+		ASSERT_EQ(print(instruction), "JUMPIFEQ $if7 LF@a string@a\\032b\n");
+		instruction = {IR_ADD, {irVariable(FRAME_GLOBAL, strViewString("x")), irInt(-3), irFloat(0.5)}};
+		ASSERT_EQ(print(instruction), "ADD GF@x int@-3 float@0x1p-1\n");
+		instruction = {IR_AND, {irVariable(FRAME_TEMP, strViewString("%retval")), irBool(true), irBool(false)}};
+		ASSERT_EQ(print(instruction), "AND TF@%retval bool@true bool@false\n");
+		instruction = {IR_READ, {irVariable(FRAME_TEMP, strViewString("a")), irType(strViewString("int"))}};
+		ASSERT_EQ(print(instruction), "READ TF@a int\n");
+		instruction = {IR_PUSHS, {irNil()}};
+		ASSERT_EQ(print(instruction), "PUSHS nil@nil\n");
+		instruction = {IR_CALL, {irLabel(strViewString("foo"), -1)}};
+		ASSERT_EQ(print(instruction), "CALL foo\n");
+	}
+
+	TEST_F(IntermediateCodeTest, OperandEqual) {
+		irOperand_t a = irVariable(FRAME_GLOBAL, strViewString("a"));
+		irOperand_t b = irVariable(FRAME_LOCAL, strViewString("a"));
+		irOperand_t c = irLabel(strViewString("$if"), 1);
+		irOperand_t d = irLabel(strViewString("$if"), 2);
+		irOperand_t e = irInt(1);
+		ASSERT_TRUE(irOperandEqual(&a, &a));
+		ASSERT_FALSE(irOperandEqual(&a, &b));
+		ASSERT_FALSE(irOperandEqual(&c, &d));
+		ASSERT_FALSE(irOperandEqual(&c, &e));
+	}
+
+	TEST_F(IntermediateCodeTest, BasicBlocks) {
+		irFunction_t *function = irProgramAddFunction(program, strViewString("$$main"));
+		ASSERT_NE(function, nullptr);
+		program->main = function;
+		ASSERT_TRUE(irEmit(function, IR_LABEL, irLabel(strViewString("$while"), 0)));
+		ASSERT_TRUE(irEmit(function, IR_PUSHS, irInt(1)));
+		ASSERT_EQ(blocks(function), 1);
+		ASSERT_TRUE(irEmit(function, IR_JUMPIFEQS, irLabel(strViewString("$end"), 0)));
+		ASSERT_TRUE(irEmit(function, IR_WRITE, irInt(1)));
+		ASSERT_EQ(blocks(function), 2);
+		ASSERT_TRUE(irEmit(function, IR_LABEL, irLabel(strViewString("$end"), 0)));
+		ASSERT_EQ(blocks(function), 3);
+		ASSERT_TRUE(irEmit(function, IR_JUMP, irLabel(strViewString("$while"), 0)));
+		ASSERT_EQ(blocks(function), 3);
+		ASSERT_TRUE(irPrint(emitter, program));
+		ASSERT_EQ(content(), ".IFJcode19\nLABEL $$main\nLABEL $while0\nPUSHS int@1\nJUMPIFEQS $end0\n"
+							 "WRITE int@1\nLABEL $end0\nJUMP $while0\n");
+	}
+
+	TEST_F(IntermediateCodeTest, ReverseAndTruncate) {
+		irFunction_t *function = irProgramAddFunction(program, strViewString("$$main"));
+		ASSERT_NE(function, nullptr);
+		program->main = function;
+		ASSERT_TRUE(irEmit(function, IR_CREATEFRAME));
+		irPosition_t position = irFunctionPosition(function);
+		ASSERT_TRUE(irEmit(function, IR_PUSHS, irInt(1)));
+		ASSERT_TRUE(irEmit(function, IR_PUSHS, irInt(2)));
+		ASSERT_TRUE(irEmit(function, IR_PUSHS, irInt(3)));
+		ASSERT_TRUE(irFunctionReverse(function, position));
+		ASSERT_TRUE(irPrint(emitter, program));
+		ASSERT_EQ(content(), ".IFJcode19\nLABEL $$main\nCREATEFRAME\nPUSHS int@3\nPUSHS int@2\nPUSHS int@1\n");
+		ASSERT_TRUE(irFunctionTruncate(function, position));
+		codeEmitterClear(emitter);
+		ASSERT_TRUE(irPrint(emitter, program));
+		ASSERT_EQ(content(), ".IFJcode19\nLABEL $$main\nCREATEFRAME\n");
+	}
+
+	TEST_F(IntermediateCodeTest, Prepend) {
+		irFunction_t *function = irProgramAddFunction(program, strViewString("$$main"));
+		ASSERT_NE(function, nullptr);
+		program->main = function;
+		irInstruction_t definition = {.opcode = IR_DEFVAR, .operands = {irVariable(FRAME_GLOBAL, strViewString("a"))}};
+		ASSERT_TRUE(irFunctionPrepend(function, &definition));
+		ASSERT_TRUE(irEmit(function, IR_LABEL, irLabel(strViewString("loop"), 0)));
+		ASSERT_TRUE(irEmit(function, IR_JUMP, irLabel(strViewString("loop"), 0)));
+		definition.operands[0] = irVariable(FRAME_GLOBAL, strViewString("b"));
+		ASSERT_TRUE(irFunctionPrepend(function, &definition));
+		ASSERT_TRUE(irPrint(emitter, program));
+		ASSERT_EQ(content(), ".IFJcode19\nLABEL $$main\nDEFVAR GF@b\nDEFVAR GF@a\nLABEL loop0\nJUMP loop0\n");
+		// the label still starts its own block
+		ASSERT_EQ(function->first->count, 2);
+		ASSERT_EQ(function->first->next->instructions[0].opcode, IR_LABEL);
+	}
+
+	TEST_F(IntermediateCodeTest, PrintProgram) {
+		ASSERT_NE(irProgramAddCode(program, strViewString("len"), strViewString("LABEL len\nRETURN\n")), nullptr);
+		irFunction_t *main = irProgramAddFunction(program, strViewString("$$main"));
+		ASSERT_NE(main, nullptr);
+		program->main = main;
+		irFunction_t *function = irProgramAddFunction(program, strViewString("foo"));
+		ASSERT_NE(function, nullptr);
+		ASSERT_TRUE(irEmit(function, IR_RETURN));
+		ASSERT_TRUE(irEmit(main, IR_CALL, irLabel(strViewString("foo"), -1)));
+		ASSERT_TRUE(irPrint(emitter, program));
+		ASSERT_EQ(content(), ".IFJcode19\nJUMP $$main\nLABEL len\nRETURN\nLABEL foo\nRETURN\n"
+							 "LABEL $$main\nCALL foo\n");
+	}
+
+	TEST_F(IntermediateCodeTest, RemoveFunctionAndNames) {
+		irFunction_t *first = irProgramAddFunction(program, strViewString("first"));
+		irFunction_t *main = irProgramAddFunction(program, strViewString("$$main"));
+		irFunction_t *last = irProgramAddFunction(program, strViewString("last"));
+		ASSERT_NE(last, nullptr);
+		program->main = main;
+		ASSERT_TRUE(irEmit(last, IR_RETURN));
+		ASSERT_FALSE(irProgramRemoveFunction(program, main));
+		ASSERT_TRUE(irProgramRemoveFunction(program, last));
+		ASSERT_EQ(program->last, main);
+		ASSERT_FALSE(irProgramRemoveFunction(program, last));
+		ASSERT_TRUE(irProgramRemoveFunction(program, first));
+		ASSERT_EQ(program->first, main);
+		std::string name = "$if0$1";
+		strView_t copy = irProgramAddName(program, name.c_str());
+		name.clear();
+		ASSERT_TRUE(strViewEqualString(copy, "$if0$1"));
+		ASSERT_TRUE(irEmit(main, IR_JUMP, irLabel(copy, -1)));
+		ASSERT_TRUE(irPrint(emitter, program));
+		ASSERT_EQ(content(), ".IFJcode19\nLABEL $$main\nJUMP $if0$1\n");
+	}
+
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#pragma once
+
+#include <string>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "intermediate_code.h"
+}
+
+namespace Tests {
+
+	/**
+	 * Fixture for the code written to a code emitter
+	 */
+	class EmitterTest : public ::testing::Test {
+	protected:
+		void SetUp() override {
+			emitter = codeEmitterInit();
+			ASSERT_NE(emitter, nullptr);
+		}
+
+		void TearDown() override {
+			codeEmitterFree(emitter);
+		}
+
+		std::string content() {
+			std::string string;
+			for (size_t i = 0; i < codeEmitterSize(emitter); ++i) {
+				string += codeEmitterAt(emitter, i);
+			}
+			return string;
+		}
+
+		codeEmitter_t *emitter = nullptr;
+	};
+
+	/**
+	 * Fixture for the passes over the intermediate code, the program has the main function
+	 */
+	class IrProgramTest : public EmitterTest {
+	protected:
+		void SetUp() override {
+			EmitterTest::SetUp();
+			program = irProgramInit();
+			ASSERT_NE(program, nullptr);
+			main = irProgramAddFunction(program, strViewString("$$main"));
+			ASSERT_NE(main, nullptr);
+			program->main = main;
+		}
+
+		void TearDown() override {
+			irProgramFree(program);
+			EmitterTest::TearDown();
+		}
+
+		// whole program in IFJcode19 format
+		std::string print() {
+			EXPECT_TRUE(irPrint(emitter, program));
+			return content();
+		}
+
+		irOperand_t variable(const char *name) {
+			return irVariable(FRAME_GLOBAL, strViewString(name));
+		}
+
+		irOperand_t label(const char *name) {
+			return irLabel(strViewString(name), -1);
+		}
+
+		irProgram_t *program = nullptr;
+		irFunction_t *main = nullptr;
+	};
+
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "parse_tree_test.h"
+
+extern "C" {
+#include "loop_invariant.h"
+#include "type_inference.h"
+}
+
+namespace Tests {
+
+	class LoopInvariantTest : public ParseTreeTest {
+	protected:
+		int hoist(const std::string &source) {
+			int errCode = parse(source);
+			if (errCode == ERROR_SUCCESS) {
+				typeInfer(&tree, &errCode);
+			}
+			if (errCode == ERROR_SUCCESS) {
+				loopHoistInvariants(&tree, table, &errCode);
+			}
+			return errCode;
+		}
+
+		// statements of the first block
+		treeElement_t &block(unsigned index = 0) {
+			for (unsigned i = 0; i < tree.nodeSize; ++i) {
+				if (tree.data.elements[i].type == E_CODE_BLOCK && index-- == 0) {
+					return tree.data.elements[i];
+				}
+			}
+			ADD_FAILURE();
+			return tree;
+		}
+
+		// name of the assigned variable
+		static std::string target(const treeElement_t &assign) {
+			EXPECT_EQ(assign.type, E_ASSIGN);
+			return assign.data.elements[0].data.token->data.strval->string;
+		}
+	};
+
+	TEST_F(LoopInvariantTest, Arithmetic) {
+		ASSERT_EQ(hoist("a = 2\nb = 3\ni = 0\nwhile i < 10:\n    i = i + a * b\n"), ERROR_SUCCESS);
+		treeElement_t &code = block();
+		ASSERT_EQ(code.nodeSize, 5);
+		ASSERT_EQ(target(code.data.elements[3]).rfind("$invariant", 0), 0);
+		ASSERT_EQ(code.data.elements[3].data.elements[1].data.elements[0].type, E_MUL);
+		ASSERT_EQ(code.data.elements[4].type, E_S_WHILE);
+		// i = i + $invariant0
+		treeElement_t &sum = code.data.elements[4].data.elements[1].data.elements[0].data.elements[1].data.elements[0];
+		ASSERT_EQ(sum.type, E_ADD);
+		ASSERT_EQ(sum.data.elements[1].type, E_TOKEN);
+		ASSERT_EQ(sum.data.elements[1].symbol, code.data.elements[3].data.elements[0].symbol);
+		ASSERT_EQ(code.data.elements[3].data.elements[0].symbol->context.string, nullptr);
+	}
+
+	TEST_F(LoopInvariantTest, AssignedInLoop) {
+		ASSERT_EQ(hoist("a = 2\ni = 0\nwhile i < 10:\n    i = i + a * 2\n    a = 3\n"), ERROR_SUCCESS);
+		ASSERT_EQ(block().nodeSize, 3);
+	}
+
+	TEST_F(LoopInvariantTest, SideEffectsAndFailures) {
+		// calls of user functions, division by a variable and unknown types stay in the loop
+		ASSERT_EQ(hoist("def f(x):\n    return x\n"
+						"a = 2\nb = inputi()\nc = f(1)\ni = 0\n"
+						"while i < 10:\n    i = i + f(a) + 10 // b + c * 2\n"), ERROR_SUCCESS);
+		ASSERT_EQ(block().nodeSize, 5);
+	}
+
+	TEST_F(LoopInvariantTest, NestedLoops) {
+		ASSERT_EQ(hoist("s = 'abc'\ni = 0\nwhile i < 3:\n    j = 0\n    while j < len(s):\n        j = j + i * 2\n"
+						"    i = i + 1\n"), ERROR_SUCCESS);
+		treeElement_t &code = block();
+		// len(s) is invariant in both loops, i * 2 only in the inner one
+		ASSERT_EQ(code.nodeSize, 4);
+		ASSERT_EQ(code.data.elements[2].data.elements[1].data.elements[0].type, E_S_FUNCTION_CALL);
+		treeElement_t &body = code.data.elements[3].data.elements[1];
+		ASSERT_EQ(body.nodeSize, 4);
+		ASSERT_EQ(body.data.elements[1].type, E_ASSIGN);
+		ASSERT_EQ(body.data.elements[1].data.elements[1].data.elements[0].type, E_MUL);
+		ASSERT_EQ(body.data.elements[2].type, E_S_WHILE);
+	}
+
+	TEST_F(LoopInvariantTest, FunctionBody) {
+		ASSERT_EQ(hoist("def f():\n    a = 'x'\n    i = 0\n    while i < 3:\n        i = i + len(a)\n    return i\n"),
+				  ERROR_SUCCESS);
+		treeElement_t &function = tree.data.elements[0];
+		ASSERT_EQ(function.type, E_S_FUNCTION_DEF);
+		treeElement_t &body = function.data.elements[function.nodeSize - 1];
+		ASSERT_EQ(body.nodeSize, 5);
+		symbol_t *temporary = body.data.elements[2].data.elements[0].symbol;
+		ASSERT_NE(temporary, nullptr);
+		ASSERT_TRUE(strViewEqualString(temporary->context, "f"));
+		ASSERT_EQ(std::string(temporary->operand->string).rfind("LF@$invariant", 0), 0);
+	}
+
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "parser.h"
+#include "semantic_analysis.h"
+}
+
+namespace Tests {
+
+	/**
+	 * Fixture for the passes over the semantically checked parse tree of a source
+	 */
+	class ParseTreeTest : public ::testing::Test {
+	protected:
+		void SetUp() override {
+			table = symTableInit();
+			symTableInsertEmbedFunctions(table);
+		}
+
+		void TearDown() override {
+			if (parsed) {
+				treeFree(tree);
+			}
+			symTableFree(table);
+		}
+
+		// every source is parsed to a new tree with a new symbol table
+		int parse(const std::string &source) {
+			TearDown();
+			parsed = false;
+			SetUp();
+			FILE *file = fmemopen((void *) source.c_str(), source.size(), "r");
+			EXPECT_NE(file, nullptr);
+			int errCode = ERROR_SUCCESS;
+			tree = syntaxParse(file, table, &errCode);
+			fclose(file);
+			if (errCode != ERROR_SUCCESS) {
+				return errCode;
+			}
+			parsed = true;
+			semanticCheck(&tree, table, &errCode);
+			return errCode;
+		}
+
+		// top-level statements
+		std::vector<treeElement_t *> statements() {
+			std::vector<treeElement_t *> list;
+			for (unsigned i = 0; i < tree.nodeSize; ++i) {
+				treeElement_t &block = tree.data.elements[i];
+				for (unsigned j = 0; block.type == E_CODE_BLOCK && j < block.nodeSize; ++j) {
+					list.push_back(&block.data.elements[j]);
+				}
+			}
+			return list;
+		}
+
+		symTable_t *table = nullptr;
+		treeElement_t tree = {};
+		bool parsed = false;
+	};
+
+}
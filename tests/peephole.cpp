@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "ir_program_test.h"
+
+extern "C" {
+#include "peephole.h"
+}
+
+namespace Tests {
+
+	class PeepholeTest : public IrProgramTest {
+	protected:
+		std::string optimize() {
+			EXPECT_TRUE(peepholeOptimize(program, &stats));
+			return print();
+		}
+
+		peepholeStats_t stats = {};
+	};
+
+	TEST_F(PeepholeTest, PushPop) {
+		ASSERT_TRUE(irEmit(main, IR_PUSHS, irInt(1)));
+		ASSERT_TRUE(irEmit(main, IR_DEFVAR, variable("a")));
+		ASSERT_TRUE(irEmit(main, IR_POPS, variable("a")));
+		ASSERT_EQ(optimize(), ".IFJcode19\nLABEL $$main\nDEFVAR GF@a\nMOVE GF@a int@1\n");
+		ASSERT_EQ(stats.applied[PEEPHOLE_DEFVAR_HOIST], 1);
+		ASSERT_EQ(stats.removed[PEEPHOLE_PUSH_POP], 1);
+	}
+
+	TEST_F(PeepholeTest, DefvarOfPushedVariable) {
+		ASSERT_TRUE(irEmit(main, IR_PUSHS, variable("a")));
+		ASSERT_TRUE(irEmit(main, IR_DEFVAR, variable("a")));
+		ASSERT_EQ(optimize(), ".IFJcode19\nLABEL $$main\nPUSHS GF@a\nDEFVAR GF@a\n");
+	}
+
+	TEST_F(PeepholeTest, StackOperations) {
+		ASSERT_TRUE(irEmit(main, IR_PUSHS, variable("b")));
+		ASSERT_TRUE(irEmit(main, IR_PUSHS, irInt(2)));
+		ASSERT_TRUE(irEmit(main, IR_SUBS));
+		ASSERT_TRUE(irEmit(main, IR_DEFVAR, variable("a")));
+		ASSERT_TRUE(irEmit(main, IR_DEFVAR, variable("c")));
+		ASSERT_TRUE(irEmit(main, IR_POPS, variable("a")));
+		ASSERT_TRUE(irEmit(main, IR_PUSHS, variable("a")));
+		ASSERT_TRUE(irEmit(main, IR_NOTS));
+		ASSERT_TRUE(irEmit(main, IR_POPS, variable("c")));
+		ASSERT_EQ(optimize(), ".IFJcode19\nLABEL $$main\nDEFVAR GF@a\nDEFVAR GF@c\nSUB GF@a GF@b int@2\n"
+							  "NOT GF@c GF@a\n");
+		ASSERT_EQ(stats.removed[PEEPHOLE_STACK_BINARY], 3);
+		ASSERT_EQ(stats.removed[PEEPHOLE_STACK_UNARY], 2);
+	}
+
+	TEST_F(PeepholeTest, StackBranch) {
+		ASSERT_TRUE(irEmit(main, IR_PUSHS, variable("a")));
+		ASSERT_TRUE(irEmit(main, IR_PUSHS, irInt(0)));
+		ASSERT_TRUE(irEmit(main, IR_JUMPIFNEQS, label("$if")));
+		ASSERT_TRUE(irEmit(main, IR_LABEL, label("$if")));
+		ASSERT_EQ(optimize(), ".IFJcode19\nLABEL $$main\nJUMPIFNEQ $if GF@a int@0\nLABEL $if\n");
+		ASSERT_EQ(stats.removed[PEEPHOLE_STACK_BRANCH], 2);
+	}
+
+	TEST_F(PeepholeTest, ConstantBranch) {
+		ASSERT_TRUE(irEmit(main, IR_JUMPIFEQ, label("$a"), irInt(1), irInt(1)));
+		ASSERT_TRUE(irEmit(main, IR_LABEL, label("$b")));
+		ASSERT_TRUE(irEmit(main, IR_JUMPIFEQ, label("$b"), irNil(), irString(strViewString("x"))));
+		ASSERT_TRUE(irEmit(main, IR_JUMPIFNEQ, label("$b"), irFloat(0.0), irFloat(-0.0)));
+		ASSERT_TRUE(irEmit(main, IR_JUMPIFEQ, label("$b"), irInt(1), irFloat(1.0)));
+		ASSERT_TRUE(irEmit(main, IR_LABEL, label("$a")));
+		ASSERT_EQ(optimize(), ".IFJcode19\nLABEL $$main\nJUMP $a\nLABEL $b\n"
+							  "JUMPIFEQ $b int@1 float@0x1p+0\nLABEL $a\n");
+		ASSERT_EQ(stats.removed[PEEPHOLE_CONSTANT_BRANCH], 2);
+	}
+
+	TEST_F(PeepholeTest, Jumps) {
+		ASSERT_TRUE(irEmit(main, IR_JUMP, label("$fi")));
+		ASSERT_TRUE(irEmit(main, IR_JUMP, label("$fi")));
+		ASSERT_TRUE(irEmit(main, IR_WRITE, irInt(1)));
+		ASSERT_TRUE(irEmit(main, IR_LABEL, label("$fi")));
+		ASSERT_TRUE(irEmit(main, IR_EXIT, irInt(0)));
+		ASSERT_TRUE(irEmit(main, IR_EXIT, irInt(1)));
+		ASSERT_EQ(optimize(), ".IFJcode19\nLABEL $$main\nLABEL $fi\nEXIT int@0\n");
+		ASSERT_EQ(stats.removed[PEEPHOLE_UNREACHABLE], 3);
+		ASSERT_EQ(stats.removed[PEEPHOLE_JUMP_NEXT], 1);
+	}
+
+	TEST_F(PeepholeTest, DeadMove) {
+		ASSERT_TRUE(irEmit(main, IR_MOVE, variable("a"), irNil()));
+		ASSERT_TRUE(irEmit(main, IR_MOVE, variable("a"), variable("b")));
+		ASSERT_TRUE(irEmit(main, IR_MOVE, variable("b"), variable("c")));
+		ASSERT_TRUE(irEmit(main, IR_MOVE, variable("b"), variable("a")));
+		ASSERT_EQ(optimize(), ".IFJcode19\nLABEL $$main\nMOVE GF@a GF@b\nMOVE GF@b GF@c\nMOVE GF@b GF@a\n");
+		ASSERT_EQ(stats.removed[PEEPHOLE_DEAD_MOVE], 1);
+	}
+
+	TEST_F(PeepholeTest, PreformattedCode) {
+		ASSERT_NE(irProgramAddCode(program, strViewString("len"), strViewString("LABEL len\nRETURN\nRETURN\n")),
+				  nullptr);
+		ASSERT_EQ(optimize(), ".IFJcode19\nJUMP $$main\nLABEL len\nRETURN\nRETURN\nLABEL $$main\n");
+	}
+
+}
@@ -47,6 +47,18 @@ extern "C" {
 		ASSERT_EQ(token.type, tokenType);\
 		EXPECT_STREQ(token.data.strval->string, value);\
 		dynStrFree(token.data.strval);\
+		dynStrFree(token.operand);\
+	} while (false)
+
+#define ASSERT_TOKEN_STRING_OPERAND(file, tokenType, value, operandValue) \
+	do {\
+		token_t token = scan(file, stack);\
+		ASSERT_EQ(token.type, tokenType);\
+		EXPECT_STREQ(token.data.strval->string, value);\
+		ASSERT_NE(token.operand, nullptr);\
+		EXPECT_STREQ(token.operand->string, operandValue);\
+		dynStrFree(token.data.strval);\
+		dynStrFree(token.operand);\
 	} while (false)
 
 #define ASSERT_TOKEN(file, tokenType) \
@@ -128,7 +140,7 @@ namespace Tests {
 		ASSERT_TOKEN(file, T_INDENT);
 		ASSERT_TOKEN_STRING(file, T_ID, "print");
 		ASSERT_TOKEN(file, T_LPAR);
-		ASSERT_TOKEN_STRING(file, T_STRING, "OK");
+		ASSERT_TOKEN_STRING_OPERAND(file, T_STRING, "OK", "string@OK");
 		ASSERT_TOKEN(file, T_RPAR);
 		ASSERT_TOKEN(file, T_EOL);
 
@@ -587,7 +599,7 @@ namespace Tests {
 		ASSERT_NE(file, nullptr);
 		ASSERT_TOKEN_STRING(file, T_ID, "a");
 		ASSERT_TOKEN(file, T_ASSIGN);
-		ASSERT_TOKEN_STRING(file, T_STRING, "\'\r\n\t12Nn\\\"\\Z");
+		ASSERT_TOKEN_STRING_OPERAND(file, T_STRING, "\'\r\n\t12Nn\\\"\\Z", "string@\'\\013\\010\\00912Nn\\092\"\\092Z");
 		ASSERT_TOKEN(file, T_EOL);
 		ASSERT_TOKEN_STRING(file, T_ID, "print");
 		ASSERT_TOKEN(file, T_LPAR);
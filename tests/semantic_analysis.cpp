@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cstring>
+#include "parse_tree_test.h"
+
+namespace Tests {
+
+	/**
+	 * Value of an unfolded expression computed by the test
+	 */
+	struct Value {
+		enum token_type type;
+		long intval;
+		double floatval;
+		std::string string;
+	};
+
+	class SemanticFoldTest : public ParseTreeTest {
+	protected:
+		int fold() {
+			int errCode = ERROR_SUCCESS;
+			semanticFold(&tree, &errCode);
+			return errCode;
+		}
+
+		// right side of the last assignment
+		treeElement_t &expression() {
+			treeElement_t &block = tree.data.elements[tree.nodeSize - 1];
+			treeElement_t &assign = block.data.elements[block.nodeSize - 1];
+			treeElement_t *element = &assign.data.elements[1];
+			while (element->type == E_S_EXPRESSION && element->nodeSize == 1) {
+				element = &element->data.elements[0];
+			}
+			return *element;
+		}
+
+		static double number(const Value &value) {
+			return value.type == T_FLOAT ? value.floatval : (double) value.intval;
+		}
+
+		static Value boolean(bool value) {
+			return {value ? T_BOOL_TRUE : T_BOOL_FALSE, value ? 1 : 0, 0.0, ""};
+		}
+
+		// reference evaluation of the unfolded expression
+		static Value evaluate(const treeElement_t &element) {
+			if (element.type == E_S_EXPRESSION) {
+				return evaluate(element.data.elements[0]);
+			}
+			if (element.type == E_TOKEN) {
+				token_t *token = element.data.token;
+				switch (token->type) {
+					case T_BOOL_TRUE:
+						return {T_NUMBER, 1, 0.0, ""};
+					case T_BOOL_FALSE:
+						return {T_NUMBER, 0, 0.0, ""};
+					case T_STRING:
+						return {T_STRING, 0, 0.0, token->data.strval->string};
+					default:
+						return {token->type, token->data.intval, token->data.floatval, ""};
+				}
+			}
+			if (element.type == E_NOT) {
+				return boolean(evaluate(element.data.elements[0]).intval == 0);
+			}
+			Value left = evaluate(element.data.elements[0]);
+			Value right = evaluate(element.data.elements[1]);
+			bool isFloat = left.type == T_FLOAT || right.type == T_FLOAT;
+			switch (element.type) {
+				case E_ADD:
+					if (left.type == T_STRING) {
+						return {T_STRING, 0, 0.0, left.string + right.string};
+					}
+					if (isFloat) {
+						return {T_FLOAT, 0, number(left) + number(right), ""};
+					}
+					return {T_NUMBER, left.intval + right.intval, 0.0, ""};
+				case E_SUB:
+					if (isFloat) {
+						return {T_FLOAT, 0, number(left) - number(right), ""};
+					}
+					return {T_NUMBER, left.intval - right.intval, 0.0, ""};
+				case E_MUL:
+					if (isFloat) {
+						return {T_FLOAT, 0, number(left) * number(right), ""};
+					}
+					return {T_NUMBER, left.intval * right.intval, 0.0, ""};
+				case E_DIV:
+					return {T_FLOAT, 0, number(left) / number(right), ""};
+				case E_DIV_INT: {
+					long quotient = left.intval / right.intval;
+					if (left.intval % right.intval != 0 && (left.intval < 0) != (right.intval < 0)) {
+						--quotient;
+					}
+					return {T_NUMBER, quotient, 0.0, ""};
+				}
+				case E_LT:
+					return boolean(left.type == T_STRING ? left.string < right.string : number(left) < number(right));
+				case E_GT:
+					return boolean(left.type == T_STRING ? left.string > right.string : number(left) > number(right));
+				case E_LTE:
+					return boolean(left.type == T_STRING ? left.string <= right.string : number(left) <= number(right));
+				case E_GTE:
+					return boolean(left.type == T_STRING ? left.string >= right.string : number(left) >= number(right));
+				case E_EQ:
+				case E_NEQ: {
+					bool equal;
+					if (left.type == T_KW_NONE || right.type == T_KW_NONE) {
+						equal = left.type == right.type;
+					} else if (left.type == T_STRING) {
+						equal = left.string == right.string;
+					} else {
+						equal = number(left) == number(right);
+					}
+					return boolean(equal == (element.type == E_EQ));
+				}
+				case E_AND:
+					return boolean(left.intval != 0 && right.intval != 0);
+				case E_OR:
+					return boolean(left.intval != 0 || right.intval != 0);
+				default:
+					ADD_FAILURE() << "unexpected element " << element.type;
+					return {T_UNKNOWN, 0, 0.0, ""};
+			}
+		}
+
+		void assertFolded(const std::string &source) {
+			SCOPED_TRACE(source);
+			ASSERT_EQ(parse(source), ERROR_SUCCESS);
+			ASSERT_NE(expression().type, E_TOKEN);
+			Value expected = evaluate(expression());
+			ASSERT_EQ(fold(), ERROR_SUCCESS);
+			ASSERT_EQ(expression().type, E_TOKEN);
+			token_t *token = expression().data.token;
+			switch (expected.type) {
+				case T_NUMBER:
+					ASSERT_EQ(token->type, T_NUMBER);
+					EXPECT_EQ(token->data.intval, expected.intval);
+					break;
+				case T_FLOAT:
+					ASSERT_EQ(token->type, T_FLOAT);
+					EXPECT_EQ(token->data.floatval, expected.floatval);
+					break;
+				case T_STRING:
+					ASSERT_EQ(token->type, T_STRING);
+					EXPECT_EQ(std::string(token->data.strval->string, token->data.strval->size), expected.string);
+					break;
+				default:
+					EXPECT_EQ(token->type, expected.type);
+					break;
+			}
+		}
+	};
+
+	TEST_F(SemanticFoldTest, Arithmetic) {
+		assertFolded("a = 2 + 3 * 4\n");
+		assertFolded("a = (3 + 5) / 4 - (1 * 1)\n");
+		assertFolded("a = (3.0 + True) * (6 / 3.0)\n");
+		assertFolded("a = False + 3.5\n");
+		assertFolded("a = 1 - 8 // 3\n");
+		assertFolded("a = (1 - 8) // 3\n");
+		assertFolded("a = (1 - 8) // (0 - 3)\n");
+		assertFolded("a = 10 - 0.25 * 2\n");
+	}
+
+	TEST_F(SemanticFoldTest, IntegerDivisionRoundsDown) {
+		ASSERT_EQ(parse("a = (1 - 8) // 3\n"), ERROR_SUCCESS);
+		ASSERT_EQ(fold(), ERROR_SUCCESS);
+		ASSERT_EQ(expression().type, E_TOKEN);
+		ASSERT_EQ(expression().data.token->data.intval, -3);
+	}
+
+	TEST_F(SemanticFoldTest, Comparisons) {
+		assertFolded("a = 1 < 2\n");
+		assertFolded("a = 2.5 >= 3\n");
+		assertFolded("a = 2 <= 2\n");
+		assertFolded("a = 3 > 2 * 2\n");
+		assertFolded("a = 'abc' < 'abd'\n");
+		assertFolded("a = 'a' != 'b'\n");
+		assertFolded("a = None == None\n");
+		assertFolded("a = 1 == None\n");
+		assertFolded("a = 1 == 1.0\n");
+	}
+
+	TEST_F(SemanticFoldTest, Booleans) {
+		assertFolded("a = True and False\n");
+		assertFolded("a = True or False\n");
+		assertFolded("a = not (1 < 2)\n");
+	}
+
+	TEST_F(SemanticFoldTest, Concatenation) {
+		assertFolded("a = 'ab' + 'c d\\n'\n");
+		ASSERT_NE(expression().data.token->operand, nullptr);
+		EXPECT_STREQ(expression().data.token->operand->string, "string@abc\\032d\\010");
+	}
+
+	TEST_F(SemanticFoldTest, DivisionByZero) {
+		// divisor only folds to zero, division is left for run time
+		ASSERT_EQ(parse("a = 1 / (2 - 2)\n"), ERROR_SUCCESS);
+		ASSERT_EQ(fold(), ERROR_SUCCESS);
+		ASSERT_EQ(expression().type, E_DIV);
+		ASSERT_EQ(expression().data.elements[1].type, E_TOKEN);
+		ASSERT_EQ(expression().data.elements[1].data.token->data.intval, 0);
+	}
+
+	TEST_F(SemanticFoldTest, IntegerDivisionByZero) {
+		ASSERT_EQ(parse("b = 1\na = b // (3 - 3)\n"), ERROR_SUCCESS);
+		ASSERT_EQ(fold(), ERROR_SUCCESS);
+		ASSERT_EQ(expression().type, E_DIV_INT);
+	}
+
+	TEST_F(SemanticFoldTest, LiteralDivisionByZero) {
+		ASSERT_EQ(parse("a = 42.0 / 0\n"), ERROR_ZERO_DIVISION);
+		ASSERT_EQ(parse("a = 42 // 0\n"), ERROR_ZERO_DIVISION);
+	}
+
+	TEST_F(SemanticFoldTest, VariablesNotFolded) {
+		ASSERT_EQ(parse("b = 1\na = b + 2 * 3\n"), ERROR_SUCCESS);
+		ASSERT_EQ(fold(), ERROR_SUCCESS);
+		ASSERT_EQ(expression().type, E_ADD);
+		ASSERT_EQ(expression().data.elements[1].type, E_TOKEN);
+		ASSERT_EQ(expression().data.elements[1].data.token->data.intval, 6);
+	}
+
+	TEST_F(SemanticFoldTest, OverflowNotFolded) {
+		ASSERT_EQ(parse("a = 9223372036854775807 + 1\n"), ERROR_SUCCESS);
+		ASSERT_EQ(fold(), ERROR_SUCCESS);
+		ASSERT_EQ(expression().type, E_ADD);
+	}
+
+	TEST_F(SemanticFoldTest, MarkReachable) {
+		ASSERT_EQ(parse("def f(x):\n    return g(x)\ndef g(y):\n    return y\ndef h():\n    return f(1)\n"
+		                "def r(n):\n    return r(n)\na = f(2)\n"), ERROR_SUCCESS);
+		semanticMarkReachable(&tree, table);
+		ASSERT_TRUE(symTableFind(table, strViewString("f"), strViewNull())->used);
+		// called only from the reachable function
+		ASSERT_TRUE(symTableFind(table, strViewString("g"), strViewNull())->used);
+		// called only from the unreachable functions, recursion included
+		ASSERT_FALSE(symTableFind(table, strViewString("h"), strViewNull())->used);
+		ASSERT_FALSE(symTableFind(table, strViewString("r"), strViewNull())->used);
+	}
+
+}
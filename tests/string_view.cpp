@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "dynamic_string.h"
+#include "string_view.h"
+}
+
+namespace Tests {
+
+	TEST(StringViewTest, Init) {
+		const char *string = "abcdef";
+		strView_t view = strViewInit(string, 3);
+		ASSERT_EQ(view.string, string);
+		ASSERT_EQ(view.length, 3);
+		ASSERT_FALSE(view.hashed);
+		ASSERT_FALSE(strViewIsNull(view));
+	}
+
+	TEST(StringViewTest, Null) {
+		ASSERT_TRUE(strViewIsNull(strViewNull()));
+		ASSERT_TRUE(strViewIsNull(strViewString(nullptr)));
+		ASSERT_TRUE(strViewIsNull(strViewDynStr(nullptr)));
+		ASSERT_EQ(strViewInit(nullptr, 5).length, 0);
+		ASSERT_FALSE(strViewIsNull(strViewString("")));
+	}
+
+	TEST(StringViewTest, DynStr) {
+		dynStr_t *string = dynStrInitString("main");
+		strView_t view = strViewDynStr(string);
+		ASSERT_EQ(view.string, string->string);
+		ASSERT_EQ(view.length, 4);
+		dynStrFree(string);
+	}
+
+	TEST(StringViewTest, Equal) {
+		ASSERT_TRUE(strViewEqual(strViewString("abc"), strViewInit("abcdef", 3)));
+		ASSERT_FALSE(strViewEqual(strViewString("abc"), strViewString("abd")));
+		ASSERT_FALSE(strViewEqual(strViewString("abc"), strViewString("abcd")));
+		ASSERT_TRUE(strViewEqual(strViewString(""), strViewString("")));
+	}
+
+	TEST(StringViewTest, EqualNull) {
+		ASSERT_TRUE(strViewEqual(strViewNull(), strViewNull()));
+		ASSERT_FALSE(strViewEqual(strViewNull(), strViewString("")));
+		ASSERT_FALSE(strViewEqual(strViewString(""), strViewNull()));
+	}
+
+	TEST(StringViewTest, EqualHashed) {
+		strView_t view1 = strViewString("abc");
+		strView_t view2 = strViewString("abd");
+		strViewHash(&view1);
+		strViewHash(&view2);
+		ASSERT_FALSE(strViewEqual(view1, view2));
+		view2 = strViewString("abc");
+		strViewHash(&view2);
+		ASSERT_TRUE(strViewEqual(view1, view2));
+	}
+
+	TEST(StringViewTest, EqualString) {
+		strView_t view = strViewInit("abcdef", 3);
+		ASSERT_TRUE(strViewEqualString(view, "abc"));
+		ASSERT_FALSE(strViewEqualString(view, "ab"));
+		ASSERT_FALSE(strViewEqualString(view, "abcd"));
+		ASSERT_FALSE(strViewEqualString(view, nullptr));
+		ASSERT_FALSE(strViewEqualString(strViewNull(), "abc"));
+	}
+
+	TEST(StringViewTest, Hash) {
+		strView_t view = strViewString("main");
+		ASSERT_EQ(strViewHash(&view), 0x737fe);
+		ASSERT_TRUE(view.hashed);
+		ASSERT_EQ(view.hash, 0x737fe);
+		ASSERT_EQ(strViewHash(nullptr), 0);
+	}
+
+	TEST(StringViewTest, AppendTo) {
+		dynStr_t *string = dynStrInitString("LF@");
+		ASSERT_TRUE(strViewAppendTo(string, strViewInit("abcdef", 3)));
+		ASSERT_STREQ(dynStrGetString(string), "LF@abc");
+		ASSERT_FALSE(strViewAppendTo(string, strViewNull()));
+		dynStrFree(string);
+	}
+}
@@ -34,29 +34,21 @@ namespace Tests {
 			symTableFree(table);
 		}
 
-		dynStr_t *createDynStr(const std::string &str) {
-			dynStr_t *string = dynStrInit();
-			dynStrAppendString(string, str.c_str());
-			return string;
-		}
-
-		symbol_t *createFunction(const std::string &name, int argc, bool defined, bool insert = false, dynStrList_t *argv = nullptr) {
+		symbol_t *createFunction(const char *name, int argc, bool defined, bool insert = false, dynStrList_t *argv = nullptr) {
 			if (argv == nullptr) {
 				argv = dynStrListInit();
 			}
 			symbolInfo_t info = {.function = {.argc = argc, .argv = argv, .defined = defined}};
-			symbol_t *symbol = symbolInit(createDynStr(name), SYMBOL_FUNCTION, info, nullptr);
+			symbol_t *symbol = symbolInit(strViewString(name), SYMBOL_FUNCTION, info, strViewNull());
 			if (insert) {
 				symTableInsert(table, symbol, defined);
 			}
 			return symbol;
 		}
 
-		symbol_t *createVariable(const std::string &name, const std::string &context, bool insert = false) {
+		symbol_t *createVariable(const char *name, const char *context, bool insert = false) {
 			symbolInfo_t info = {.variable = {.assigned = true}};
-			dynStr_t *sName = createDynStr(name);
-			dynStr_t *sContext = createDynStr(context);
-			symbol_t *symbol = symbolInit(sName, SYMBOL_VARIABLE, info, sContext);
+			symbol_t *symbol = symbolInit(strViewString(name), SYMBOL_VARIABLE, info, strViewString(context));
 			if (insert) {
 				symTableInsert(table, symbol, false);
 			}
@@ -67,9 +59,10 @@ namespace Tests {
 	};
 
 	TEST_F(SymTableTest, hash) {
-		dynStr_t *name = createDynStr("main");
-		ASSERT_EQ(symTableHash(name), 0x737fe % TABLE_SIZE);
-		dynStrFree(name);
+		strView_t name = strViewString("main");
+		ASSERT_EQ(symTableHash(&name), 0x737fe % TABLE_SIZE);
+		ASSERT_TRUE(name.hashed);
+		ASSERT_EQ(symTableHash(&name), 0x737fe % TABLE_SIZE);
 	}
 
 	TEST_F(SymTableTest, init) {
@@ -105,7 +98,7 @@ namespace Tests {
 		ASSERT_EQ(iterator.table, table);
 		ASSERT_EQ(iterator.index, 0x737fe % TABLE_SIZE);
 		ASSERT_NE(iterator.symbol, nullptr);
-		ASSERT_STREQ(iterator.symbol->name->string, "main");
+		ASSERT_TRUE(strViewEqualString(iterator.symbol->name, "main"));
 		ASSERT_EQ(iterator.symbol->next, nullptr);
 		ASSERT_EQ(iterator.symbol->type, SYMBOL_FUNCTION);
 	}
@@ -127,27 +120,25 @@ namespace Tests {
 	}
 
 	TEST_F(SymTableTest, insertFunctionDefinitionNullName) {
-		ASSERT_EQ(symTableInsertFunctionDefinition(table, nullptr, 0, nullptr), ERROR_INTERNAL);
+		ASSERT_EQ(symTableInsertFunctionDefinition(table, strViewNull(), 0, nullptr), ERROR_INTERNAL);
 	}
 
 	TEST_F(SymTableTest, insertFunctionNullName) {
-		ASSERT_EQ(symTableInsertFunction(table, nullptr, 0), ERROR_INTERNAL);
+		ASSERT_EQ(symTableInsertFunction(table, strViewNull(), 0), ERROR_INTERNAL);
 	}
 
 	TEST_F(SymTableTest, insertFunctionDefinitionNullTable) {
-		dynStr_t *name = createDynStr("main");
+		strView_t name = strViewString("main");
 		ASSERT_EQ(symTableInsertFunctionDefinition(nullptr, name, 0, nullptr), ERROR_INTERNAL);
-		dynStrFree(name);
 	}
 
 	TEST_F(SymTableTest, insertFunctionNullTable) {
-		dynStr_t *name = createDynStr("main");
+		strView_t name = strViewString("main");
 		ASSERT_EQ(symTableInsertFunction(nullptr, name, 0), ERROR_INTERNAL);
-		dynStrFree(name);
 	}
 
 	TEST_F(SymTableTest, insertFunction) {
-		dynStr_t *name = createDynStr("main");
+		strView_t name = strViewString("main");
 		ASSERT_EQ(symTableInsertFunctionDefinition(table, name, 0, dynStrListInit()), ERROR_SUCCESS);
 		ASSERT_EQ(symTableSize(table), 1);
 		symIterator_t iterator = symIteratorBegin(table);
@@ -156,8 +147,8 @@ namespace Tests {
 		ASSERT_EQ(iterator.table, table);
 		ASSERT_EQ(iterator.index, 0x737fe % TABLE_SIZE);
 		ASSERT_NE(iterator.symbol, nullptr);
-		ASSERT_STREQ(iterator.symbol->name->string, name->string);
-		ASSERT_STREQ(iterator.symbol->name->string, "main");
+		ASSERT_TRUE(strViewEqual(iterator.symbol->name, name));
+		ASSERT_TRUE(strViewEqualString(iterator.symbol->name, "main"));
 		ASSERT_EQ(iterator.symbol->next, nullptr);
 		ASSERT_EQ(iterator.symbol->type, SYMBOL_FUNCTION);
 		ASSERT_EQ(iterator.symbol->info.function.argc, 0);
@@ -165,32 +156,29 @@ namespace Tests {
 		ASSERT_EQ(symTableInsertFunction(table, name, 0), ERROR_SUCCESS);
 		ASSERT_EQ(symTableInsertFunctionDefinition(table, name, 0, dynStrListInit()), ERROR_SEMANTIC_FUNCTION);
 		ASSERT_EQ(symTableInsertFunction(table, name, 1), ERROR_SEMANTIC_ARGC);
-		ASSERT_EQ(symTableInsertVariable(table, name, nullptr, false), ERROR_SEMANTIC_FUNCTION);
-		dynStrFree(name);
+		ASSERT_EQ(symTableInsertVariable(table, name, strViewNull(), false), ERROR_SEMANTIC_FUNCTION);
 	}
 
 	TEST_F(SymTableTest, insertFunctionDynamicArgc) {
-		dynStr_t *name = createDynStr("main");
+		strView_t name = strViewString("main");
 		ASSERT_EQ(symTableInsertFunctionDefinition(table, name, -1, dynStrListInit()), ERROR_SUCCESS);
 		ASSERT_EQ(symTableSize(table), 1);
 		ASSERT_EQ(symTableInsertFunction(table, name, 2), ERROR_SUCCESS);
 		ASSERT_EQ(symTableSize(table), 1);
-		dynStrFree(name);
 	}
 
 	TEST_F(SymTableTest, insertVariableNullName) {
-		ASSERT_EQ(symTableInsertVariable(table, nullptr, nullptr, false), ERROR_INTERNAL);
+		ASSERT_EQ(symTableInsertVariable(table, strViewNull(), strViewNull(), false), ERROR_INTERNAL);
 	}
 
 	TEST_F(SymTableTest, insertVariableNullTable) {
-		dynStr_t *name = createDynStr("i");
-		ASSERT_EQ(symTableInsertVariable(nullptr, name, nullptr, false), ERROR_INTERNAL);
-		dynStrFree(name);
+		strView_t name = strViewString("i");
+		ASSERT_EQ(symTableInsertVariable(nullptr, name, strViewNull(), false), ERROR_INTERNAL);
 	}
 
 	TEST_F(SymTableTest, insertVariable) {
-		dynStr_t *name = createDynStr("i");
-		ASSERT_EQ(symTableInsertVariable(table, name, nullptr, false), ERROR_SUCCESS);
+		strView_t name = strViewString("i");
+		ASSERT_EQ(symTableInsertVariable(table, name, strViewNull(), false), ERROR_SUCCESS);
 		ASSERT_EQ(symTableSize(table), 1);
 		symIterator_t iterator = symIteratorBegin(table);
 		iterator = symIteratorNext(iterator);
@@ -198,155 +186,172 @@ namespace Tests {
 		ASSERT_EQ(iterator.table, table);
 		ASSERT_EQ(iterator.index, 105);
 		ASSERT_NE(iterator.symbol, nullptr);
-		ASSERT_STREQ(iterator.symbol->name->string, "i");
+		ASSERT_TRUE(strViewEqualString(iterator.symbol->name, "i"));
 		ASSERT_EQ(iterator.symbol->next, nullptr);
 		ASSERT_EQ(iterator.symbol->type, SYMBOL_VARIABLE);
 		ASSERT_FALSE(iterator.symbol->info.variable.assigned);
-		ASSERT_EQ(symTableInsertVariable(table, name, nullptr, false), ERROR_SUCCESS);
+		ASSERT_EQ(symTableInsertVariable(table, name, strViewNull(), false), ERROR_SUCCESS);
 		ASSERT_EQ(symTableInsertFunction(table, name, 0), ERROR_SEMANTIC_FUNCTION);
-		dynStrFree(name);
 	}
 
 	TEST_F(SymTableTest, findNullName) {
-		ASSERT_EQ(symTableFind(table, nullptr, nullptr), nullptr);
+		ASSERT_EQ(symTableFind(table, strViewNull(), strViewNull()), nullptr);
 	}
 
 	TEST_F(SymTableTest, findNullTable) {
-		dynStr_t *name = createDynStr("main");
-		ASSERT_EQ(symTableFind(nullptr, nullptr, name), nullptr);
-		dynStrFree(name);
+		strView_t name = strViewString("main");
+		ASSERT_EQ(symTableFind(nullptr, strViewNull(), name), nullptr);
 	}
 
 	TEST_F(SymTableTest, find) {
 		createFunction("main", 0, true, true);
-		dynStr_t *name = createDynStr("main");
-		symbol_t *symbol = symTableFind(table, name, nullptr);
+		strView_t name = strViewString("main");
+		symbol_t *symbol = symTableFind(table, name, strViewNull());
 		ASSERT_NE(symbol, nullptr);
-		ASSERT_STREQ(symbol->name->string, "main");
+		ASSERT_TRUE(strViewEqualString(symbol->name, "main"));
 		ASSERT_EQ(symbol->next, nullptr);
 		ASSERT_EQ(symbol->type, SYMBOL_FUNCTION);
 		symbol = symTableFind(table, name, name);
 		ASSERT_EQ(symbol, nullptr);
-		dynStrFree(name);
 	}
 
 	TEST_F(SymTableTest, removeNullName) {
 		createFunction("main", 0, true, true);
 		ASSERT_EQ(symTableSize(table), 1);
-		symTableRemove(table, nullptr, nullptr);
+		symTableRemove(table, strViewNull(), strViewNull());
 		ASSERT_EQ(symTableSize(table), 1);
 	}
 
 	TEST_F(SymTableTest, removeNullTable) {
-		dynStr_t *name = createDynStr("i");
-		symTableRemove(nullptr, nullptr, name);
-		dynStrFree(name);
+		strView_t name = strViewString("i");
+		symTableRemove(nullptr, strViewNull(), name);
 	}
 
 	TEST_F(SymTableTest, removeNullContext) {
-		dynStr_t *name = createDynStr("main");
+		strView_t name = strViewString("main");
 		createFunction("main", 0, true, true);
 		ASSERT_EQ(symTableSize(table), 1);
-		symTableRemove(table, name, nullptr);
+		symTableRemove(table, name, strViewNull());
 		ASSERT_EQ(symTableSize(table), 0);
-		dynStrFree(name);
 	}
 
 	TEST_F(SymTableTest, getArgumentName) {
 		dynStrList_t *args = dynStrListInit();
-		ASSERT_TRUE(dynStrListPushBack(args, createDynStr("a")));
-		ASSERT_TRUE(dynStrListPushBack(args, createDynStr("b")));
+		ASSERT_TRUE(dynStrListPushBackView(args, strViewString("a")));
+		ASSERT_TRUE(dynStrListPushBackView(args, strViewString("b")));
 		createFunction("f", 2, true, true, args);
-		dynStr_t *function = createDynStr("f");
-		dynStr_t *argument = symTableGetArgumentName(table, function, 0);
-		ASSERT_NE(argument, nullptr);
-		ASSERT_STREQ(dynStrGetString(argument), "a");
+		strView_t function = strViewString("f");
+		strView_t argument = symTableGetArgumentName(table, function, 0);
+		ASSERT_TRUE(strViewEqualString(argument, "a"));
 		argument = symTableGetArgumentName(table, function, 1);
-		ASSERT_NE(argument, nullptr);
-		ASSERT_STREQ(dynStrGetString(argument), "b");
+		ASSERT_TRUE(strViewEqualString(argument, "b"));
 		argument = symTableGetArgumentName(table, function, 2);
-		ASSERT_EQ(argument, nullptr);
-		dynStrFree(function);
+		ASSERT_TRUE(strViewIsNull(argument));
+	}
+
+	TEST_F(SymTableTest, getArgumentNameDefinedAfterCall) {
+		ASSERT_EQ(symTableInsertFunction(table, strViewString("f"), 1), ERROR_SUCCESS);
+		dynStrList_t *args = dynStrListInit();
+		ASSERT_TRUE(dynStrListPushBackView(args, strViewString("a")));
+		ASSERT_EQ(symTableInsertFunctionDefinition(table, strViewString("f"), 1, args), ERROR_SUCCESS);
+		strView_t function = strViewString("f");
+		ASSERT_TRUE(symTableFind(table, function, strViewNull())->info.function.defined);
+		ASSERT_TRUE(strViewEqualString(symTableGetArgumentName(table, function, 0), "a"));
+	}
+
+	TEST_F(SymTableTest, clearFunctionUsage) {
+		symTableClearFunctionUsage(nullptr);
+		createFunction("f", 0, true, true);
+		createFunction("f", 0, false, true);
+		createVariable("a", "f", true);
+		createVariable("a", "f", true);
+		strView_t function = strViewString("f");
+		ASSERT_TRUE(symTableFind(table, function, strViewNull())->used);
+		symTableClearFunctionUsage(table);
+		ASSERT_FALSE(symTableFind(table, function, strViewNull())->used);
+		ASSERT_TRUE(symTableFind(table, strViewString("a"), function)->used);
 	}
 
 	TEST_F(SymTableTest, isVariableAssignedNull) {
-		ASSERT_FALSE(symTableIsVariableAssigned(nullptr, nullptr, nullptr));
-		ASSERT_FALSE(symTableIsVariableAssigned(table, nullptr, nullptr));
-		dynStr_t *name = createDynStr("a");
-		ASSERT_FALSE(symTableIsVariableAssigned(nullptr, name, nullptr));
-		dynStrFree(name);
+		ASSERT_FALSE(symTableIsVariableAssigned(nullptr, strViewNull(), strViewNull()));
+		ASSERT_FALSE(symTableIsVariableAssigned(table, strViewNull(), strViewNull()));
+		strView_t name = strViewString("a");
+		ASSERT_FALSE(symTableIsVariableAssigned(nullptr, name, strViewNull()));
 	}
 
 	TEST_F(SymTableTest, isVariableAssigned0) {
 		createFunction("main", 0, true, true);
-		dynStr_t *function = createDynStr("main");
-		dynStr_t *varName = createDynStr("a");
+		strView_t function = strViewString("main");
+		strView_t varName = strViewString("a");
 		symTableInsertVariable(table, varName, function, false);
 		ASSERT_FALSE(symTableIsVariableAssigned(table, varName, function));
-		dynStrFree(function);
-		dynStrFree(varName);
 	}
 
 	TEST_F(SymTableTest, isVariableAssigned1) {
 		createFunction("main", 0, true, true);
-		dynStr_t *function = createDynStr("main");
-		dynStr_t *varName = createDynStr("a");
-		symTableInsertVariable(table, varName, nullptr, false);
+		strView_t function = strViewString("main");
+		strView_t varName = strViewString("a");
+		symTableInsertVariable(table, varName, strViewNull(), false);
 		symTableInsertVariable(table, varName, function, false);
 		ASSERT_FALSE(symTableIsVariableAssigned(table, varName, function));
-		dynStrFree(function);
-		dynStrFree(varName);
 	}
 
 	TEST_F(SymTableTest, isVariableAssigned2) {
 		createFunction("main", 0, true, true);
-		dynStr_t *function = createDynStr("main");
-		dynStr_t *varName = createDynStr("a");
-		symTableInsertVariable(table, varName, nullptr, true);
+		strView_t function = strViewString("main");
+		strView_t varName = strViewString("a");
+		symTableInsertVariable(table, varName, strViewNull(), true);
 		symTableInsertVariable(table, varName, function, false);
 		ASSERT_FALSE(symTableIsVariableAssigned(table, varName, function));
-		dynStrFree(function);
-		dynStrFree(varName);
 	}
 
 	TEST_F(SymTableTest, isVariableAssigned3) {
 		createFunction("main", 0, true, true);
-		dynStr_t *function = createDynStr("main");
-		dynStr_t *varName = createDynStr("a");
-		symTableInsertVariable(table, varName, nullptr, true);
+		strView_t function = strViewString("main");
+		strView_t varName = strViewString("a");
+		symTableInsertVariable(table, varName, strViewNull(), true);
 		ASSERT_TRUE(symTableIsVariableAssigned(table, varName, function));
-		dynStrFree(function);
-		dynStrFree(varName);
 	}
 
 	TEST_F(SymTableTest, isVariableAssigned4) {
 		createFunction("main", 0, true, true);
-		dynStr_t *function = createDynStr("main");
-		dynStr_t *varName = createDynStr("a");
+		strView_t function = strViewString("main");
+		strView_t varName = strViewString("a");
 		symTableInsertVariable(table, varName, function, true);
 		ASSERT_TRUE(symTableIsVariableAssigned(table, varName, function));
-		dynStrFree(function);
-		dynStrFree(varName);
 	}
 
 	TEST_F(SymTableTest, getFrameNull) {
-		dynStr_t *name = createDynStr("main");
-		ASSERT_EQ(symTableGetFrame(nullptr, nullptr, nullptr), FRAME_ERROR);
-		ASSERT_EQ(symTableGetFrame(nullptr, nullptr, name), FRAME_ERROR);
-		ASSERT_EQ(symTableGetFrame(table, nullptr, nullptr), FRAME_ERROR);
-		dynStrFree(name);
+		strView_t name = strViewString("main");
+		ASSERT_EQ(symTableGetFrame(nullptr, strViewNull(), strViewNull()), FRAME_ERROR);
+		ASSERT_EQ(symTableGetFrame(nullptr, strViewNull(), name), FRAME_ERROR);
+		ASSERT_EQ(symTableGetFrame(table, strViewNull(), strViewNull()), FRAME_ERROR);
 	}
 
 	TEST_F(SymTableTest, getFrame) {
 		createFunction("main", 0, true, true);
-		dynStr_t *name = createDynStr("main");
-		dynStr_t *varName = createDynStr("a");
+		strView_t name = strViewString("main");
+		strView_t varName = strViewString("a");
 		symTableInsertVariable(table, varName, name, false);
-		ASSERT_EQ(symTableGetFrame(table, name, nullptr), FRAME_GLOBAL);
+		ASSERT_EQ(symTableGetFrame(table, name, strViewNull()), FRAME_GLOBAL);
 		ASSERT_EQ(symTableGetFrame(table, varName, name), FRAME_LOCAL);
-		ASSERT_EQ(symTableGetFrame(table, varName, nullptr), FRAME_ERROR);
-		dynStrFree(name);
-		dynStrFree(varName);
+		ASSERT_EQ(symTableGetFrame(table, varName, strViewNull()), FRAME_ERROR);
+	}
+
+	TEST_F(SymTableTest, resolve) {
+		createFunction("main", 0, true, true);
+		strView_t name = strViewString("main");
+		strView_t varName = strViewString("a");
+		strView_t globalName = strViewString("b");
+		symTableInsertVariable(table, varName, name, false);
+		symTableInsertVariable(table, varName, strViewNull(), false);
+		symTableInsertVariable(table, globalName, strViewNull(), false);
+		ASSERT_EQ(symTableResolve(table, varName, name), symTableFind(table, varName, name));
+		ASSERT_EQ(symTableResolve(table, varName, strViewNull()), symTableFind(table, varName, strViewNull()));
+		ASSERT_EQ(symTableResolve(table, globalName, name), symTableFind(table, globalName, strViewNull()));
+		ASSERT_EQ(symTableResolve(table, name, name), symTableFind(table, name, strViewNull()));
+		ASSERT_EQ(symTableResolve(table, globalName, globalName), symTableFind(table, globalName, strViewNull()));
+		ASSERT_EQ(symTableResolve(table, name, varName), symTableFind(table, name, strViewNull()));
 	}
 
 	TEST_F(SymTableTest, iteratorBeginNullTable) {
@@ -432,22 +437,48 @@ namespace Tests {
 
 	TEST_F(SymTableTest, symbolInitNull) {
 		symbolInfo_t info = {.function = {.argc = 0, .argv = nullptr,.defined = true}};
-		ASSERT_EQ(symbolInit(nullptr, SYMBOL_FUNCTION, info, nullptr), nullptr);
+		ASSERT_EQ(symbolInit(strViewNull(), SYMBOL_FUNCTION, info, strViewNull()), nullptr);
 	}
 
 	TEST_F(SymTableTest, symbolInit) {
-		dynStr_t *name = createDynStr("main");
+		strView_t name = strViewString("main");
 		symbolInfo_t info = {.function = {.argc = 0, .argv = nullptr, .defined = true}};
-		symbol_t *symbol = symbolInit(name, SYMBOL_FUNCTION, info, nullptr);
+		symbol_t *symbol = symbolInit(name, SYMBOL_FUNCTION, info, strViewNull());
 		ASSERT_NE(symbol, nullptr);
-		ASSERT_EQ(symbol->context, nullptr);
+		ASSERT_TRUE(strViewIsNull(symbol->context));
 		ASSERT_EQ(symbol->info.function.argc, info.function.argc);
 		ASSERT_EQ(symbol->info.function.defined, info.function.defined);
-		ASSERT_EQ(symbol->name, name);
+		ASSERT_EQ(symbol->name.string, name.string);
+		ASSERT_TRUE(symbol->name.hashed);
 		ASSERT_EQ(symbol->next, nullptr);
 		ASSERT_EQ(symbol->type, SYMBOL_FUNCTION);
+		ASSERT_EQ(symbol->operand, nullptr);
 		ASSERT_FALSE(symbol->used);
 		symbolFree(symbol);
 	}
 
+	TEST_F(SymTableTest, symbolInitVariableOperand) {
+		symbol_t *local = createVariable("a", "main");
+		ASSERT_STREQ(dynStrGetString(local->operand), "LF@a");
+		symbolFree(local);
+		symbolInfo_t info = {.variable = {.assigned = false}};
+		symbol_t *global = symbolInit(strViewString("b"), SYMBOL_VARIABLE, info, strViewNull());
+		ASSERT_STREQ(dynStrGetString(global->operand), "GF@b");
+		symbolFree(global);
+	}
+
+	TEST_F(SymTableTest, symbolTakeName) {
+		dynStr_t *name = dynStrInitString("a");
+		dynStr_t *other = dynStrInitString("a");
+		symbolInfo_t info = {.variable = {.assigned = false}};
+		symbol_t *symbol = symbolInit(strViewDynStr(name), SYMBOL_VARIABLE, info, strViewNull());
+		ASSERT_EQ(symbol->ownedName, nullptr);
+		ASSERT_FALSE(symbolTakeName(symbol, other));
+		ASSERT_TRUE(symbolTakeName(symbol, name));
+		ASSERT_EQ(symbol->ownedName, name);
+		ASSERT_FALSE(symbolTakeName(symbol, name));
+		dynStrFree(other);
+		symbolFree(symbol);
+	}
+
 }
@@ -24,13 +24,13 @@ findTests() {
   fi
 }
 
-runTest() {
+runTestWithFlags() {
   CODE="${1}code.ifj19"
   TAC="${1}code.ifjCode19"
   STDIN="${1}stdin"
   STDOUT="${1}stdout"
-  echo "======= Running test ${1} ======="
-  ${COMPILER} "${CODE}" > "${TAC}"
+  echo "======= Running test ${1} ${2} ======="
+  ${COMPILER} ${2} "${CODE}" > "${TAC}"
   COMPILER_RETVAL=$?
   echo "${COMPILER_RETVAL}" | diff "${1}compiler.retVal" - > /dev/null 2>&1
   DIFF_RETVAL=$?
@@ -53,6 +53,17 @@ runTest() {
   echo
 }
 
+# compiler.flags lists one set of compiler flags per line, the test is run with each of them
+runTest() {
+  if [[ -f "${1}compiler.flags" ]]; then
+    while read -r -u 3 FLAGS; do
+      runTestWithFlags "${1}" "${FLAGS}"
+    done 3< "${1}compiler.flags"
+  else
+    runTestWithFlags "${1}" ""
+  fi
+}
+
 findCompiler
 findInterpreter
 findTests
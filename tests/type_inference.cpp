@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2019 Roman Ondráček <xondra58@stud.fit.vutbr.cz>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include "parse_tree_test.h"
+
+extern "C" {
+#include "type_inference.h"
+}
+
+namespace Tests {
+
+	class TypeInferenceTest : public ParseTreeTest {
+	protected:
+		int infer(const std::string &source) {
+			int errCode = parse(source);
+			if (errCode == ERROR_SUCCESS) {
+				typeInfer(&tree, &errCode);
+			}
+			return errCode;
+		}
+
+		// types of the assigned value or of the condition
+		static unsigned types(const treeElement_t *statement) {
+			return statement->data.elements[statement->type == E_ASSIGN ? 1 : 0].valueTypes;
+		}
+	};
+
+	TEST_F(TypeInferenceTest, Literals) {
+		ASSERT_EQ(infer("a = 1\nb = 1.5\nc = 'x'\nd = True\ne = None\n"), ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_EQ(list.size(), 5);
+		ASSERT_EQ(types(list[0]), VALUE_INT);
+		ASSERT_EQ(types(list[1]), VALUE_FLOAT);
+		ASSERT_EQ(types(list[2]), VALUE_STRING);
+		ASSERT_EQ(types(list[3]), VALUE_BOOL);
+		ASSERT_EQ(types(list[4]), VALUE_NONE);
+	}
+
+	TEST_F(TypeInferenceTest, Arithmetic) {
+		ASSERT_EQ(infer("a = inputi()\nb = a + 1\nc = a < b\nd = inputf() / 2.0\n"), ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_EQ(types(list[0]), VALUE_INT | VALUE_NONE);
+		ASSERT_EQ(types(list[1]), VALUE_INT);
+		ASSERT_EQ(types(list[2]), VALUE_BOOL);
+		ASSERT_EQ(types(list[3]), VALUE_FLOAT);
+	}
+
+	TEST_F(TypeInferenceTest, Conversion) {
+		ASSERT_TRUE(typeIsConverted(E_ADD, VALUE_INT, VALUE_FLOAT));
+		ASSERT_FALSE(typeIsConverted(E_ADD, VALUE_FLOAT, VALUE_INT));
+		ASSERT_FALSE(typeIsConverted(E_ADD, VALUE_INT, VALUE_INT));
+		ASSERT_FALSE(typeIsConverted(E_MUL, VALUE_INT, VALUE_FLOAT | VALUE_NONE));
+		ASSERT_TRUE(typeIsConverted(E_DIV, VALUE_INT, VALUE_INT));
+		ASSERT_FALSE(typeIsConverted(E_DIV_INT, VALUE_INT, VALUE_FLOAT));
+		ASSERT_TRUE(typeIsConverted(E_LTE, VALUE_INT, VALUE_FLOAT));
+		ASSERT_EQ(infer("a = inputi()\nb = a + 0\nc = b * 2.5\nd = b / 2\ne = a * 2.5\n"), ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_EQ(types(list[2]), VALUE_FLOAT);
+		ASSERT_EQ(types(list[3]), VALUE_FLOAT);
+		// conversion of the operand with unknown type is not generated, so the operation fails
+		ASSERT_EQ(types(list[4]), VALUE_UNKNOWN);
+	}
+
+	TEST_F(TypeInferenceTest, ShortCircuit) {
+		ASSERT_EQ(infer("a = inputi()\nb = a > 0 and a\nc = a == None or True\n"), ERROR_SUCCESS);
+		auto list = statements();
+		// result is the deciding left operand or the right operand
+		ASSERT_EQ(types(list[1]), VALUE_BOOL | VALUE_INT | VALUE_NONE);
+		ASSERT_EQ(types(list[2]), VALUE_BOOL);
+	}
+
+	TEST_F(TypeInferenceTest, UnknownCall) {
+		ASSERT_EQ(infer("def f(x):\n    return x\na = f(1)\nif a:\n    pass\n"), ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_EQ(list.size(), 2);
+		ASSERT_EQ(types(list[0]), VALUE_UNKNOWN);
+		ASSERT_EQ(types(list[1]), VALUE_UNKNOWN);
+	}
+
+	TEST_F(TypeInferenceTest, EmbeddedCall) {
+		ASSERT_EQ(infer("a = ord('abc', 1)\nb = chr(65)\nc = len(b)\n"), ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_EQ(list.size(), 3);
+		// index out of the string gives None
+		ASSERT_EQ(types(list[0]), VALUE_INT | VALUE_NONE);
+		ASSERT_EQ(types(list[1]), VALUE_STRING);
+		ASSERT_EQ(types(list[2]), VALUE_INT);
+	}
+
+	TEST_F(TypeInferenceTest, MergeBranches) {
+		ASSERT_EQ(infer("a = inputi()\nif a:\n    b = 1\n    c = 1\nelse:\n    b = 'x'\n    c = 2\nd = b\ne = c\n"),
+		          ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_EQ(list.size(), 4);
+		ASSERT_EQ(types(list[1]), VALUE_INT | VALUE_NONE);
+		ASSERT_EQ(types(list[2]), VALUE_INT | VALUE_STRING);
+		ASSERT_EQ(types(list[3]), VALUE_INT);
+	}
+
+	TEST_F(TypeInferenceTest, LoopFixedPoint) {
+		ASSERT_EQ(infer("a = 1\nb = 0\nwhile b:\n    a = b\n    b = 'x'\nc = a\n"), ERROR_SUCCESS);
+		auto list = statements();
+		ASSERT_EQ(list.size(), 4);
+		// second iteration sees the string assigned at the end of the first one
+		ASSERT_EQ(types(list[2]), VALUE_INT | VALUE_STRING);
+		ASSERT_EQ(types(list[3]), VALUE_INT | VALUE_STRING);
+		treeElement_t &body = list[2]->data.elements[1];
+		ASSERT_EQ(types(&body.data.elements[0]), VALUE_INT | VALUE_STRING);
+	}
+
+	TEST_F(TypeInferenceTest, FunctionParameters) {
+		ASSERT_EQ(infer("a = 1\ndef f(x):\n    y = x\n    z = a\n    return y\n"), ERROR_SUCCESS);
+		treeElement_t *body = nullptr;
+		for (unsigned i = 0; i < tree.nodeSize; ++i) {
+			treeElement_t &definition = tree.data.elements[i];
+			for (unsigned j = 0; definition.type == E_S_FUNCTION_DEF && j < definition.nodeSize; ++j) {
+				if (definition.data.elements[j].type == E_CODE_BLOCK) {
+					body = &definition.data.elements[j];
+				}
+			}
+		}
+		ASSERT_NE(body, nullptr);
+		ASSERT_EQ(types(&body->data.elements[0]), VALUE_UNKNOWN);
+		ASSERT_EQ(types(&body->data.elements[1]), VALUE_UNKNOWN);
+	}
+
+}